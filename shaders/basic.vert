@@ -6,10 +6,16 @@ layout (location = 1) in vec3 aColor;
 out vec3 vertexColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Per-frame camera, shared by all world shaders (see UniformBuffer.hpp)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 position;
+} camera;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = camera.viewProjection * model * vec4(aPos, 1.0);
     vertexColor = aColor;
 } 
\ No newline at end of file
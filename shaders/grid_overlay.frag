@@ -0,0 +1,19 @@
+#version 400 core
+
+in vec2 cellCoord;
+out vec4 FragColor;
+
+uniform sampler2D overlayValues; // One R32F value per cell
+uniform sampler1D palette;       // Baked gradient, alpha is opacity
+uniform float valueMin;
+uniform float valueScale;        // 1 / (max - min)
+
+void main() {
+    ivec2 cell = min(ivec2(cellCoord), textureSize(overlayValues, 0) - 1);
+    float t = clamp((texelFetch(overlayValues, cell, 0).r - valueMin) * valueScale, 0.0, 1.0);
+    // Address texel centres so 0 and 1 hit the first and last entries exactly
+    float size = float(textureSize(palette, 0));
+    vec4 color = texture(palette, (t * (size - 1.0) + 0.5) / size);
+    if (color.a <= 0.0) discard;
+    FragColor = color;
+}
@@ -0,0 +1,12 @@
+#version 400 core
+
+in vec2 cellCoord;
+out vec4 FragColor;
+
+uniform sampler2D cellColors; // One RGB8 texel per cell
+
+void main() {
+    // texelFetch: no filtering, so cell edges stay sharp at any zoom
+    ivec2 cell = min(ivec2(cellCoord), textureSize(cellColors, 0) - 1);
+    FragColor = vec4(texelFetch(cellColors, cell, 0).rgb, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 400 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aCell; // Grid-space corner: (0,0) .. (width,height)
+
+out vec2 cellCoord;
+
+uniform mat4 model;
+
+// Per-frame camera, shared by all world shaders (see UniformBuffer.hpp)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 position;
+} camera;
+
+void main() {
+    gl_Position = camera.viewProjection * model * vec4(aPos, 1.0);
+    cellCoord = aCell;
+}
@@ -3,13 +3,48 @@ out vec4 FragColor;
 
 in vec3 FragPos;
 in vec3 Normal;
-in vec4 FragPosLightSpace;
 
-uniform vec3 viewPos;
 uniform vec4 color;
-uniform sampler2D shadowMap;
+uniform sampler2D shadowAtlas; // Every light's shadow map, one tile each
 
-float ShadowCalculation(vec4 fragPosLightSpace) {
+// Clustered lights (see LightClusters.hpp): two texels per light (positionRadius,
+// colorIntensity), an (offset, count) range per froxel, and the index list the
+// ranges point into
+uniform samplerBuffer clusterLights;
+uniform usamplerBuffer clusterRanges;
+uniform usamplerBuffer clusterIndices;
+
+// Per-frame camera and lights, shared by all world shaders (see UniformBuffer.hpp)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 position;
+} camera;
+
+struct LightData {
+    vec4 positionRadius;
+    vec4 colorIntensity;
+    mat4 lightSpaceMatrix;
+    vec4 shadowRect;
+};
+// Light i < lightCount also has shadow data here
+layout(std140) uniform Lights {
+    LightData lights[8];
+    int lightCount;
+    ivec4 clusterGrid;  // Froxels in x, y, z; w = clustered lights
+    vec4 clusterDepth;  // near, far, slice scale, slice bias
+};
+
+float ShadowCalculation(int light, vec3 fragPos) {
+    if (light >= lightCount) {
+        return 0.0; // No shadow data
+    }
+    vec4 rect = lights[light].shadowRect;
+    if (rect.z <= 0.0) {
+        return 0.0; // No atlas tile
+    }
+    vec4 fragPosLightSpace = lights[light].lightSpaceMatrix * vec4(fragPos, 1.0);
     // Perform perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     // Transform to [0,1] range
@@ -24,12 +59,16 @@ float ShadowCalculation(vec4 fragPosLightSpace) {
     // Get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
     
-    // PCF (Percentage Closer Filtering)
+    // PCF (Percentage Closer Filtering), clamped to the light's tile so that
+    // neighbouring tiles never bleed in
     float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+    vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0);
+    vec2 tileMin = rect.xy + 0.5 * texelSize;
+    vec2 tileMax = rect.xy + rect.zw - 0.5 * texelSize;
+    vec2 uv = rect.xy + projCoords.xy * rect.zw;
     for(int x = -1; x <= 1; ++x) {
         for(int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+            float pcfDepth = texture(shadowAtlas, clamp(uv + vec2(x, y) * texelSize, tileMin, tileMax)).r;
             shadow += currentDepth - 0.005 > pcfDepth ? 1.0 : 0.0;
         }
     }
@@ -40,25 +79,45 @@ float ShadowCalculation(vec4 fragPosLightSpace) {
 
 void main() {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(camera.position.xyz - FragPos);
     
     // Ambient
     vec3 ambient = 0.3 * color.rgb;
     
-    // Diffuse
-    vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0)); // Directional light
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * color.rgb;
-    
-    // Specular
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float spec = pow(max(dot(norm, halfwayDir), 0.0), 32.0);
-    vec3 specular = 0.3 * spec * color.rgb;
-    
-    // Shadow
-    float shadow = ShadowCalculation(FragPosLightSpace);
+    // Diffuse and specular from the lights binned into this fragment's froxel,
+    // fading out at their radius and shadowed by their atlas tile. With no lights
+    // set, fall back to a fixed directional light.
+    vec3 lit = vec3(0.0);
+    if (clusterGrid.w == 0) {
+        vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
+        float diff = max(dot(norm, lightDir), 0.0);
+        float spec = pow(max(dot(norm, normalize(lightDir + viewDir)), 0.0), 32.0);
+        lit = diff * color.rgb + 0.3 * spec * color.rgb;
+    } else {
+        vec4 clip = camera.viewProjection * vec4(FragPos, 1.0);
+        vec2 tile = (clip.xy / clip.w) * 0.5 + 0.5;
+        float depth = -(camera.view * vec4(FragPos, 1.0)).z;
+        ivec3 cell = ivec3(clamp(ivec2(tile * vec2(clusterGrid.xy)), ivec2(0), clusterGrid.xy - 1),
+                           clamp(int(floor(log(max(depth, 1e-4)) * clusterDepth.z + clusterDepth.w)), 0, clusterGrid.z - 1));
+        uvec2 range = texelFetch(clusterRanges, (cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x).xy;
+        for (uint n = 0u; n < range.y; ++n) {
+            int i = int(texelFetch(clusterIndices, int(range.x + n)).r);
+            vec4 positionRadius = texelFetch(clusterLights, 2 * i);
+            vec4 colorIntensity = texelFetch(clusterLights, 2 * i + 1);
+            vec3 toLight = positionRadius.xyz - FragPos;
+            float distance = length(toLight);
+            vec3 lightDir = toLight / max(distance, 0.0001);
+            float falloff = clamp(1.0 - distance / positionRadius.w, 0.0, 1.0);
+            vec3 radiance = colorIntensity.rgb * colorIntensity.a * falloff * falloff;
+            float diff = max(dot(norm, lightDir), 0.0);
+            vec3 halfwayDir = normalize(lightDir + viewDir);
+            float spec = pow(max(dot(norm, halfwayDir), 0.0), 32.0);
+            float shadow = ShadowCalculation(i, FragPos);
+            lit += (1.0 - shadow) * radiance * (diff * color.rgb + 0.3 * spec * color.rgb);
+        }
+    }
     
-    vec3 result = ambient + (1.0 - shadow) * (diffuse + specular);
+    vec3 result = ambient + lit;
     
     FragColor = vec4(result, color.a);
-} 
\ No newline at end of file
+}
@@ -3,18 +3,21 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+
+// Per-frame camera, shared by all world shaders (see UniformBuffer.hpp)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 position;
+} camera;
 
 out vec3 FragPos;
 out vec3 Normal;
-out vec4 FragPosLightSpace;
 
 void main() {
     vec4 worldPos = model * vec4(aPos, 1.0);
     FragPos = vec3(worldPos);
     Normal = mat3(transpose(inverse(model))) * aNormal;
-    FragPosLightSpace = lightSpaceMatrix * worldPos;
-    gl_Position = projection * view * worldPos;
-} 
\ No newline at end of file
+    gl_Position = camera.viewProjection * worldPos;
+}
@@ -6,9 +6,15 @@ layout (location = 1) in vec4 aColor;
 layout (location = 2) in float aLifeRatio; // NEW: Normalized life (0-1)
 
 // Uniforms
-uniform mat4 view;
-uniform mat4 projection;
+// Per-frame camera, shared by all world shaders (see UniformBuffer.hpp)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 position;
+} camera;
 uniform float time; // Time uniform for pulsing effect
+uniform float pointScale; // Budget manager compensation for throttled spawns
 // Model matrix is likely identity for world-space particles, pass if needed
 // uniform mat4 model;
 
@@ -23,11 +29,11 @@ void main()
     vec3 worldPos = aPos;
     
     // Calculate final screen position
-    gl_Position = projection * view * vec4(worldPos, 1.0);
+    gl_Position = camera.viewProjection * vec4(worldPos, 1.0);
 
     // Enable setting particle size in vertex shader if needed
     // gl_PointSize = particleSize; 
-    gl_PointSize = 10.0; // Example fixed size
+    gl_PointSize = 10.0 * pointScale; // Base size, grown when spawns are throttled
 
     // Pass attributes to fragment shader
     particleColor = aColor;
@@ -0,0 +1,33 @@
+#version 330 core
+
+// Render pass for the GPU particle backend. Reads the transform feedback
+// buffer directly and produces the same outputs as particle.vert.
+layout (location = 0) in vec4 aPosLife;
+layout (location = 1) in vec4 aVelInitLife;
+layout (location = 2) in vec4 aColorStart;
+layout (location = 3) in vec4 aColorEnd;
+
+// Per-frame camera, shared by all world shaders (see UniformBuffer.hpp)
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 position;
+} camera;
+uniform float time;
+uniform float pointScale; // Budget manager compensation for throttled spawns
+
+out vec4 particleColor;
+out float lifeRatio;
+out float pulseFactor;
+
+void main()
+{
+    vec3 worldPos = aPosLife.xyz;
+    gl_Position = camera.viewProjection * vec4(worldPos, 1.0);
+    gl_PointSize = 10.0 * pointScale;
+
+    lifeRatio = aVelInitLife.w > 0.0 ? clamp(aPosLife.w / aVelInitLife.w, 0.0, 1.0) : 0.0;
+    particleColor = mix(aColorEnd, aColorStart, lifeRatio);
+    pulseFactor = sin(time * 3.0 + worldPos.x + worldPos.y);
+}
@@ -0,0 +1,37 @@
+#version 330 core
+
+// GPU particle state, 4 x vec4 per particle (see GpuParticle)
+layout (location = 0) in vec4 aPosLife;       // xyz = position, w = remaining life
+layout (location = 1) in vec4 aVelInitLife;   // xyz = velocity, w = initial life
+layout (location = 2) in vec4 aColorStart;
+layout (location = 3) in vec4 aColorEnd;
+
+uniform float deltaTime;
+uniform vec3 cameraPosition;
+uniform float cullDistanceSq; // 0 disables distance culling
+
+out vec4 vPosLife;
+out vec4 vVelInitLife;
+out vec4 vColorStart;
+out vec4 vColorEnd;
+
+void main()
+{
+    // Same integration as the CPU path: age first, then move if still alive
+    float life = aPosLife.w - deltaTime;
+    vec3 position = aPosLife.xyz;
+    if (life > 0.0) {
+        position += aVelInitLife.xyz * deltaTime;
+    }
+
+    // Distance culling: killed here, dropped by the geometry shader
+    vec3 toCamera = position - cameraPosition;
+    if (cullDistanceSq > 0.0 && dot(toCamera, toCamera) > cullDistanceSq) {
+        life = 0.0;
+    }
+
+    vPosLife = vec4(position, life);
+    vVelInitLife = aVelInitLife;
+    vColorStart = aColorStart;
+    vColorEnd = aColorEnd;
+}
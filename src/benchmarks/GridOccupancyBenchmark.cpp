@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "GridOccupancy.hpp"
+
+using namespace TurtleEngine;
+
+// GridOccupancy under load: every entity moves each frame, then every entity runs a
+// perception query around itself. One frame is repeated as an all-pairs scan to show
+// what the index saves and to check both find the same neighbours.
+// Usage: GridOccupancyBenchmark [entities] [frames] [queryRadius] [gridSize]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    constexpr float CELL_SIZE = 1.0f;
+    constexpr float MAX_SPEED = 6.0f;
+    constexpr float FRAME_TIME = 1.0f / 60.0f;
+
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t entityCount = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 10000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 60;
+    float radius = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 4.0f;
+    int gridSize = argc > 4 ? std::atoi(argv[4]) : 256;
+    if (entityCount == 0 || frames <= 0 || radius <= 0.0f || gridSize <= 0) {
+        std::cerr << "ERROR::GridOccupancyBenchmark: all arguments must be positive" << std::endl;
+        return 1;
+    }
+
+    GridOccupancy occupancy(gridSize, gridSize, CELL_SIZE);
+    const float half = gridSize * CELL_SIZE * 0.5f;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coordinate(-half, half);
+    std::uniform_real_distribution<float> speed(-MAX_SPEED, MAX_SPEED);
+    std::uniform_real_distribution<float> extent(0.25f, 0.75f);
+
+    std::vector<glm::vec3> positions(entityCount);
+    std::vector<glm::vec3> velocities(entityCount);
+    std::vector<glm::vec2> halfExtents(entityCount);
+    std::vector<OccupantId> ids(entityCount);
+    occupancy.reserve(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        positions[i] = glm::vec3(coordinate(rng), 0.0f, coordinate(rng));
+        velocities[i] = glm::vec3(speed(rng), 0.0f, speed(rng));
+        halfExtents[i] = glm::vec2(extent(rng));
+        ids[i] = occupancy.insert(positions[i], halfExtents[i]);
+    }
+
+    std::vector<OccupantId> neighbours;
+    neighbours.reserve(1024);
+    double moveMs = 0.0;
+    double queryMs = 0.0;
+    size_t found = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < entityCount; ++i) {
+            glm::vec3& p = positions[i];
+            p += velocities[i] * FRAME_TIME;
+            // Bounce off the arena walls
+            if (p.x < -half || p.x > half) velocities[i].x = -velocities[i].x;
+            if (p.z < -half || p.z > half) velocities[i].z = -velocities[i].z;
+            occupancy.move(ids[i], p);
+        }
+        moveMs += msSince(start);
+
+        start = Clock::now();
+        for (size_t i = 0; i < entityCount; ++i) {
+            neighbours.clear();
+            found += occupancy.queryRadius(positions[i], radius, neighbours);
+        }
+        queryMs += msSince(start);
+    }
+
+    // The same perception pass as an all-pairs scan over the final positions
+    size_t lastFrameFound = 0;
+    for (size_t i = 0; i < entityCount; ++i) {
+        neighbours.clear();
+        lastFrameFound += occupancy.queryRadius(positions[i], radius, neighbours);
+    }
+    auto start = Clock::now();
+    size_t bruteFound = 0;
+    for (size_t i = 0; i < entityCount; ++i) {
+        const glm::vec2 c(positions[i].x, positions[i].z);
+        for (size_t j = 0; j < entityCount; ++j) {
+            glm::vec2 p(positions[j].x, positions[j].z);
+            glm::vec2 d = c - glm::clamp(c, p - halfExtents[j], p + halfExtents[j]);
+            bruteFound += glm::dot(d, d) <= radius * radius;
+        }
+    }
+    double bruteMs = msSince(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Grid occupancy benchmark: " << entityCount << " entities, " << frames << " frames, "
+              << gridSize << "x" << gridSize << " cells, query radius " << radius << std::endl;
+    std::cout << "  move all:           " << moveMs / frames << " ms/frame" << std::endl;
+    std::cout << "  query all:          " << queryMs / frames << " ms/frame ("
+              << static_cast<double>(found) / (static_cast<double>(entityCount) * frames) << " neighbours each)" << std::endl;
+    std::cout << "  all-pairs query:    " << bruteMs << " ms/frame" << std::endl;
+
+    if (bruteFound != lastFrameFound) {
+        std::cerr << "ERROR::GridOccupancyBenchmark: index found " << lastFrameFound
+                  << " neighbours, all-pairs scan found " << bruteFound << std::endl;
+        return 1;
+    }
+    return 0;
+}
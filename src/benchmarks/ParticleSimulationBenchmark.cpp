@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include "ParticleSimulation.hpp"
+#include "JobSystem.hpp"
+
+using namespace TurtleEngine;
+
+// Headless ParticleSimulation throughput: a full pool kept alive by emitters, stepped
+// at a fixed 60 Hz with depth sorting and render view output enabled.
+// Needs no GL context, so CI runs it. Usage: ParticleSimulationBenchmark [particles] [frames]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    constexpr float FRAME_TIME = 1.0f / 60.0f;
+    constexpr int EMITTER_COUNT = 8;
+    constexpr float LIFETIME = 2.0f;
+}
+
+int main(int argc, char** argv)
+{
+    size_t particles = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 120;
+    if (particles == 0 || frames <= 0) {
+        std::cerr << "ERROR::ParticleSimulationBenchmark: particles and frames must be positive" << std::endl;
+        return 1;
+    }
+
+    ParticleSimulation simulation(particles);
+    simulation.setSeed(42);
+    simulation.setFixedTimestep(FRAME_TIME);
+    simulation.setDepthSorting(true);
+    // Measure the simulation itself, not the throttle reacting to it
+    ParticleBudgetSettings budget = simulation.getBudgetManager().getSettings();
+    budget.enabled = false;
+    simulation.getBudgetManager().setSettings(budget);
+
+    // Rates that refill the pool once per lifetime
+    const size_t perEmitter = particles / EMITTER_COUNT;
+    for (int e = 0; e < EMITTER_COUNT; ++e) {
+        ParticleEmitterDesc desc;
+        desc.shape = EmitterShape::SPHERE;
+        desc.position = glm::vec3(static_cast<float>(e) * 4.0f - 14.0f, 2.0f, 0.0f);
+        desc.radius = 1.0f;
+        desc.rate = static_cast<float>(perEmitter) / LIFETIME;
+        desc.lifetimeMin = LIFETIME * 0.9f;
+        desc.lifetimeMax = LIFETIME;
+        desc.maxParticles = perEmitter;
+        simulation.addEmitter(desc);
+    }
+
+    glm::vec3 cameraPosition(0.0f, 5.0f, 30.0f);
+    glm::mat4 view = glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    simulation.setCamera(view, projection, cameraPosition);
+
+    // Warm up until the pool is full so every timed frame runs at capacity
+    int warmupFrames = static_cast<int>(LIFETIME / FRAME_TIME) + 1;
+    for (int i = 0; i < warmupFrames; ++i) simulation.update(FRAME_TIME);
+
+    size_t updates = 0;
+    size_t drawn = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        simulation.update(FRAME_TIME);
+        updates += simulation.getActiveParticleCount();
+        drawn += simulation.getRenderView().count;
+    }
+    double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Particle simulation benchmark: " << particles << " particles, " << frames << " frames, "
+              << JobSystem::shared().getConcurrency() << " threads" << std::endl;
+    std::cout << "  particle updates:   " << updates << " (" << drawn << " drawn)" << std::endl;
+    std::cout << "  frame time:         " << totalMs / frames << " ms" << std::endl;
+    std::cout << "  throughput:         " << (totalMs > 0.0 ? updates / (totalMs * 1000.0) : 0.0) << " M updates/s" << std::endl;
+
+    // A pool that never fills means emitters or recycling broke; fail the CI run
+    if (updates < particles / 2 * static_cast<size_t>(frames)) {
+        std::cerr << "ERROR::ParticleSimulationBenchmark: pool ran below half capacity" << std::endl;
+        return 1;
+    }
+    return 0;
+}
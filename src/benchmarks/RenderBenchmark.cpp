@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "FrameProfiler.hpp"
+#include "Grid.hpp"
+#include "HeadlessContext.hpp"
+#include "ParticleSystem.hpp"
+#include "RenderTarget.hpp"
+#include "Renderer.hpp"
+#include "ShaderManager.hpp"
+#include "UniformBuffer.hpp"
+
+using namespace TurtleEngine;
+
+// Scripted scene rendered offscreen on a headless context: N lights (the first
+// eight shadowed) over lit boxes drawn with lighting.frag, which are also the
+// shadow casters (a plinth and a ring of pillars, cached as static, and one block
+// circling between them, redrawn every frame), a particle system holding M
+// particles and a KxK colour grid, drawn for a fixed number of frames at a fixed
+// 60 Hz step. Reports CPU+GPU frame times (each frame waits for the GPU) and the
+// GPU time of each pass from the FrameProfiler.
+//
+// The scene is deterministic, so --hash prints an FNV-1a hash of the last frame and
+// --expect fails the run when it differs: a regression check for one driver, not
+// across drivers. Needs EGL but no display server.
+//
+// Usage: RenderBenchmark [lights] [particles] [gridSize] [frames]
+//                        [--size WxH] [--hash] [--expect HEX] [--ppm path]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    constexpr float FRAME_TIME = 1.0f / 60.0f;
+    constexpr int EMITTER_COUNT = 4;
+    constexpr float LIFETIME = 2.0f;
+    constexpr int WARMUP_FRAMES = 10;
+    constexpr int PILLAR_COUNT = 12;
+    constexpr float ORBIT_SPEED = 0.5f; // Radians per second for the moving block
+
+    struct Options {
+        int lights = 8;
+        size_t particles = 20000;
+        int gridSize = 128;
+        int frames = 120;
+        int width = 1280;
+        int height = 720;
+        bool hash = false;
+        bool expect = false;
+        uint64_t expected = 0;
+        std::string ppmPath;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        int positional = 0;
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strcmp(arg, "--hash") == 0) {
+                options.hash = true;
+            } else if (std::strcmp(arg, "--expect") == 0 && i + 1 < argc) {
+                options.hash = options.expect = true;
+                options.expected = std::strtoull(argv[++i], nullptr, 16);
+            } else if (std::strcmp(arg, "--ppm") == 0 && i + 1 < argc) {
+                options.ppmPath = argv[++i];
+            } else if (std::strcmp(arg, "--size") == 0 && i + 1 < argc) {
+                if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) return false;
+            } else if (arg[0] == '-') {
+                return false;
+            } else {
+                switch (positional++) {
+                    case 0: options.lights = std::atoi(arg); break;
+                    case 1: options.particles = static_cast<size_t>(std::strtoul(arg, nullptr, 10)); break;
+                    case 2: options.gridSize = std::atoi(arg); break;
+                    case 3: options.frames = std::atoi(arg); break;
+                    default: return false;
+                }
+            }
+        }
+        return options.lights >= 0 && options.lights <= Renderer::MAX_LIGHTS && options.gridSize > 0 &&
+               options.frames > 0 && options.width > 0 && options.height > 0;
+    }
+
+    // Unit cube centred on the origin, position and normal per vertex
+    struct Box {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+
+        Box() {
+            std::vector<float> vertices;
+            const glm::vec3 normals[] = {
+                {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+                {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f},
+            };
+            for (const glm::vec3& n : normals) {
+                // u x v == n, so the corners run counter-clockwise seen from outside
+                const glm::vec3 u(n.y, n.z, n.x);
+                const glm::vec3 v = glm::cross(n, u);
+                const glm::vec3 corners[] = { n - u - v, n + u - v, n + u + v, n - u + v };
+                for (int index : {0, 1, 2, 0, 2, 3}) {
+                    const glm::vec3 position = corners[index] * 0.5f;
+                    vertices.insert(vertices.end(), {position.x, position.y, position.z, n.x, n.y, n.z});
+                }
+            }
+            glGenVertexArrays(1, &vao);
+            glGenBuffers(1, &vbo);
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        ~Box() {
+            glDeleteVertexArrays(1, &vao);
+            glDeleteBuffers(1, &vbo);
+        }
+
+        static constexpr GLsizei VERTEX_COUNT = 36;
+    };
+
+    // One lit box in the scene and its shadow caster
+    struct SceneBox {
+        glm::mat4 model;
+        glm::vec4 color;
+        ShadowCasterId caster = INVALID_SHADOW_CASTER;
+    };
+
+    glm::mat4 boxTransform(const glm::vec3& centre, const glm::vec3& size) {
+        return glm::scale(glm::translate(glm::mat4(1.0f), centre), size);
+    }
+
+    glm::mat4 orbitTransform(float extent, float time) {
+        const float angle = time * ORBIT_SPEED;
+        const float radius = extent * 0.12f;
+        return boxTransform(glm::vec3(std::cos(angle) * radius, 2.5f, std::sin(angle) * radius),
+                            glm::vec3(1.5f, 0.5f, 1.5f));
+    }
+
+    // Mean GPU time of the named pass over the profiled frames; -1 if it never resolved
+    double averageGpuMs(const char* name) {
+        double total = 0.0;
+        size_t count = 0;
+        for (const ProfileFrame& frame : FrameProfiler::shared().getHistory()) {
+            for (const ProfileZone& zone : frame.zones) {
+                if (zone.track == ProfileTrack::GPU && std::strcmp(zone.name, name) == 0) {
+                    total += zone.durationMs;
+                    ++count;
+                }
+            }
+        }
+        return count > 0 ? total / count : -1.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: RenderBenchmark [lights <= " << Renderer::MAX_LIGHTS << "] [particles] [gridSize] [frames]"
+                  << " [--size WxH] [--hash] [--expect HEX] [--ppm path]" << std::endl;
+        return 1;
+    }
+
+    HeadlessContext context;
+    if (!context.initialize()) {
+        std::cerr << "ERROR::RenderBenchmark: No headless GL context" << std::endl;
+        return 1;
+    }
+    int result = 0;
+    {
+        RenderTarget target;
+        if (!target.initialize(options.width, options.height)) return 1;
+        Renderer renderer;
+        renderer.init();
+        renderer.setRenderTarget(&target);
+        renderer.setClearColor(glm::vec4(0.05f, 0.05f, 0.08f, 1.0f));
+        FrameProfiler::shared().initialize();
+
+        const float extent = static_cast<float>(options.gridSize);
+        const glm::vec3 cameraPosition(0.0f, extent * 0.5f, extent * 0.8f);
+        const glm::mat4 view = glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+            static_cast<float>(options.width) / options.height, 0.1f, extent * 4.0f);
+        renderer.setViewMatrix(view);
+        renderer.setProjectionMatrix(projection);
+
+        // Lights on a ring above the grid
+        for (int i = 0; i < options.lights; ++i) {
+            const float angle = 6.2831853f * i / std::max(options.lights, 1);
+            const glm::vec3 position(std::cos(angle) * extent * 0.3f, 6.0f, std::sin(angle) * extent * 0.3f);
+            const glm::vec3 color(0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle), 0.8f);
+            renderer.addLight(Light(position, color, 1.0f, extent * 0.4f));
+        }
+
+        // A checkerboard, so a grid that stops drawing changes the hash
+        Grid grid(options.gridSize, options.gridSize, 1.0f);
+        std::vector<GridCellColor> cells;
+        cells.reserve(static_cast<size_t>(options.gridSize) * options.gridSize);
+        for (int y = 0; y < options.gridSize; ++y) {
+            for (int x = 0; x < options.gridSize; ++x) {
+                const float shade = ((x / 8 + y / 8) & 1) ? 0.6f : 0.3f;
+                cells.push_back({x, y, glm::vec3(shade, shade * 0.9f, shade * 0.8f)});
+            }
+        }
+        grid.setCellColors(cells);
+
+        // Lit boxes: a plinth, a ring of pillars standing on it and one block
+        // circling between them; every box casts and receives shadows
+        const ShaderId litShader = ShaderManager::shared().load("shaders/lighting.vert", "shaders/lighting.frag");
+        if (litShader == INVALID_SHADER) {
+            std::cerr << "ERROR::RenderBenchmark: Lighting shader failed to load" << std::endl;
+            return 1;
+        }
+        Box box;
+        std::vector<SceneBox> boxes;
+        boxes.push_back({boxTransform(glm::vec3(0.0f, 0.25f, 0.0f), glm::vec3(extent * 0.5f, 0.5f, extent * 0.5f)),
+                         glm::vec4(0.7f, 0.7f, 0.7f, 1.0f)});
+        for (int i = 0; i < PILLAR_COUNT; ++i) {
+            const float angle = 6.2831853f * (i + 0.5f) / PILLAR_COUNT;
+            const glm::vec3 centre(std::cos(angle) * extent * 0.2f, 2.0f, std::sin(angle) * extent * 0.2f);
+            boxes.push_back({boxTransform(centre, glm::vec3(1.0f, 3.0f, 1.0f)), glm::vec4(0.9f, 0.85f, 0.75f, 1.0f)});
+        }
+        boxes.push_back({orbitTransform(extent, 0.0f), glm::vec4(0.8f, 0.3f, 0.2f, 1.0f)});
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            ShadowCaster caster;
+            caster.vao = box.vao;
+            caster.count = Box::VERTEX_COUNT;
+            caster.model = boxes[i].model;
+            caster.boundsMin = glm::vec3(-0.5f);
+            caster.boundsMax = glm::vec3(0.5f);
+            caster.isStatic = i + 1 < boxes.size();
+            boxes[i].caster = renderer.addShadowCaster(caster);
+        }
+
+        std::unique_ptr<ParticleSystem> particles;
+        if (options.particles > 0) {
+            particles = std::make_unique<ParticleSystem>(options.particles);
+            if (!particles->initialize()) {
+                std::cerr << "ERROR::RenderBenchmark: Particle system failed to initialize" << std::endl;
+                return 1;
+            }
+            particles->setSeed(42);
+            particles->setFixedTimestep(FRAME_TIME);
+            particles->setDepthSorting(true);
+            // Hold the pool at its size; the budget would react to this machine's speed
+            ParticleBudgetSettings budget = particles->getBudgetManager().getSettings();
+            budget.enabled = false;
+            particles->getBudgetManager().setSettings(budget);
+            const size_t perEmitter = options.particles / EMITTER_COUNT;
+            for (int e = 0; e < EMITTER_COUNT; ++e) {
+                ParticleEmitterDesc desc;
+                desc.shape = EmitterShape::SPHERE;
+                desc.position = glm::vec3((e - (EMITTER_COUNT - 1) * 0.5f) * extent * 0.2f, 3.0f, 0.0f);
+                desc.radius = 1.0f;
+                desc.rate = static_cast<float>(perEmitter) / LIFETIME;
+                desc.lifetimeMin = LIFETIME * 0.9f;
+                desc.lifetimeMax = LIFETIME;
+                desc.maxParticles = perEmitter;
+                particles->addEmitter(desc);
+            }
+            particles->setCamera(view, projection, cameraPosition);
+        }
+
+        int frameIndex = 0;
+        auto renderFrame = [&]() {
+            FrameProfiler::shared().beginFrame();
+            if (particles) {
+                ProfileScope zone("Particle update");
+                particles->update(FRAME_TIME);
+            }
+            SceneBox& orbiter = boxes.back();
+            orbiter.model = orbitTransform(extent, ++frameIndex * FRAME_TIME);
+            renderer.setShadowCasterTransform(orbiter.caster, orbiter.model);
+            renderer.renderShadowMaps();
+            renderer.clear();
+            grid.render(projection, view); // Also sets the shared camera block
+            {
+                ProfileScope zone("Lit boxes", true);
+                // Looked up each frame: a reload replaces the program
+                renderer.useShader(ShaderManager::shared().get(litShader).getProgram());
+                glBindVertexArray(box.vao);
+                for (const SceneBox& sceneBox : boxes) {
+                    renderer.setUniform("model", sceneBox.model);
+                    renderer.setUniform("color", sceneBox.color);
+                    glDrawArrays(GL_TRIANGLES, 0, Box::VERTEX_COUNT);
+                }
+                glBindVertexArray(0);
+            }
+            if (particles) {
+                particles->render(projection, view);
+            }
+            // Light markers through the 2D batch, on the z = 0 plane
+            renderer.useShader(renderer.getDefaultShader());
+            renderer.setBatching(true);
+            for (const Light& light : renderer.getLights()) {
+                renderer.drawCircle(glm::vec2(light.position.x, light.position.y), 0.5f, glm::vec4(light.color, 1.0f));
+            }
+            renderer.setBatching(false);
+            FrameProfiler::shared().endFrame();
+            glFinish();
+        };
+
+        // Shader builds, chunk uploads and the first particles out of the way
+        for (int i = 0; i < WARMUP_FRAMES; ++i) renderFrame();
+
+        std::vector<double> frameMs;
+        frameMs.reserve(options.frames);
+        for (int i = 0; i < options.frames; ++i) {
+            const auto start = Clock::now();
+            renderFrame();
+            frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        // One more frame boundary collects the last frame's queries
+        FrameProfiler::shared().beginFrame();
+        FrameProfiler::shared().endFrame();
+
+        std::vector<double> sorted = frameMs;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double ms : frameMs) total += ms;
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "Render benchmark: " << options.lights << " lights, " << options.particles << " particles, "
+                  << options.gridSize << "x" << options.gridSize << " grid, " << options.frames << " frames at "
+                  << options.width << "x" << options.height << " (" << context.getBackend() << ", "
+                  << glGetString(GL_RENDERER) << ")" << std::endl;
+        std::cout << "  frame time:         " << total / options.frames << " ms avg, "
+                  << sorted.front() << " min, " << sorted[sorted.size() / 2] << " median, "
+                  << sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)] << " p95, "
+                  << sorted.back() << " max" << std::endl;
+        if (particles) {
+            std::cout << "  particles drawn:    " << particles->getRenderView().count << std::endl;
+        }
+        if (FrameProfiler::shared().hasGpuTimers()) {
+            for (const char* pass : {"Shadow maps", "Grid", "Lit boxes", "Particles", "2D batch"}) {
+                const double ms = averageGpuMs(pass);
+                if (ms >= 0.0) {
+                    std::cout << "  GPU " << std::left << std::setw(16) << (std::string(pass) + ":") << std::right
+                              << ms << " ms" << std::endl;
+                }
+            }
+        }
+
+        if (options.hash) {
+            const uint64_t hash = target.hashPixels();
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016" PRIx64, hash);
+            std::cout << "  image hash:         " << text << std::endl;
+            if (options.expect && hash != options.expected) {
+                std::cerr << "ERROR::RenderBenchmark: image hash " << text << " does not match the expected "
+                          << std::hex << std::setw(16) << std::setfill('0') << options.expected << std::endl;
+                result = 1;
+            }
+        }
+        if (!options.ppmPath.empty() && !target.writePPM(options.ppmPath)) {
+            result = 1;
+        }
+
+        for (const SceneBox& sceneBox : boxes) {
+            renderer.removeShadowCaster(sceneBox.caster);
+        }
+        FrameProfiler::shared().cleanup();
+        ShaderManager::shared().cleanup();
+        renderer.cleanup();
+    }
+    FrameUniforms::shared().cleanup();
+    context.cleanup();
+    return result;
+}
@@ -15,6 +15,7 @@ namespace TurtleEngine {
     class Grid;
     class Shader;
     class ParticleSystem;
+    class RenderQueue;
     namespace CSL { class CSLSystem; struct GestureResult; }
     namespace Combat { class ComboManager; struct ComboSequence; }
 }
@@ -111,6 +112,7 @@ private:
     std::vector<Combat::ComboSequence> m_definedCombos;
     std::unique_ptr<ParticleSystem> m_particleSystem;
     std::unique_ptr<Grid> m_grid;
+    std::unique_ptr<RenderQueue> m_renderQueue; // Per-frame draw packets, sorted by state
     
     struct Camera { // Simplified definition
         glm::vec3 position {0.0f, 5.0f, 15.0f};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace TurtleEngine {
+
+    // SplitMix64 step, used to expand a single 64-bit seed into generator state
+    inline uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Four independent xoshiro128+ generators stored lane-wise (SoA) so that
+    // next4() compiles to plain SIMD integer ops. Used for batched particle
+    // spawning where thousands of uniforms are needed per frame.
+    class Xoshiro128x4 {
+    public:
+        static constexpr size_t LANES = 4;
+
+        explicit Xoshiro128x4(uint64_t seed = 0x5EEDu) { reseed(seed); }
+
+        void reseed(uint64_t seed) {
+            uint64_t sm = seed;
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                uint64_t a = splitMix64(sm);
+                uint64_t b = splitMix64(sm);
+                m_s0[lane] = static_cast<uint32_t>(a);
+                m_s1[lane] = static_cast<uint32_t>(a >> 32);
+                m_s2[lane] = static_cast<uint32_t>(b);
+                m_s3[lane] = static_cast<uint32_t>(b >> 32);
+                // xoshiro must never be seeded with an all-zero state
+                if ((m_s0[lane] | m_s1[lane] | m_s2[lane] | m_s3[lane]) == 0) {
+                    m_s0[lane] = 1;
+                }
+            }
+        }
+
+        // Advance all lanes once and write one 32-bit output per lane
+        inline void next4(uint32_t out[LANES]) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                const uint32_t result = m_s0[lane] + m_s3[lane];
+                const uint32_t t = m_s1[lane] << 9;
+
+                m_s2[lane] ^= m_s0[lane];
+                m_s3[lane] ^= m_s1[lane];
+                m_s1[lane] ^= m_s2[lane];
+                m_s0[lane] ^= m_s3[lane];
+                m_s2[lane] ^= t;
+                m_s3[lane] = (m_s3[lane] << 11) | (m_s3[lane] >> 21);
+
+                out[lane] = result;
+            }
+        }
+
+        // Fill 'out' with 'count' uniform floats in [0, 1)
+        void fillUniform(float* out, size_t count) {
+            uint32_t bits[LANES];
+            size_t i = 0;
+            for (; i + LANES <= count; i += LANES) {
+                next4(bits);
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    // Top 24 bits give an exactly representable float in [0, 1)
+                    out[i + lane] = static_cast<float>(bits[lane] >> 8) * (1.0f / 16777216.0f);
+                }
+            }
+            if (i < count) {
+                next4(bits);
+                for (size_t lane = 0; i < count; ++i, ++lane) {
+                    out[i] = static_cast<float>(bits[lane] >> 8) * (1.0f / 16777216.0f);
+                }
+            }
+        }
+
+        // Convenience for the occasional scalar draw (wastes three lanes)
+        float nextFloat() {
+            float value;
+            fillUniform(&value, 1);
+            return value;
+        }
+
+    private:
+        alignas(16) uint32_t m_s0[LANES];
+        alignas(16) uint32_t m_s1[LANES];
+        alignas(16) uint32_t m_s2[LANES];
+        alignas(16) uint32_t m_s3[LANES];
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace TurtleEngine {
+
+    // Shared route to a set of goal cells over a Grid's cell layout (centred on the
+    // origin, cell x along world X, cell y along world Z). Any number of agents sample
+    // it for their steering direction instead of searching per agent.
+    //
+    // build() runs a multi-source Dijkstra from the goals over per-cell step costs
+    // (8-connected, no corner cutting), then stores each cell's step towards its cheapest
+    // neighbour as a 4-bit code, two cells per byte. Cost edits made afterwards are
+    // repaired by update(), which only re-integrates cells whose route went through a
+    // changed cell or can now improve.
+    class FlowField {
+    public:
+        static constexpr uint8_t IMPASSABLE = 255;
+        static constexpr uint8_t DEFAULT_COST = 1;
+
+        // Direction codes: 0..7 are steps (east, then counter-clockwise seen from above
+        // with +Z as south), GOAL marks a goal cell, NONE an unreachable or blocked one
+        enum Direction : uint8_t {
+            EAST = 0, NORTH_EAST, NORTH, NORTH_WEST, WEST, SOUTH_WEST, SOUTH, SOUTH_EAST,
+            GOAL = 8,
+            NONE = 15
+        };
+
+        FlowField(int width, int height, float cellSize);
+
+        // Cost of entering a cell: 1 (open ground) to 254, or IMPASSABLE
+        void setCost(int x, int y, uint8_t cost);
+        uint8_t getCost(int x, int y) const;
+
+        // Replaces the goal set; takes effect on the next build()
+        void setGoals(const std::vector<glm::ivec2>& cells);
+        void setGoal(const glm::vec3& position) { setGoals({ worldToCell(position) }); }
+
+        // Full integration from the goals
+        void build();
+        // Repairs the field after setCost() calls. Falls back to build() when the goals
+        // changed or nothing has been built yet.
+        void update();
+        bool isDirty() const { return m_needsBuild || !m_changedCells.empty(); }
+
+        Direction getDirection(int x, int y) const;
+        // Unit XZ step for an agent at 'position' (zero at a goal or with no route)
+        glm::vec2 sampleDirection(const glm::vec3& position) const;
+        // Path cost to the nearest goal, INFINITY when unreachable
+        float getIntegration(int x, int y) const;
+
+        glm::ivec2 worldToCell(const glm::vec3& position) const;
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+        float getCellSize() const { return m_cellSize; }
+
+        // Cells re-integrated by the last build() or update()
+        size_t getLastUpdatedCells() const { return m_lastUpdatedCells; }
+
+    private:
+        struct OpenEntry {
+            float cost;
+            int32_t cell;
+            bool operator>(const OpenEntry& other) const { return cost > other.cost; }
+        };
+
+        bool canStep(int x, int y, int direction) const;
+        float bestFromNeighbours(int32_t cell, int& direction) const;
+        void integrate(std::vector<OpenEntry>& open);
+        void setDirection(int32_t cell, uint8_t code);
+        void refreshDirections();
+
+        int m_width;
+        int m_height;
+        float m_cellSize;
+        float m_inverseCellSize;
+        glm::vec2 m_origin; // World XZ of cell (0, 0)'s corner
+
+        std::vector<uint8_t> m_costs;
+        std::vector<float> m_integration;
+        std::vector<uint8_t> m_directions; // Two 4-bit Direction codes per byte, low nibble first
+        std::vector<int32_t> m_goals;
+        bool m_needsBuild = true;
+
+        std::vector<int32_t> m_changedCells;
+        std::vector<int32_t> m_touched;    // Cells whose integration changed in this pass
+        std::vector<uint32_t> m_visitMark; // Per-cell pass stamp, avoids clearing between passes
+        uint32_t m_pass = 0;
+        size_t m_lastUpdatedCells = 0;
+    };
+
+} // namespace TurtleEngine
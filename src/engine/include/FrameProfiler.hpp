@@ -0,0 +1,118 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace TurtleEngine {
+
+enum class ProfileTrack : uint8_t {
+    CPU,
+    GPU
+};
+
+struct ProfileZone {
+    const char* name = nullptr; // String literal; zones keep the pointer
+    ProfileTrack track = ProfileTrack::CPU;
+    uint8_t depth = 0;          // Nesting level within its track
+    double startMs = 0.0;       // On the profiler's timeline (see FrameProfiler)
+    double durationMs = 0.0;
+};
+
+struct ProfileFrame {
+    uint64_t frame = 0;
+    double cpuMs = 0.0;          // beginFrame to endFrame
+    double gpuMs = 0.0;          // First GPU zone start to last end; 0 without GPU zones
+    std::vector<ProfileZone> zones;
+};
+
+// CPU and GPU zones for each frame on one timeline, so a spike can be attributed
+// to the side that caused it.
+//
+// CPU zones are steady_clock spans. GPU zones bracket their commands with
+// GL_TIMESTAMP queries (timestamps rather than GL_TIME_ELAPSED, which cannot nest)
+// from a pool of FRAME_SLOTS frames. A frame's queries are read only once the
+// driver reports them available, so the profiler never waits on the GPU; if they
+// are still pending when their slot comes round again, FRAME_SLOTS frames later,
+// the frame's GPU zones are dropped. GPU times are placed on the CPU timeline with
+// a glGetInteger64v(GL_TIMESTAMP) taken at each beginFrame().
+//
+// Zones opened outside beginFrame/endFrame are ignored, and GPU zones are skipped
+// until initialize() succeeds, so instrumented code costs almost nothing when the
+// profiler is idle. Main (GL) thread only.
+class FrameProfiler {
+public:
+    static constexpr size_t FRAME_SLOTS = 4;
+    static constexpr size_t MAX_GPU_ZONES = 64;      // Per frame
+    static constexpr size_t HISTORY_FRAMES = 240;
+
+    static FrameProfiler& shared();
+
+    FrameProfiler();
+    ~FrameProfiler();
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    // Creates the query pool; false if the driver has no timestamp queries (CPU
+    // zones still work)
+    bool initialize();
+    void cleanup();
+    bool hasGpuTimers() const { return m_queries[0][0] != 0; }
+
+    void beginFrame();
+    void endFrame();
+
+    void beginZone(const char* name, bool gpu);
+    void endZone(bool gpu);
+
+    // Completed frames, oldest first. GPU zones make a frame complete a few frames
+    // after endFrame().
+    const std::deque<ProfileFrame>& getHistory() const { return m_history; }
+    const ProfileFrame* getLatestFrame() const { return m_history.empty() ? nullptr : &m_history.back(); }
+    size_t getDroppedGpuFrames() const { return m_droppedGpuFrames; }
+
+    // Chrome trace event JSON (chrome://tracing, Perfetto): CPU and GPU as two threads
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    struct FrameSlot {
+        ProfileFrame frame;
+        std::vector<ProfileZone> gpuZones; // Zone i is timed by queries 2i and 2i + 1
+        int64_t gpuBaseNs = 0;  // GPU clock at beginFrame
+        double cpuBaseMs = 0.0; // Timeline time at the same moment
+        bool pending = false;   // Ended and not yet in the history
+    };
+
+    double now() const;
+    void collectPending();
+    bool collect(size_t slotIndex);
+    void complete(FrameSlot& slot);
+
+    std::chrono::steady_clock::time_point m_epoch;
+    GLuint m_queries[FRAME_SLOTS][2 * MAX_GPU_ZONES] = {};
+    FrameSlot m_slots[FRAME_SLOTS];
+    uint64_t m_frameNumber = 0;
+    FrameSlot* m_current = nullptr; // Between beginFrame and endFrame
+    std::vector<size_t> m_cpuStack; // Open zones, as indices into the current frame
+    std::vector<size_t> m_gpuStack; // Open GPU zones, as zone slots in the query pool
+    std::deque<ProfileFrame> m_history;
+    size_t m_droppedGpuFrames = 0;
+};
+
+// Times the enclosing scope; with 'gpu', also the GL commands it issues
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name, bool gpu = false) : m_gpu(gpu) { FrameProfiler::shared().beginZone(name, gpu); }
+    ~ProfileScope() { FrameProfiler::shared().endZone(m_gpu); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    bool m_gpu;
+};
+
+} // namespace TurtleEngine
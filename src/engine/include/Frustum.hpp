@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace TurtleEngine {
+
+    // View frustum as six inward-facing planes (ax + by + cz + d >= 0 is inside)
+    struct Frustum {
+        enum Plane { LEFT = 0, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+        glm::vec4 planes[PLANE_COUNT];
+
+        // Extract planes from a projection * view matrix (Gribb/Hartmann)
+        static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+        bool containsPoint(const glm::vec3& point) const;
+        bool intersectsSphere(const glm::vec3& center, float radius) const;
+        bool intersectsAABB(const glm::vec3& min, const glm::vec3& max) const;
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+
+namespace TurtleEngine {
+
+struct GLStateStats {
+    size_t changes = 0; // GL calls issued
+    size_t avoided = 0; // Requests that matched the tracked state and were skipped
+};
+
+// Shadow of the bind points the render backend touches. Each setter issues its GL
+// call only when the value differs from the tracked one. Code that changes GL state
+// behind the cache's back must be followed by invalidate(); after that every
+// setter issues its call once more.
+class GLStateCache {
+public:
+    static constexpr int MAX_TEXTURE_UNITS = 8;
+
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void bindTexture(int unit, GLenum target, GLuint texture);
+    void setBlend(bool enabled);
+    void setBlendFunc(GLenum source, GLenum destination);
+    void setDepthTest(bool enabled);
+    void setDepthWrite(bool enabled);
+
+    GLuint getProgram() const { return m_program; }
+    const GLStateStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = GLStateStats(); }
+
+private:
+    // UNKNOWN never matches a real value, so the first request after invalidate() binds
+    static constexpr GLuint UNKNOWN = ~0u;
+    enum class Toggle : unsigned char { OFF, ON, UNKNOWN };
+
+    bool setToggle(Toggle& tracked, bool enabled);
+
+    GLuint m_program = UNKNOWN;
+    GLuint m_vertexArray = UNKNOWN;
+    int m_activeUnit = -1;
+    GLuint m_textures[MAX_TEXTURE_UNITS] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+    GLenum m_textureTargets[MAX_TEXTURE_UNITS] = {};
+    Toggle m_blend = Toggle::UNKNOWN;
+    GLenum m_blendSource = UNKNOWN;
+    GLenum m_blendDestination = UNKNOWN;
+    Toggle m_depthTest = Toggle::UNKNOWN;
+    Toggle m_depthWrite = Toggle::UNKNOWN;
+    GLStateStats m_stats;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "ShaderManager.hpp"
+
+namespace TurtleEngine {
+
+    // Particle state as stored in GPU buffers (64 bytes, matches particle_update.vert)
+    struct GpuParticle {
+        glm::vec4 posLife;        // xyz = position, w = remaining life
+        glm::vec4 velInitLife;    // xyz = velocity, w = initial life
+        glm::vec4 colorStart;
+        glm::vec4 colorEnd;
+    };
+    static_assert(sizeof(GpuParticle) == 16 * sizeof(float), "GpuParticle must be tightly packed");
+
+    // Keeps particle state on the GPU and advances it with a transform feedback
+    // pass (vertex shader integrates, geometry shader drops dead particles).
+    // Two buffers ping-pong between frames; new particles are uploaded through a
+    // small spawn buffer and appended during the same feedback pass, so the CPU
+    // never uploads or reads back the live set.
+    // Requires GL 4.0 or ARB_transform_feedback2 for glDrawTransformFeedback.
+    class GpuParticleSimulator {
+    public:
+        explicit GpuParticleSimulator(size_t maxParticles, size_t spawnCapacity = 4096);
+        ~GpuParticleSimulator();
+
+        bool initialize(const std::string& updateVertexPath = "shaders/particle_update.vert",
+                        const std::string& updateGeometryPath = "shaders/particle_update.geom",
+                        const std::string& renderVertexPath = "shaders/particle_gpu.vert",
+                        const std::string& renderFragmentPath = "shaders/particle.frag");
+        bool isInitialized() const { return m_initialized; }
+
+        // Queue a particle for upload on the next update(). Spawns above the
+        // per-frame spawn capacity carry over to following frames; they then start
+        // later than ParticleSimulation's pool accounting assumes, so size the spawn
+        // capacity for the peak spawns per step.
+        void queueSpawn(const GpuParticle& particle) { m_pendingSpawns.push_back(particle); }
+        size_t getPendingSpawnCount() const { return m_pendingSpawns.size(); }
+
+        // Run one feedback pass: advance live particles and append queued spawns
+        void update(float deltaTime);
+
+        void render(const glm::mat4& projection, const glm::mat4& view, float time, float pointScale = 1.0f);
+
+        // Particles further than 'distance' from 'cameraPosition' are dropped in the update pass (<= 0 disables)
+        void setDistanceCulling(const glm::vec3& cameraPosition, float distance) {
+            m_cameraPosition = cameraPosition;
+            m_cullDistance = distance;
+        }
+
+        // Copies the live set back to the CPU. Stalls the pipeline: tests/debug only.
+        size_t readBack(std::vector<GpuParticle>& out);
+
+        size_t getMaxParticles() const { return m_maxParticles; }
+
+    private:
+        bool buildUpdateProgram(const std::string& vertexPath, const std::string& geometryPath);
+        void createBuffers();
+        void setupAttributes(GLuint vao, GLuint buffer);
+
+        size_t m_maxParticles;
+        size_t m_spawnCapacity;
+        std::vector<GpuParticle> m_pendingSpawns;
+
+        GLuint m_updateProgram = 0;
+        GLint m_deltaTimeLocation = -1;
+        GLint m_cameraPositionLocation = -1;
+        GLint m_cullDistanceSqLocation = -1;
+        glm::vec3 m_cameraPosition{0.0f};
+        float m_cullDistance = 0.0f;
+        ShaderId m_renderShaderId = INVALID_SHADER; // Owned by ShaderManager::shared(), which reloads it
+
+        GLuint m_buffers[2] = {0, 0};
+        GLuint m_vaos[2] = {0, 0};
+        GLuint m_feedback[2] = {0, 0};
+        bool m_hasData[2] = {false, false};
+        int m_current = 0; // Buffer holding the latest state
+
+        GLuint m_spawnBuffer = 0;
+        GLuint m_spawnVAO = 0;
+        GLuint m_writtenQuery = 0; // GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, read only by readBack()
+
+        bool m_initialized = false;
+    };
+
+} // namespace TurtleEngine
@@ -1,33 +1,127 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
-#include "Shader.hpp"
+#include "ShaderManager.hpp"
 
 namespace TurtleEngine {
 
+// One entry of a bulk colour update
+struct GridCellColor {
+    int x = 0;
+    int y = 0;
+    glm::vec3 color{0.0f};
+};
+
+enum class GridRenderMode {
+    PER_VERTEX_COLOR, // 4 vertices + 6 indices per cell, colour copied into every vertex
+    COLOR_TEXTURE     // One quad per chunk; colours come from an RGB8 texture per chunk
+};
+
+class RenderCommandList;
+
 class Grid {
 public:
-    Grid(int width, int height, float cellSize);
+    static constexpr int DEFAULT_CHUNK_SIZE = 64;
+    static constexpr int MAX_CHUNK_SIZE = 128; // Keeps per-chunk indices 16-bit
+
+    // The grid is split into chunkSize x chunkSize cell chunks. A chunk's GPU
+    // resources are built the first time it is visible and culled chunks cost nothing.
+    Grid(int width, int height, float cellSize, GridRenderMode mode = GridRenderMode::COLOR_TEXTURE,
+         int chunkSize = DEFAULT_CHUNK_SIZE);
     ~Grid();
 
     void render(const glm::mat4& view, const glm::mat4& projection);
+    // Same culling, building and flushing as render(), but each visible chunk is
+    // recorded as a packet on 'list' instead of being drawn
+    void submit(RenderCommandList& list, const glm::mat4& projection, const glm::mat4& view);
+    // submit() in two halves for parallel recording: prepare() does the GL work
+    // (chunk uploads, the camera block) on the render thread and returns the packet
+    // count; recordChunks() makes no GL calls and may record any sub-range from a job
+    size_t prepare(const glm::mat4& projection, const glm::mat4& view);
+    void recordChunks(RenderCommandList& list, size_t begin, size_t end, const glm::mat4& view) const;
+
+    // Colour changes are recorded as dirty row ranges in their chunk and uploaded by
+    // flushColors() or when the chunk is next drawn, so many edits per frame cost one
+    // pass. Colours are stored as 8 bits per channel.
     void setCellColor(int x, int y, const glm::vec3& color);
+    void setCellColors(const GridCellColor* cells, size_t count);
+    void setCellColors(const std::vector<GridCellColor>& cells) { setCellColors(cells.data(), cells.size()); }
+    glm::vec3 getCellColor(int x, int y) const; // Black outside the grid
+
+    // Uploads the changed byte ranges of every built chunk
+    void flushColors();
+    bool hasPendingColors() const { return !m_dirtyChunks.empty(); }
+    size_t getLastFlushBytes() const { return m_lastFlushBytes; }
+    size_t getLastFlushUploads() const { return m_lastFlushUploads; } // glBufferSubData / glTexSubImage2D calls
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    float getCellSize() const { return m_cellSize; }
+    GridRenderMode getRenderMode() const { return m_mode; }
+
+    int getChunkSize() const { return m_chunkSize; }
+    size_t getChunkCount() const { return m_chunks.size(); }
+    size_t getBuiltChunkCount() const { return m_builtChunks; }
+    size_t getLastVisibleChunkCount() const { return m_lastVisibleChunks; } // Drawn by the last render() / submit()
 
 private:
+    struct Chunk {
+        int x0 = 0, y0 = 0;          // First cell
+        int width = 0, height = 0;   // In cells (edge chunks may be smaller)
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+
+        GLuint vao = 0;
+        GLuint positionVBO = 0;
+        GLuint colorVBO = 0;         // PER_VERTEX_COLOR
+        GLuint texture = 0;          // COLOR_TEXTURE
+        bool built = false;
+
+        // Dirty tracking: one [min, max] local column span per touched row
+        std::vector<int> dirtyMin;
+        std::vector<int> dirtyMax;
+        std::vector<int> dirtyRows;
+    };
+
     void initializeGrid();
-    void createBuffers();
-    void updateColors();
+    // The live program (looked up each time: a reload replaces it), or null if it failed to load
+    Shader* getShader() const;
+    void prepareVisibleChunks(const glm::mat4& projection, const glm::mat4& view);
+    void createSharedIndices();
+    void buildChunk(Chunk& chunk);
+    void buildVertexChunk(Chunk& chunk);
+    void buildTexturedChunk(Chunk& chunk);
+    void destroyChunk(Chunk& chunk);
+    void markDirty(int x, int y);
+    void flushChunk(Chunk& chunk);
+    void flushVertexColors(Chunk& chunk);
+    void flushColorTexture(Chunk& chunk);
+    void uploadColorRange(const Chunk& chunk, size_t firstCell, size_t cellCount);
+    void uploadColorRect(const Chunk& chunk, int x, int y, int width, int height);
 
     int m_width;
     int m_height;
     float m_cellSize;
-    std::vector<glm::vec3> m_colors;
-    
-    unsigned int m_VAO;
-    unsigned int m_VBO;
-    unsigned int m_EBO;
-    Shader m_shader;
+    GridRenderMode m_mode;
+    int m_chunkSize;
+    int m_chunksX = 0;
+    std::vector<uint8_t> m_colors; // RGB8 per cell, row-major over the whole grid
+
+    std::vector<Chunk> m_chunks;
+    std::vector<uint32_t> m_dirtyChunks; // Built chunks with unflushed colours
+    size_t m_builtChunks = 0;
+    size_t m_lastVisibleChunks = 0;
+    std::vector<uint32_t> m_visibleChunks; // Filled by prepareVisibleChunks()
+
+    std::vector<glm::vec3> m_uploadScratch; // PER_VERTEX_COLOR: cell colours expanded to 4 vertices
+    size_t m_lastFlushBytes = 0;
+    size_t m_lastFlushUploads = 0;
+
+    unsigned int m_EBO = 0; // Shared by all chunks: cell i uses vertices 4i .. 4i+3
+    ShaderId m_shaderId = INVALID_SHADER; // Owned by ShaderManager::shared(), which reloads it
 };
-} 
\ No newline at end of file
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "combat/Hitbox.hpp"
+
+namespace TurtleEngine {
+
+    using OccupantId = uint32_t;
+    constexpr OccupantId INVALID_OCCUPANT = 0xFFFFFFFFu;
+
+    // Which entities stand on which cells of a Grid. Uses the Grid's mapping: the
+    // width x height cells of 'cellSize' are centred on the origin, cell x runs along
+    // world X and cell y along world Z. Heights are ignored.
+    //
+    // Each occupant is a footprint rectangle on the XZ plane, filed under the cell that
+    // holds its centre (a loose grid). Cells keep intrusive doubly linked lists over
+    // packed per-occupant arrays, so insert, move and remove are O(1) and never allocate
+    // once capacity is reserved. Range queries widen the cell range by the largest
+    // half extent seen so far, then test footprints exactly. Occupants outside the grid
+    // are filed under the nearest edge cell and remain queryable.
+    class GridOccupancy {
+    public:
+        GridOccupancy(int width, int height, float cellSize);
+
+        // Cell containing 'position', clamped to the grid
+        glm::ivec2 worldToCell(const glm::vec3& position) const;
+        // World position of a cell's centre (y = 0)
+        glm::vec3 cellToWorld(int x, int y) const;
+        bool isInside(const glm::vec3& position) const;
+
+        void reserve(size_t occupants);
+
+        // Footprints are given by centre and half extents on the XZ plane
+        OccupantId insert(const glm::vec3& position, const glm::vec2& halfExtents = glm::vec2(0.0f));
+        OccupantId insert(const HitboxAABB& hitbox);
+        void move(OccupantId id, const glm::vec3& position);
+        void move(OccupantId id, const glm::vec3& position, const glm::vec2& halfExtents);
+        void move(OccupantId id, const HitboxAABB& hitbox);
+        void remove(OccupantId id);
+        void clear();
+
+        bool contains(OccupantId id) const { return id < m_cell.size() && m_cell[id] >= 0; }
+        glm::vec3 getPosition(OccupantId id) const;
+        size_t getOccupantCount() const { return m_occupantCount; }
+
+        // Number of occupants filed under a cell, 0 outside the grid
+        uint32_t getCellCount(int x, int y) const;
+
+        // Each query appends the ids of matching occupants to 'out' and returns how many
+        // it added. Queries are const and may run concurrently.
+        size_t queryCell(int x, int y, std::vector<OccupantId>& out) const;
+        size_t queryAABB(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<OccupantId>& out) const;
+        size_t queryRadius(const glm::vec3& centre, float radius, std::vector<OccupantId>& out) const;
+
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+        float getCellSize() const { return m_cellSize; }
+
+    private:
+        int32_t cellIndexOf(float x, float z) const;
+        void link(OccupantId id, int32_t cell);
+        void unlink(OccupantId id);
+        void place(OccupantId id, const glm::vec3& position, const glm::vec2& halfExtents);
+        template <typename Accept>
+        size_t gather(const glm::vec2& minXZ, const glm::vec2& maxXZ, Accept accept, std::vector<OccupantId>& out) const;
+
+        int m_width;
+        int m_height;
+        float m_cellSize;
+        float m_inverseCellSize;
+        glm::vec2 m_origin; // World XZ of cell (0, 0)'s corner
+
+        std::vector<int32_t> m_cellHead;   // First occupant per cell, -1 when empty
+        std::vector<uint32_t> m_cellCount;
+
+        // Per occupant, indexed by id. m_cell is -1 for free ids.
+        std::vector<int32_t> m_cell;
+        std::vector<int32_t> m_next;
+        std::vector<int32_t> m_previous;
+        std::vector<glm::vec2> m_centre;
+        std::vector<glm::vec2> m_halfExtents;
+        std::vector<float> m_y;
+        std::vector<OccupantId> m_freeIds;
+        size_t m_occupantCount = 0;
+        glm::vec2 m_maxHalfExtents{0.0f}; // Only grows until clear()
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "ShaderManager.hpp"
+
+namespace TurtleEngine {
+
+class Grid;
+
+// One stop of an overlay palette; alpha is the overlay's opacity at that value
+struct OverlayPaletteStop {
+    float position = 0.0f; // 0 .. 1 across the value range
+    glm::vec4 color{0.0f};
+};
+
+// Per-cell telemetry (damage density, temporal distortion, AI density...) drawn as a
+// heatmap over a Grid with the same layout. Values are plain floats in a double buffer:
+// any thread writes the back buffer, the main thread swap()s once per frame and the
+// front buffer goes to the GPU as one R32F upload. Colour mapping is a palette lookup
+// in the fragment shader, so the CPU never touches colours or geometry.
+class GridOverlay {
+public:
+    static constexpr int PALETTE_SIZE = 256;
+
+    explicit GridOverlay(const Grid& grid);
+    ~GridOverlay();
+    GridOverlay(const GridOverlay&) = delete;
+    GridOverlay& operator=(const GridOverlay&) = delete;
+
+    // Writer side. The back buffer keeps what it held two swaps ago, so writers either
+    // overwrite every cell they own or clear first. Writers must use disjoint cells
+    // and be finished before swap().
+    float* getWriteBuffer() { return m_values[m_writeIndex].data(); }
+    void setValue(int x, int y, float value);
+    void clearWriteBuffer(float value = 0.0f);
+
+    // Main thread: publishes the back buffer; it is uploaded by the next render()
+    void swap();
+    // Value currently displayed
+    float getValue(int x, int y) const;
+
+    // Values at or below 'minValue' map to the first palette entry, at or above 'maxValue' to the last
+    void setRange(float minValue, float maxValue);
+    void setPalette(const std::vector<OverlayPaletteStop>& stops);
+    static std::vector<OverlayPaletteStop> heatPalette();
+
+    void setVisible(bool visible) { m_visible = visible; }
+    bool isVisible() const { return m_visible; }
+
+    // Draws over the grid (call after Grid::render, with the same matrices)
+    void render(const glm::mat4& projection, const glm::mat4& view);
+
+    size_t getLastUploadBytes() const { return m_lastUploadBytes; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    bool initialize();
+    void uploadValues();
+
+    int m_width;
+    int m_height;
+    float m_cellSize;
+
+    std::vector<float> m_values[2];
+    int m_writeIndex = 0;
+    bool m_pendingUpload = false;
+    float m_minValue = 0.0f;
+    float m_maxValue = 1.0f;
+    bool m_visible = true;
+    bool m_initialized = false;
+    size_t m_lastUploadBytes = 0;
+
+    GLuint m_VAO = 0;
+    GLuint m_VBO = 0;
+    GLuint m_valueTexture = 0;
+    GLuint m_paletteTexture = 0;
+    ShaderId m_shaderId = INVALID_SHADER; // Owned by ShaderManager::shared(), which reloads it
+    GLuint m_samplerProgram = 0;           // Program whose sampler units have been set
+};
+}
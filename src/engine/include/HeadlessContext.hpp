@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+namespace TurtleEngine {
+
+// An OpenGL context with no window or display server, for CI renders and
+// benchmarks. Uses EGL on Mesa's surfaceless platform (EGL_MESA_platform_surfaceless),
+// or the default EGL display when that is missing, with no surface bound when the
+// driver has EGL_KHR_surfaceless_context and a 1x1 pbuffer otherwise. Draw into a
+// RenderTarget; there is no default framebuffer to present.
+//
+// libEGL is loaded at run time, so nothing links against it and the engine runs
+// unchanged where it is absent; initialize() just fails. Linux only for now.
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Creates a core profile context, makes it current and initializes GLEW
+    bool initialize(int majorVersion = 4, int minorVersion = 0);
+    void cleanup();
+    bool isValid() const { return m_context != nullptr; }
+    // "EGL surfaceless" or "EGL pbuffer"
+    const std::string& getBackend() const { return m_backend; }
+
+private:
+    bool createContext(int majorVersion, int minorVersion);
+
+    void* m_library = nullptr; // libEGL
+    void* m_display = nullptr;
+    void* m_context = nullptr;
+    void* m_surface = nullptr; // Only without EGL_KHR_surfaceless_context
+    std::string m_backend;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TurtleEngine {
+
+    // Small fixed pool of worker threads for data-parallel loops.
+    // parallelFor() blocks until the whole range is done; the calling thread
+    // works on batches too, so a pool with zero workers simply runs inline.
+    class JobSystem {
+    public:
+        // 0 = one worker per hardware thread, minus the caller
+        explicit JobSystem(size_t workerCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        size_t getWorkerCount() const { return m_workers.size(); }
+        // Threads that take part in parallelFor (workers + caller)
+        size_t getConcurrency() const { return m_workers.size() + 1; }
+
+        // Runs job(begin, end) over [0, count) in batches of at least minBatch items.
+        // Calls from inside a job run inline instead of deadlocking.
+        void parallelFor(size_t count, size_t minBatch, const std::function<void(size_t, size_t)>& job);
+
+        // Process-wide pool shared by engine systems
+        static JobSystem& shared();
+
+    private:
+        void workerLoop();
+        void runBatches(const std::function<void(size_t, size_t)>& job);
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_submitMutex; // One parallelFor at a time
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        // Current loop, guarded by m_mutex (batch counters are atomics)
+        const std::function<void(size_t, size_t)>* m_job = nullptr;
+        size_t m_count = 0;
+        size_t m_batchSize = 0;
+        size_t m_batchCount = 0;
+        std::atomic<size_t> m_nextBatch{0};
+        std::atomic<size_t> m_finishedBatches{0};
+        size_t m_activeWorkers = 0;
+        uint64_t m_generation = 0;
+        bool m_stop = false;
+    };
+
+} // namespace TurtleEngine
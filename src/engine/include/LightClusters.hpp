@@ -0,0 +1,91 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TurtleEngine {
+
+struct LightData;
+class JobSystem;
+
+struct LightClusterStats {
+    size_t lights = 0;         // Lights handed to build()
+    size_t visibleLights = 0;  // Lights touching the view frustum
+    size_t references = 0;     // Entries in the index list
+    size_t maxPerCluster = 0;
+};
+
+// Point lights binned into a froxel grid: the view frustum cut into GRID_X x GRID_Y
+// screen tiles and GRID_Z depth slices spaced exponentially between the near and
+// far planes. A fragment looks up its froxel and shades only the lights listed
+// there, so shading cost follows the lights near it rather than the light count.
+//
+// Binning runs on the CPU: lights outside the frustum are dropped, then each depth
+// slice tests its lights against the view-space boxes of its froxels. The boxes
+// are kept in SoA form and the sphere-box test is branch-free, so the inner loop
+// vectorises; with many lights the slices are spread over the job system.
+//
+// upload() puts the result in three texture buffers for the lighting shader (GLSL
+// 330 has no storage buffers): the lights as (positionRadius, colorIntensity)
+// texel pairs, an (offset, count) range per froxel, and the flat index list.
+class LightClusters {
+public:
+    static constexpr int GRID_X = 16;
+    static constexpr int GRID_Y = 9;
+    static constexpr int GRID_Z = 24;
+    static constexpr size_t CLUSTER_COUNT = static_cast<size_t>(GRID_X) * GRID_Y * GRID_Z;
+    static constexpr size_t MAX_LIGHTS = 1024;
+    static constexpr size_t PARALLEL_THRESHOLD = 64; // Visible lights; below this one thread is faster
+
+    LightClusters() = default;
+    ~LightClusters();
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+
+    // CPU binning; 'jobs' may be null to run on the calling thread
+    void build(const glm::mat4& view, const glm::mat4& projection, const LightData* lights, size_t count, JobSystem* jobs);
+
+    // Sends the lights and the last build to the texture buffers
+    bool upload(const LightData* lights, size_t count);
+    // Binds the texture buffers to CLUSTER_*_UNIT (UniformBuffer.hpp)
+    void bind() const;
+    void cleanup();
+
+    // near, far, slice scale, slice bias: slice = floor(log(depth) * scale + bias)
+    const glm::vec4& getDepthParams() const { return m_depthParams; }
+    int sliceOf(float viewDepth) const;
+    static size_t clusterIndex(int x, int y, int z) { return (static_cast<size_t>(z) * GRID_Y + y) * GRID_X + x; }
+
+    // Light indices binned into a froxel, in ascending order
+    const uint32_t* getClusterLights(size_t cluster, size_t& count) const;
+    const LightClusterStats& getStats() const { return m_stats; }
+
+private:
+    void computeBounds(const glm::mat4& projection);
+    void binSlice(int slice);
+
+    // Froxel view-space boxes, SoA, indexed by clusterIndex()
+    std::vector<float> m_minX, m_minY, m_minZ;
+    std::vector<float> m_maxX, m_maxY, m_maxZ;
+    glm::mat4 m_projection = glm::mat4(0.0f);
+    glm::vec4 m_depthParams = glm::vec4(0.0f);
+
+    // Visible lights in view space, SoA
+    std::vector<float> m_lightX, m_lightY, m_lightZ, m_lightRadius;
+    std::vector<uint32_t> m_lightIndex;
+    std::vector<int> m_firstSlice, m_lastSlice;
+
+    std::vector<std::vector<uint32_t>> m_bins; // Per froxel, filled by binSlice
+    std::vector<uint32_t> m_ranges;            // offset, count per froxel
+    std::vector<uint32_t> m_indices;
+    std::vector<glm::vec4> m_lightTexels;
+    LightClusterStats m_stats;
+
+    GLuint m_buffers[3] = {};  // lights, ranges, indices
+    GLuint m_textures[3] = {};
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+namespace TurtleEngine {
+
+    // Emitter priority tiers: lower tiers are throttled first under load
+    constexpr int PARTICLE_PRIORITY_LEVELS = 4; // 0 = expendable ... 3 = critical
+
+    struct ParticleBudgetSettings {
+        bool enabled = true;
+        float frameBudgetMs = 2.0f;      // Target particle update + render cost per frame
+        float pressureThreshold = 0.8f;  // Start throttling at this fraction of the budget
+        float costSmoothing = 0.15f;     // EMA weight of the newest cost sample
+        float minSpawnScale = 0.1f;      // Floor for throttled emitters
+        float maxPointSizeScale = 2.0f;  // Cap on point-size compensation
+        // Culling only kicks in once pressure reaches pressureThreshold, so scenes
+        // within budget keep every particle
+        float cullDistance = 80.0f;      // Particles further from the camera are dropped (<= 0 disables)
+        bool frustumCulling = true;      // Skip uploading particles outside the view frustum
+    };
+
+    // Decisions and measurements from the most recent frame
+    struct ParticleBudgetCounters {
+        float updateMs = 0.0f;
+        float renderMs = 0.0f;
+        float smoothedCostMs = 0.0f;
+        float pressure = 0.0f;           // smoothedCostMs / frameBudgetMs
+        float spawnScale[PARTICLE_PRIORITY_LEVELS] = {1.0f, 1.0f, 1.0f, 1.0f};
+        float pointSizeScale = 1.0f;
+        size_t spawnsRequested = 0;
+        size_t spawnsSuppressed = 0;     // Withheld by throttling (not by pool budgets)
+        size_t spawnsDropped = 0;        // Lost because the particle pool was full
+        size_t culledByDistance = 0;     // Removed from the simulation
+        size_t culledByFrustum = 0;      // Simulated but not uploaded
+    };
+
+    // Watches measured particle cost and turns it into per-priority spawn
+    // scales plus a point-size factor that keeps throttled effects visually dense.
+    class ParticleBudgetManager {
+    public:
+        void setSettings(const ParticleBudgetSettings& settings) { m_settings = settings; }
+        const ParticleBudgetSettings& getSettings() const { return m_settings; }
+
+        // Feed last frame's measured cost; recomputes spawn scales
+        void reportCost(float updateMs, float renderMs);
+
+        // Spawn multiplier for an emitter priority (clamped into range)
+        float getSpawnScale(int priority) const;
+        float getPointSizeScale() const { return m_counters.pointSizeScale; }
+        // Distance and frustum culling apply: enabled and at or over the pressure threshold
+        bool isCulling() const { return m_settings.enabled && m_counters.pressure >= m_settings.pressureThreshold; }
+
+        // Per-frame bookkeeping from the simulation
+        void beginFrame();
+        void recordSpawns(size_t requested, size_t suppressed);
+        void recordDroppedSpawns(size_t count) { m_counters.spawnsDropped += count; }
+        void recordDistanceCulls(size_t count) { m_counters.culledByDistance += count; }
+        void recordFrustumCulls(size_t count) { m_counters.culledByFrustum += count; }
+        void endFrame();
+
+        const ParticleBudgetCounters& getCounters() const { return m_counters; }
+
+    private:
+        ParticleBudgetSettings m_settings;
+        ParticleBudgetCounters m_counters;
+        bool m_hasCostSample = false;
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "combat/Hitbox.hpp"
+
+namespace TurtleEngine {
+
+    struct Particle;
+    class JobSystem;
+
+    enum class ParticleCollisionResponse {
+        NONE,    // Passes through
+        BOUNCE,  // Reflects off the surface
+        STICK,   // Stops at the contact point
+        DIE      // Removed on contact
+    };
+
+    struct ParticleHitEvent {
+        uint32_t particle;        // Pool slot at the time of the hit
+        int32_t emitter;          // Owning emitter, -1 for loose particles
+        int32_t hitbox;           // Index into the current hitbox list, -1 for the ground plane
+        ParticleCollisionResponse response;
+        glm::vec3 position;       // Contact point
+        glm::vec3 normal;
+        float speed;              // Speed along the normal at impact
+    };
+
+    struct ParticleCollisionSettings {
+        float hashCellSize = 2.0f;   // Spatial hash cell edge; around the typical hitbox size works best
+        float restitution = 0.4f;    // Normal speed kept by BOUNCE
+        float friction = 0.2f;       // Tangential speed lost by BOUNCE
+        ParticleCollisionResponse looseResponse = ParticleCollisionResponse::BOUNCE; // For particles without an emitter
+    };
+
+    // Live particle positions in SoA form. The simulation loop fills it while each
+    // particle is already in cache, so the collision pass streams a few floats per
+    // particle and only touches the Particle itself on an actual hit.
+    struct ParticlePositionStream {
+        std::vector<uint32_t> slots;
+        std::vector<float> x, y, z;
+        std::vector<float> previousX, previousY, previousZ;
+
+        void clear() {
+            slots.clear();
+            x.clear(); y.clear(); z.clear();
+            previousX.clear(); previousY.clear(); previousZ.clear();
+        }
+        void reserve(size_t count) {
+            slots.reserve(count);
+            x.reserve(count); y.reserve(count); z.reserve(count);
+            previousX.reserve(count); previousY.reserve(count); previousZ.reserve(count);
+        }
+        void push(uint32_t slot, const glm::vec3& position, const glm::vec3& previousPosition) {
+            slots.push_back(slot);
+            x.push_back(position.x);
+            y.push_back(position.y);
+            z.push_back(position.z);
+            previousX.push_back(previousPosition.x);
+            previousY.push_back(previousPosition.y);
+            previousZ.push_back(previousPosition.z);
+        }
+        size_t size() const { return slots.size(); }
+    };
+
+    // Collides moving particles against a ground plane (the floor Grid) and a set of
+    // hitboxes. Hitboxes go into a uniform spatial hash rebuilt by setHitboxes(); particles
+    // are tested in batches straight from the SoA stream, so the common "touches nothing"
+    // case is a few branch-free compares and a hash per particle. Contacts are detected on entry (previous position outside,
+    // current inside), so resting or stuck particles do not raise repeated hits.
+    class ParticleCollider {
+    public:
+        void setSettings(const ParticleCollisionSettings& settings) { m_settings = settings; }
+        const ParticleCollisionSettings& getSettings() const { return m_settings; }
+
+        // Horizontal plane at 'height' covering [minXZ, maxXZ]; normal points up
+        void setGroundPlane(float height, const glm::vec2& minXZ, const glm::vec2& maxXZ);
+        void clearGroundPlane() { m_hasGround = false; }
+        bool hasGroundPlane() const { return m_hasGround; }
+
+        // Replaces the hitbox set and rebuilds the spatial hash (call once per frame)
+        void setHitboxes(const HitboxAABB* hitboxes, size_t count);
+        size_t getHitboxCount() const { return m_boxMin.size(); }
+
+        bool hasColliders() const { return m_hasGround || !m_boxMin.empty(); }
+
+        // Resolves contacts for the particles in 'stream'. 'responses' is indexed by emitter.
+        // Hits are appended to 'events' in stream order, also when run in parallel.
+        void collide(std::vector<Particle>& particles, const ParticlePositionStream& stream,
+                     const ParticleCollisionResponse* responses, size_t responseCount,
+                     std::vector<ParticleHitEvent>& events, JobSystem* jobs = nullptr);
+
+    private:
+        void collideRange(std::vector<Particle>& particles, const ParticlePositionStream& stream, size_t begin, size_t end,
+                          const ParticleCollisionResponse* responses, size_t responseCount,
+                          std::vector<ParticleHitEvent>& events) const;
+        bool findHitbox(uint32_t bucket, const glm::vec3& from, const glm::vec3& to, int32_t& hitbox, float& entryT, glm::vec3& normal) const;
+        void respond(Particle& p, ParticleCollisionResponse response, const glm::vec3& contact, const glm::vec3& normal) const;
+        uint32_t bucketOf(int x, int y, int z) const;
+
+        ParticleCollisionSettings m_settings;
+
+        // Ground plane
+        bool m_hasGround = false;
+        float m_groundHeight = 0.0f;
+        glm::vec2 m_groundMin{0.0f};
+        glm::vec2 m_groundMax{0.0f};
+
+        // Hitboxes (SoA) and their spatial hash
+        std::vector<glm::vec3> m_boxMin;
+        std::vector<glm::vec3> m_boxMax;
+        glm::vec3 m_boundsMin{0.0f};
+        glm::vec3 m_boundsMax{0.0f};
+        float m_inverseCellSize = 0.5f;
+        uint32_t m_bucketMask = 0;
+        std::vector<uint32_t> m_bucketStart; // Bucket b owns m_bucketEntries[start[b] .. start[b + 1])
+        std::vector<uint32_t> m_bucketEntries;
+
+        // Per-chunk output when collide() runs on several threads
+        std::vector<std::vector<ParticleHitEvent>> m_chunkEvents;
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "FastRandom.hpp"
+#include "ParticleCollider.hpp"
+
+namespace TurtleEngine {
+
+    struct Particle;
+
+    // Piecewise-linear curve over normalized particle age (0 = spawn, 1 = death)
+    template <typename T>
+    struct ParticleCurve {
+        static constexpr int MAX_KEYS = 4;
+        struct Key {
+            float t = 0.0f;
+            T value{};
+        };
+
+        std::array<Key, MAX_KEYS> keys{};
+        int keyCount = 0;
+
+        ParticleCurve() = default;
+        ParticleCurve(const T& constant) { addKey(0.0f, constant); }
+        ParticleCurve(const T& start, const T& end) {
+            addKey(0.0f, start);
+            addKey(1.0f, end);
+        }
+
+        // Keys must be added in increasing t order; extra keys are ignored
+        void addKey(float t, const T& value) {
+            if (keyCount < MAX_KEYS) {
+                keys[keyCount++] = Key{t, value};
+            }
+        }
+
+        T evaluate(float t) const {
+            if (keyCount == 0) return T{};
+            if (keyCount == 1 || t <= keys[0].t) return keys[0].value;
+            for (int i = 1; i < keyCount; ++i) {
+                if (t <= keys[i].t) {
+                    const Key& a = keys[i - 1];
+                    const Key& b = keys[i];
+                    float span = b.t - a.t;
+                    float f = span > 0.0f ? (t - a.t) / span : 1.0f;
+                    return a.value + (b.value - a.value) * f;
+                }
+            }
+            return keys[keyCount - 1].value;
+        }
+    };
+
+    enum class EmitterShape {
+        POINT,  // All particles start at the emitter position
+        SPHERE, // Uniform inside a sphere of 'radius', moving outwards
+        CONE,   // From the emitter position, within 'coneAngle' of 'direction'
+        BOX     // Uniform inside 'boxHalfExtents', random direction
+    };
+
+    // Static configuration of an emitter
+    struct ParticleEmitterDesc {
+        EmitterShape shape = EmitterShape::POINT;
+        glm::vec3 position{0.0f};
+        glm::vec3 direction{0.0f, 1.0f, 0.0f}; // Used by CONE
+        float coneAngle = 0.4f;                // Half-angle in radians, used by CONE
+        float radius = 0.5f;                   // Used by SPHERE
+        glm::vec3 boxHalfExtents{0.5f};        // Used by BOX
+
+        float rate = 100.0f;      // Continuous emission in particles/second (0 = bursts only)
+        float speedMin = 1.0f;
+        float speedMax = 2.0f;
+        float lifetimeMin = 1.0f;
+        float lifetimeMax = 2.0f;
+        ParticleCurve<glm::vec4> colorOverLife{glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)};
+
+        size_t maxParticles = 1000; // Pool budget: live particles this emitter may own
+        int priority = 1;           // 0 (expendable) .. 3 (critical), see ParticleBudgetManager
+        ParticleCollisionResponse collision = ParticleCollisionResponse::BOUNCE; // When the collision stage is on
+        uint64_t seed = 0;          // 0 = derived from the owning system
+    };
+
+    // Runtime emitter state. Owned by ParticleSimulation; spawns into its pool.
+    class ParticleEmitter {
+    public:
+        ParticleEmitter(const ParticleEmitterDesc& desc, uint64_t seed);
+
+        const ParticleEmitterDesc& getDesc() const { return m_desc; }
+        ParticleEmitterDesc& getDesc() { return m_desc; }
+
+        void setPosition(const glm::vec3& position) { m_desc.position = position; }
+        void setActive(bool active) { m_active = active; }
+        bool isActive() const { return m_active; }
+
+        // A retired emitter stops spawning; its slot is reused once its particles die
+        void retire() { m_retired = true; m_active = false; m_pendingBurst = 0; }
+        bool isRetired() const { return m_retired; }
+
+        size_t getLiveCount() const { return m_liveCount; }
+        size_t getBudgetRemaining() const {
+            return m_liveCount < m_desc.maxParticles ? m_desc.maxParticles - m_liveCount : 0;
+        }
+
+        // Advance the emission accumulator and return how many particles
+        // should be spawned this frame (already clamped to the pool budget).
+        // spawnScale < 1 throttles both continuous emission and bursts.
+        size_t accumulate(float deltaTime, float spawnScale = 1.0f);
+
+        // What the last accumulate() would have spawned unthrottled, and how much of that it withheld
+        size_t getLastRequested() const { return m_lastRequested; }
+        size_t getLastSuppressed() const { return m_lastSuppressed; }
+
+        // Queue an extra burst on top of continuous emission
+        void requestBurst(size_t count) { m_pendingBurst += count; }
+
+        // Initialize 'count' particles at the given pool slots in one batch
+        void spawnInto(std::vector<Particle>& pool, const uint32_t* slots, size_t count, int32_t emitterIndex);
+
+        void onParticleSpawned(size_t count) { m_liveCount += count; }
+        void onParticleDied() { if (m_liveCount > 0) --m_liveCount; }
+        void onParticlesDied(size_t count) { m_liveCount -= count < m_liveCount ? count : m_liveCount; }
+
+    private:
+        ParticleEmitterDesc m_desc;
+        Xoshiro128x4 m_rng;
+        std::vector<float> m_random; // Scratch uniforms, reused between batches
+        float m_accumulator = 0.0f;
+        float m_requestAccumulator = 0.0f; // Unthrottled twin of m_accumulator
+        size_t m_lastRequested = 0;
+        size_t m_lastSuppressed = 0;
+        size_t m_pendingBurst = 0;
+        size_t m_liveCount = 0;
+        bool m_active = true;
+        bool m_retired = false;
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include "ShaderManager.hpp"
+#include "ParticleSimulation.hpp"
+
+namespace TurtleEngine {
+
+    // Draws a ParticleRenderView as GL points. Owns the VAO and VBO, and its shader
+    // through the ShaderManager; the simulation that produced the view never touches GL.
+    class ParticleRenderer {
+    public:
+        explicit ParticleRenderer(size_t maxParticles);
+        ~ParticleRenderer();
+
+        bool initialize(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+        bool isInitialized() const { return m_initialized; }
+
+        // Uploads the view into the VBO and draws it
+        void render(const ParticleRenderView& particles, const glm::mat4& projection, const glm::mat4& view, float time);
+
+    private:
+        void createBuffers();
+
+        size_t m_maxParticles;
+        ShaderId m_shaderId = INVALID_SHADER; // Owned by ShaderManager::shared(), which reloads it
+        GLuint m_VAO = 0;
+        GLuint m_VBO = 0;
+        bool m_initialized = false;
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "ParticleEmitter.hpp"
+#include "ParticleBudgetManager.hpp"
+#include "ParticleCollider.hpp"
+#include "Frustum.hpp"
+#include "RadixSort.hpp"
+
+namespace TurtleEngine {
+
+    // Represents a single particle
+    struct Particle {
+        glm::vec3 position{0.0f};
+        glm::vec3 previousPosition{0.0f}; // Position one fixed step ago, for interpolation
+        glm::vec3 velocity{0.0f};
+        glm::vec4 color{1.0f, 1.0f, 0.0f, 1.0f}; // Default yellow spark color
+        float life = 0.0f; // Remaining life time in seconds
+        float initialLife = 0.0f; // Store initial lifetime for normalization
+        int32_t emitter = -1; // Owning emitter index, -1 for loose particles
+
+        Particle() = default; // Needed for vector resizing
+        Particle(glm::vec3 pos, glm::vec3 vel, glm::vec4 col, float currentLife, float initLife)
+            : position(pos), previousPosition(pos), velocity(vel), color(col), life(currentLife), initialLife(initLife) {}
+    };
+
+    // Handle to an emitter owned by a ParticleSimulation
+    using EmitterHandle = int32_t;
+    constexpr EmitterHandle INVALID_EMITTER = -1;
+
+    // Floats per particle in the render view: position (3), colour (4), life ratio (1)
+    constexpr size_t PARTICLE_VERTEX_FLOATS = 8;
+
+    // What the simulation produced for drawing, valid until the next update()
+    struct ParticleRenderView {
+        const float* vertices = nullptr; // 'count' * PARTICLE_VERTEX_FLOATS, in draw order
+        size_t count = 0;
+        float pointScale = 1.0f;         // Throttled emitters draw fewer, larger points
+        bool depthSorted = false;        // Sorting is on: draw alpha blended without depth writes
+    };
+
+    // A spawn handed to an external integrator instead of entering the CPU pool
+    struct ParticleSpawnRecord {
+        glm::vec3 position{0.0f};
+        glm::vec3 velocity{0.0f};
+        glm::vec4 startColor{1.0f};
+        glm::vec4 endColor{1.0f};
+        float life = 0.0f;
+        float initialLife = 0.0f;
+    };
+
+    // Runs once per simulation step when particles are integrated elsewhere (the GPU
+    // backend): receives that step's spawns and the step length
+    using ParticleStepHandler = std::function<void(const std::vector<ParticleSpawnRecord>& spawns, float deltaTime)>;
+
+    // Pure-CPU particle simulation: emitters, integration, budget, culling, sorting and
+    // collision. Has no GL dependency; each update() leaves a ParticleRenderView that a
+    // renderer (see ParticleSystem) uploads, so it can be tested and benchmarked headless.
+    class ParticleSimulation {
+    public:
+        explicit ParticleSimulation(size_t maxParticles = 1000);
+
+        // Spawn a single particle
+        void spawnParticle(const Particle& particleProperties);
+
+        // Spawn multiple particles (e.g., for an explosion)
+        void spawnBurst(int count, glm::vec3 origin, float initialSpeed, float lifetime, glm::vec4 color);
+
+        // Emitters spawn in batches during update(), each within its own pool budget
+        EmitterHandle addEmitter(const ParticleEmitterDesc& desc);
+        void removeEmitter(EmitterHandle handle);
+        ParticleEmitter* getEmitter(EmitterHandle handle);
+        void emitBurst(EmitterHandle handle, size_t count);
+
+        // Hand integration to someone else: spawns are staged and passed to 'handler' once
+        // per step and the CPU pool stays empty. Live counts are never read back, so
+        // staged particles hold a pool slot and their emitter's budget until their
+        // maximum lifetime has passed; spawns beyond the pool size are dropped and
+        // counted in ParticleBudgetCounters::spawnsDropped. Pass nullptr to simulate on
+        // the CPU again.
+        void setExternalIntegration(ParticleStepHandler handler);
+        bool hasExternalIntegration() const { return static_cast<bool>(m_stepHandler); }
+
+        // CPU integration only; an external integrator never reports its live count
+        size_t getActiveParticleCount() const { return m_activeParticleCount; }
+        const std::vector<Particle>& getParticles() const { return m_particles; } // Whole pool, dead included
+        size_t getFreeParticleCount() const { return m_freeSlots.size(); }
+        size_t getMaxParticles() const { return m_maxParticles; }
+
+        // Camera used for distance/frustum culling; set before update() each frame
+        void setCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition);
+        const glm::vec3& getCameraPosition() const { return m_cameraPosition; }
+        // Distance culling radius in effect for the current camera, 0 when off
+        float getActiveCullDistance() const;
+
+        // Cost-driven spawn throttling and culling, see ParticleBudgetManager
+        ParticleBudgetManager& getBudgetManager() { return m_budget; }
+        const ParticleBudgetCounters& getBudgetCounters() const { return m_budget.getCounters(); }
+        // Renderer cost of the last frame, fed into the next update()'s budget decision
+        void reportRenderCost(float renderMs) { m_lastRenderMs = renderMs; }
+
+        // Emit particles back-to-front (needs setCamera) so they can be alpha blended.
+        // The order is reused while the camera is nearly still, for at most 0.1 s of
+        // simulation time, so it can lag particle motion by that much; particles
+        // spawned meanwhile are drawn last.
+        void setDepthSorting(bool enabled) { m_sortEnabled = enabled; m_hasSortedOrder = false; }
+        bool isDepthSortingEnabled() const { return m_sortEnabled; }
+        bool wasSortReused() const { return m_sortReused; } // Last update kept the previous order
+        // Slots in the order the last update emitted them
+        const std::vector<uint32_t>& getDrawOrder() const {
+            return (m_sortEnabled && m_hasCamera) ? m_sortedSlots : m_visibleSlots;
+        }
+
+        // Simulate in fixed steps of 'step' seconds; <= 0 restores one step per update().
+        // Frame time is accumulated, at most maxSubSteps run per update() (the rest is
+        // dropped) and emitted positions are interpolated between the last two steps.
+        void setFixedTimestep(float step, int maxSubSteps = 8);
+        float getFixedTimestep() const { return m_fixedTimestep; }
+        int getLastStepCount() const { return m_lastStepCount; }
+        float getInterpolationAlpha() const { return m_interpolationAlpha; }
+
+        // Base seed for emitters without an explicit desc.seed. Each emitter's seed
+        // depends only on this and its handle, so replays match; call before adding emitters.
+        void setSeed(uint64_t seed);
+
+        // Optional collision stage (CPU integration): particles hit the collider's ground
+        // plane and hitboxes after each step, responding per emitter desc.collision.
+        // Hits from one update() are delivered together to the callback.
+        void setCollisionEnabled(bool enabled) { m_collisionEnabled = enabled; }
+        bool isCollisionEnabled() const { return m_collisionEnabled; }
+        ParticleCollider& getCollider() { return m_collider; }
+        const std::vector<ParticleHitEvent>& getHitEvents() const { return m_hitEvents; } // Last update()
+        void setHitCallback(std::function<void(const std::vector<ParticleHitEvent>&)> callback) { m_hitCallback = std::move(callback); }
+
+        // Update particle positions, life, etc.
+        void update(float deltaTime);
+
+        // Output of the last update(); empty under external integration
+        ParticleRenderView getRenderView() const;
+
+        // Simulated seconds since construction (drives shader animation)
+        float getElapsedTime() const { return static_cast<float>(m_elapsedTime); }
+
+    private:
+        size_t acquireSlots(size_t count); // Pops up to 'count' free slots into m_spawnSlots
+        void spawnFromEmitter(ParticleEmitter& emitter, int32_t emitterIndex, size_t count);
+        size_t reserveExternalSlots(size_t count); // Clamps to the integrator's free room
+        void stageExternalSpawns(ParticleEmitter& emitter, int32_t emitterIndex, size_t count);
+        void releaseExternalBudgets();
+        void sortVisibleSlots(); // Fills m_sortedSlots from m_visibleSlots, far to near
+        void simulateStep(float deltaTime);
+        void emitVisible(); // Culls, sorts and fills m_vertexData at the interpolated positions
+        uint64_t emitterSeed(int32_t emitterIndex) const;
+        void collideLiveParticles();
+
+        size_t m_maxParticles;
+        std::vector<Particle> m_particles; // Pool of all particles
+        std::vector<float> m_vertexData; // Render view storage (pos + color + life)
+        std::vector<uint32_t> m_freeSlots; // Stack of dead particle indices
+        std::vector<uint32_t> m_spawnSlots; // Scratch: slots claimed by the current batch
+        size_t m_activeParticleCount = 0; // Live particles
+        size_t m_emittedParticleCount = 0; // Live and inside the frustum
+        double m_elapsedTime = 0.0;
+
+        // Budget / culling
+        ParticleBudgetManager m_budget;
+        Frustum m_frustum;
+        glm::vec3 m_cameraPosition{0.0f};
+        glm::vec3 m_cameraForward{0.0f, 0.0f, -1.0f};
+        bool m_hasCamera = false;
+        float m_lastUpdateMs = 0.0f;
+        float m_lastRenderMs = 0.0f;
+
+        // Collision
+        ParticleCollider m_collider;
+        bool m_collisionEnabled = false;
+        ParticlePositionStream m_liveStream; // Filled by the step loop while collision is on
+        std::vector<ParticleCollisionResponse> m_collisionResponses; // Per emitter
+        std::vector<ParticleHitEvent> m_hitEvents;
+        std::function<void(const std::vector<ParticleHitEvent>&)> m_hitCallback;
+
+        // Depth sorting
+        std::vector<uint32_t> m_visibleSlots; // Slots emitted this frame, pool order
+        std::vector<uint32_t> m_sortedSlots;  // Same slots, back to front
+        std::vector<uint32_t> m_sortKeys;
+        std::vector<uint32_t> m_sortOrder;
+        std::vector<uint32_t> m_sortScratch;
+        std::vector<uint32_t> m_slotStamp;    // Per-slot frame marker used when reusing an order
+        RadixSorter m_sorter;
+        bool m_sortEnabled = false;
+        bool m_hasSortedOrder = false;
+        bool m_sortReused = false;
+        uint32_t m_sortFrame = 0;
+        double m_sortTime = 0.0;              // m_elapsedTime of the last full sort
+        glm::vec3 m_sortCameraPosition{0.0f};
+        glm::vec3 m_sortCameraForward{0.0f};
+
+        std::vector<ParticleEmitter> m_emitters;
+        ParticleEmitter m_burstEmitter; // Backs the loose spawnBurst() API
+        uint64_t m_seed; // Base of per-emitter seeds
+
+        // Fixed timestep
+        float m_fixedTimestep = 0.0f; // 0 = variable
+        int m_maxSubSteps = 8;
+        double m_timeAccumulator = 0.0;
+        float m_interpolationAlpha = 1.0f;
+        int m_lastStepCount = 0;
+
+        // External integration (empty handler when simulating on the CPU)
+        struct BudgetRelease {
+            int32_t emitter; // -1 for loose spawns: frees pool room only
+            float time;   // When the whole batch is guaranteed dead
+            size_t count;
+        };
+        ParticleStepHandler m_stepHandler;
+        std::vector<ParticleSpawnRecord> m_externalSpawns; // Staged for the next step
+        std::vector<Particle> m_externalStaging;
+        std::vector<uint32_t> m_externalSlots; // Identity slots into m_externalStaging
+        std::vector<BudgetRelease> m_budgetReleases;
+        float m_externalClock = 0.0f;
+        size_t m_externalLive = 0; // Upper bound on particles alive in the integrator
+    };
+
+} // namespace TurtleEngine
@@ -1,64 +1,56 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <glm/gtc/random.hpp>
 #include <vector>
 #include <memory>
-#include <chrono>
-#include "Shader.hpp" // Include shader class header
+#include <string>
+#include "ParticleSimulation.hpp"
+#include "ParticleRenderer.hpp"
+#include "GpuParticleSimulator.hpp"
 
 namespace TurtleEngine {
 
-    // Represents a single particle
-    struct Particle {
-        glm::vec3 position{0.0f};
-        glm::vec3 velocity{0.0f};
-        glm::vec4 color{1.0f, 1.0f, 0.0f, 1.0f}; // Default yellow spark color
-        float life = 0.0f; // Remaining life time in seconds
-        float initialLife = 0.0f; // Store initial lifetime for normalization
+    class Grid;
 
-        Particle() = default; // Needed for vector resizing
-        Particle(glm::vec3 pos, glm::vec3 vel, glm::vec4 col, float currentLife, float initLife) 
-            : position(pos), velocity(vel), color(col), life(currentLife), initialLife(initLife) {}
+    // Where particle state lives and is integrated
+    enum class ParticleBackend {
+        CPU,                   // Simulated on the CPU, live set uploaded every frame
+        GPU_TRANSFORM_FEEDBACK // Simulated in GPU buffers, only new spawns are uploaded
     };
 
-    // Manages simulation, buffering, and rendering of particles
-    class ParticleSystem {
+    // ParticleSimulation plus its GL side: a ParticleRenderer for the CPU backend or a
+    // GpuParticleSimulator that takes over integration. Code that only simulates (tests,
+    // benchmarks, servers) can use ParticleSimulation directly without a GL context.
+    class ParticleSystem : public ParticleSimulation {
     public:
         ParticleSystem(size_t maxParticles = 1000);
-        ~ParticleSystem();
+        ParticleSystem(const ParticleSystem&) = delete; // The GPU step handler points back at this
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
 
         // Load shaders and initialize buffers
-        bool initialize(const std::string& vertexShaderPath = "shaders/particle.vert", 
+        bool initialize(const std::string& vertexShaderPath = "shaders/particle.vert",
                         const std::string& fragmentShaderPath = "shaders/particle.frag");
 
-        // Spawn a single particle
-        void spawnParticle(const Particle& particleProperties);
-        
-        // Spawn multiple particles (e.g., for an explosion)
-        void spawnBurst(int count, glm::vec3 origin, float initialSpeed, float lifetime, glm::vec4 color);
+        // Select the simulation backend; call before initialize(). If the GPU
+        // backend cannot be created, initialize() falls back to CPU.
+        void setBackend(ParticleBackend backend);
+        ParticleBackend getBackend() const { return m_gpu ? ParticleBackend::GPU_TRANSFORM_FEEDBACK : ParticleBackend::CPU; }
 
-        // Update particle positions, life, etc.
-        void update(float deltaTime);
+        // GPU backend only: copy the live set back (stalls, for tests/debugging)
+        size_t readBackGpuParticles(std::vector<GpuParticle>& out);
+
+        // Collide with the floor covered by 'grid' (centred on the origin at y = 0)
+        void setCollisionGround(const Grid& grid);
 
         // Render active particles
-        void render(const glm::mat4& view, const glm::mat4& projection);
+        void render(const glm::mat4& projection, const glm::mat4& view);
 
     private:
-        void createBuffers();
-        void updateBuffers(); // Update VBO with active particle data
-        int findUnusedParticle(); // Find an inactive particle index
-
-        size_t m_maxParticles;
-        std::vector<Particle> m_particles; // Pool of all particles
-        std::vector<float> m_particleBufferData; // Data to upload to VBO (pos + color)
-        size_t m_lastUsedParticle = 0; // Optimization for finding unused particles
+        void integrateOnGpu(const std::vector<ParticleSpawnRecord>& spawns, float deltaTime);
 
-        // Rendering resources
-        Shader m_shader;
-        GLuint m_VAO = 0;
-        GLuint m_VBO = 0;
+        ParticleRenderer m_renderer;
+        std::unique_ptr<GpuParticleSimulator> m_gpu; // Null when simulating on the CPU
         bool m_initialized = false;
     };
 
-} // namespace TurtleEngine 
\ No newline at end of file
+} // namespace TurtleEngine
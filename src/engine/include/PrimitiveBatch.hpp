@@ -0,0 +1,78 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GLStateCache.hpp"
+#include "UniformCache.hpp"
+
+namespace TurtleEngine {
+
+enum class PrimitiveShape : uint8_t {
+    TRIANGLE = 0,
+    RECTANGLE,
+    CIRCLE,
+    COUNT
+};
+
+// A unit shape's static geometry: vec3 positions at attribute 0, optionally indexed
+struct PrimitiveShapeGeometry {
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0; // 0 = glDrawArrays
+    GLenum mode = GL_TRIANGLES;
+    GLsizei count = 0;      // Vertices, or indices when indexed
+};
+
+// Queues 2D shapes as instances (position, rotation, scale, colour) and draws them
+// with one instanced call per run of equal sort keys. The key orders by layer, then
+// blend state (opaque before translucent), then shape; within a key, submission order
+// is kept. Shapes of different types in the same layer may be reordered relative to
+// each other, so put anything that must overlap in a fixed order on its own layer.
+class PrimitiveBatch {
+public:
+    PrimitiveBatch() = default;
+    ~PrimitiveBatch();
+    PrimitiveBatch(const PrimitiveBatch&) = delete;
+    PrimitiveBatch& operator=(const PrimitiveBatch&) = delete;
+
+    // 'program' must take the instance attributes (see Renderer::submitShaders)
+    bool initialize(GLuint program, const PrimitiveShapeGeometry (&shapes)[static_cast<size_t>(PrimitiveShape::COUNT)]);
+    void cleanup();
+
+    void add(PrimitiveShape shape, const glm::vec2& position, float rotation, const glm::vec2& scale,
+             const glm::vec4& color, uint16_t layer = 0);
+
+    // Draws and empties the queue; returns the number of draw calls issued. Program,
+    // VAO and blend changes go through 'state'. Translucent runs blend with
+    // GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA; blending is left as the last run set it.
+    size_t flush(const glm::mat4& view, const glm::mat4& projection, GLStateCache& state);
+
+    size_t getPendingCount() const { return m_instances.size(); }
+
+private:
+    struct Instance {
+        float position[2];
+        float scale[2];
+        float rotation[2]; // cos, sin
+        float color[4];
+    };
+
+    void growInstanceBuffer(size_t count);
+    void pointInstanceAttributes(size_t firstInstance);
+
+    GLuint m_program = 0;
+    UniformHandle<glm::mat4> m_view;
+    UniformHandle<glm::mat4> m_projection;
+    PrimitiveShapeGeometry m_shapes[static_cast<size_t>(PrimitiveShape::COUNT)];
+    GLuint m_vaos[static_cast<size_t>(PrimitiveShape::COUNT)] = {};
+    GLuint m_instanceBuffer = 0;
+    size_t m_instanceCapacity = 0;
+
+    std::vector<Instance> m_instances;
+    std::vector<uint64_t> m_keys; // Sort key in the high 32 bits, submission index in the low 32
+    std::vector<Instance> m_sorted;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+
+namespace TurtleEngine {
+
+struct ProgramCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t rejected = 0;        // Stored binaries the driver refused (counted in misses too)
+    size_t stores = 0;
+    double loadMilliseconds = 0.0;    // Spent loading hits
+    double compileMilliseconds = 0.0; // Spent compiling misses
+    double savedMilliseconds = 0.0;   // Recorded compile time of every hit, minus its load time
+};
+
+// On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+// Entries are keyed by a hash of the program's sources and the driver's vendor,
+// renderer and version strings, so a driver update or an edited shader simply
+// misses. A binary the driver refuses is deleted and the program is compiled as
+// usual. Each entry records how long its compile took, which is what a later hit
+// reports as saved.
+//
+// The directory comes from TURTLE_SHADER_CACHE, or "shader_cache" under the working
+// directory; an empty directory, or a driver without binary formats, disables the
+// cache and every program is compiled.
+class ProgramCache {
+public:
+    static ProgramCache& shared();
+
+    ProgramCache();
+
+    void setDirectory(const std::string& directory);
+    const std::string& getDirectory() const { return m_directory; }
+    // Needs a current GL context
+    bool isEnabled();
+
+    // Returns a linked program for 'sources': from the cache, or else by running
+    // 'build', which compiles, attaches and links into the program it is given and
+    // returns false on failure (the program is then deleted and 0 returned).
+    GLuint getProgram(std::initializer_list<const std::string*> sources, const std::function<bool(GLuint program)>& build);
+
+    // The same steps for callers that link asynchronously: lookup() returns the
+    // cached program or 0 (counting the hit or miss), createProgram() makes an empty
+    // program whose binary can be retrieved, and store() saves it once linked.
+    GLuint lookup(std::initializer_list<const std::string*> sources);
+    GLuint createProgram();
+    void store(std::initializer_list<const std::string*> sources, GLuint program, double compileMilliseconds);
+
+    const ProgramCacheStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = ProgramCacheStats(); }
+    // One line, e.g. "Shader cache: 3 hits, 1 miss, 41.2 ms saved"
+    std::string describeStats() const;
+
+private:
+    uint64_t makeKey(std::initializer_list<const std::string*> sources);
+    std::string pathFor(uint64_t key) const;
+    GLuint load(uint64_t key);
+    void write(uint64_t key, GLuint program, double compileMilliseconds);
+
+    std::string m_directory;
+    int m_supported = -1;   // Unknown until the first call with a context
+    std::string m_driver;   // Vendor, renderer and version, part of every key
+    ProgramCacheStats m_stats;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TurtleEngine {
+
+    class JobSystem;
+
+    // Maps a float to a uint32 whose unsigned order matches the float order
+    inline uint32_t floatToSortableKey(float value) {
+        union { float f; uint32_t u; } bits;
+        bits.f = value;
+        return (bits.u & 0x80000000u) ? ~bits.u : (bits.u | 0x80000000u);
+    }
+
+    // Stable LSD radix sort on 32-bit keys, 8 bits per pass. Key and index are
+    // packed into one 64-bit item so each pass streams a single array, and passes
+    // whose digit is the same for every key are skipped. Large inputs split into
+    // per-thread chunks with their own histograms when a JobSystem is given.
+    // Scratch memory is kept between calls.
+    class RadixSorter {
+    public:
+        static constexpr size_t PARALLEL_THRESHOLD = 32 * 1024; // Items below this sort on one thread
+
+        // Writes into 'order' the indices 0..count-1 sorted by ascending key
+        void sort(const uint32_t* keys, size_t count, std::vector<uint32_t>& order, JobSystem* jobs = nullptr);
+
+    private:
+        std::vector<uint64_t> m_items;
+        std::vector<uint64_t> m_scratch;
+        std::vector<uint32_t> m_histograms; // 256 counters per chunk
+    };
+
+} // namespace TurtleEngine
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "GLStateCache.hpp"
+#include "RadixSort.hpp"
+#include "UniformCache.hpp"
+
+namespace TurtleEngine {
+
+class JobSystem;
+
+// Passes execute in this order
+enum class RenderPass : uint8_t {
+    SOLID = 0,
+    TRANSLUCENT = 1,
+    OVERLAY = 2
+};
+
+// 64-bit sort key, most significant first:
+//   SOLID / OVERLAY: pass 4 | shader 12 | material 16 | depth 32 (near to far)
+//   TRANSLUCENT:     pass 4 | depth 32 (far to near) | shader 12 | material 16
+// Solid work is grouped by state with depth as the tie-break; translucent work
+// must blend back to front, so depth outranks state there. 'shader' and 'material'
+// are usually GL object names; only their low bits are kept.
+uint64_t makeRenderKey(RenderPass pass, uint32_t shader, uint32_t material, float depth);
+
+struct RenderState {
+    bool blend = false;
+    GLenum blendSource = GL_SRC_ALPHA; // Factors are only applied when blend is set
+    GLenum blendDestination = GL_ONE_MINUS_SRC_ALPHA;
+    bool depthTest = true;
+    bool depthWrite = true;
+};
+
+struct RenderTexture {
+    GLenum target = GL_TEXTURE_2D;
+    GLuint texture = 0; // 0 leaves the unit alone
+};
+
+// One draw packet. Everything it needs is recorded up front so packets from
+// different systems can be sorted together and executed with minimal state changes.
+struct RenderCommand {
+    static constexpr int MAX_TEXTURES = 4;
+
+    uint64_t key = 0;
+    GLuint program = 0;
+    GLuint vertexArray = 0;
+    RenderTexture textures[MAX_TEXTURES]; // Bound to units 0..MAX_TEXTURES-1
+    RenderState state;
+
+    GLenum mode = GL_TRIANGLES;
+    GLsizei count = 0;
+    GLint first = 0;           // First vertex, or first index when indexed
+    GLenum indexType = 0;      // 0 = glDrawArrays, else the element type of the bound EBO
+    GLsizei instanceCount = 1;
+
+    // Systems that still draw themselves; the backend forgets its tracked state afterwards
+    std::function<void()> callback;
+
+    // Range in the queue's uniform list, filled by RenderQueue::setUniform
+    uint32_t uniformBegin = 0;
+    uint32_t uniformCount = 0;
+};
+
+struct RenderQueueStats {
+    size_t commands = 0;
+    size_t draws = 0;
+    size_t callbacks = 0;
+    size_t uniformUploads = 0;
+    size_t uniformsSkipped = 0; // Same value already set on that program this frame
+    GLStateStats state;         // Binds and toggles issued / avoided
+};
+
+// Packets recorded by one thread. Recording makes no GL calls, so lists can be
+// filled concurrently (one list per thread) and handed to a RenderQueue.
+class RenderCommandList {
+public:
+    // The returned command is valid until the next submit
+    RenderCommand& submit(uint64_t key);
+    void submitCallback(uint64_t key, std::function<void()> callback);
+
+    // Attach a uniform value to the most recently submitted command
+    void setUniform(GLint location, int value);
+    void setUniform(GLint location, float value);
+    void setUniform(GLint location, const glm::vec2& value);
+    void setUniform(GLint location, const glm::vec3& value);
+    void setUniform(GLint location, const glm::vec4& value);
+    void setUniform(GLint location, const glm::mat3& value);
+    void setUniform(GLint location, const glm::mat4& value);
+    template <typename T>
+    void setUniform(const UniformHandle<T>& handle, const T& value) { setUniform(handle.location, value); }
+
+    void clear();
+    size_t size() const { return m_commands.size(); }
+
+private:
+    friend class RenderQueue;
+
+    enum class UniformType : uint8_t { INT, FLOAT, VEC2, VEC3, VEC4, MAT3, MAT4 };
+    struct UniformValue {
+        GLint location;
+        UniformType type;
+        uint32_t offset; // Into m_uniformData
+    };
+
+    void appendUniform(GLint location, UniformType type, const float* data, size_t floats);
+
+    std::vector<RenderCommand> m_commands;
+    std::vector<UniformValue> m_uniforms;
+    std::vector<float> m_uniformData;
+};
+
+// Retained command buffer. Systems submit packets during the frame, either directly
+// (the queue is itself a command list) or from jobs through recordParallel().
+// execute() merges the lists, radix-sorts the packets by key (stable, so equal keys
+// keep submission order) and runs them through a GLStateCache. Only execute() talks
+// to GL. The cache starts each execute() unknown, so state left behind by
+// immediate-mode code is never trusted.
+class RenderQueue : public RenderCommandList {
+public:
+    // Runs record(list, begin, end) over [0, count) on the job system, each batch
+    // into its own command list. Lists are merged in call order, then index order,
+    // so the result does not depend on which thread ran which batch. Blocks until
+    // recording is done.
+    void recordParallel(JobSystem& jobs, size_t count, size_t minBatch,
+                        const std::function<void(RenderCommandList&, size_t, size_t)>& record);
+
+    // Sorts, draws and empties the queue and every recorded list
+    void execute();
+    void clear();
+
+    size_t size() const;
+    const RenderQueueStats& getLastStats() const { return m_stats; }
+
+private:
+    struct CommandRef {
+        const RenderCommandList* list;
+        uint32_t index;
+    };
+    struct RecordedList {
+        RenderCommandList list;
+        size_t call = 0;  // Which recordParallel() this frame
+        size_t begin = 0; // First index of the batch that filled it
+    };
+    struct UploadedValue {
+        const float* data;
+        RenderCommandList::UniformType type;
+    };
+
+    void gather(const RenderCommandList& list);
+    void uploadUniforms(const RenderCommandList& list, const RenderCommand& command);
+    void draw(const RenderCommandList& list, const RenderCommand& command);
+
+    // Lists filled by recordParallel(); kept between frames so their storage is reused
+    std::vector<std::unique_ptr<RecordedList>> m_recorded;
+    size_t m_recordedUsed = 0;
+    size_t m_recordCalls = 0;
+    std::mutex m_recordMutex;
+
+    // Sorting: two stable 32-bit passes, low word first
+    std::vector<CommandRef> m_refs;
+    std::vector<uint64_t> m_keys;
+    RadixSorter m_sorter;
+    std::vector<uint32_t> m_keyWords;
+    std::vector<uint32_t> m_lowOrder;
+    std::vector<uint32_t> m_order;
+
+    GLStateCache m_state;
+    // (program, location) -> value last uploaded this execute()
+    std::unordered_map<uint64_t, UploadedValue> m_uploaded;
+    RenderQueueStats m_stats;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TurtleEngine {
+
+// An offscreen framebuffer with an RGBA8 colour and a 24-bit depth attachment.
+// Renderer::setRenderTarget() draws into one, which is how headless runs (see
+// HeadlessContext) render without a window.
+class RenderTarget {
+public:
+    RenderTarget() = default;
+    ~RenderTarget();
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    bool initialize(int width, int height);
+    void cleanup();
+    bool isValid() const { return m_framebuffer != 0; }
+
+    // Binds the framebuffer and sets the viewport to cover it
+    void bind() const;
+
+    // Colour contents, width * height RGBA bytes with the bottom row first. Waits
+    // for rendering to finish.
+    void readPixels(std::vector<uint8_t>& pixels) const;
+    // FNV-1a over readPixels(). The same scene gives the same hash on the same
+    // driver; across drivers rasterization may differ.
+    uint64_t hashPixels() const;
+    // Binary PPM (alpha dropped), top row first
+    bool writePPM(const std::string& path) const;
+
+    GLuint getFramebuffer() const { return m_framebuffer; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    GLuint m_framebuffer = 0;
+    GLuint m_color = 0;
+    GLuint m_depth = 0;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+} // namespace TurtleEngine
@@ -8,15 +8,22 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include "UniformCache.hpp"
+#include "PrimitiveBatch.hpp"
+#include "UniformBuffer.hpp"
+#include "ShadowAtlas.hpp"
+#include "ShaderPipeline.hpp"
+#include "RenderTarget.hpp"
 
 namespace TurtleEngine {
 
+// A light's shadow projection and its tile in the renderer's shadow atlas
 struct ShadowMap {
-    GLuint depthMapFBO;
-    GLuint depthMap;
     glm::mat4 lightSpaceMatrix;
+    glm::vec4 atlasRect; // xy offset, zw scale in atlas texture coordinates; zero until assigned
     
-    ShadowMap() : depthMapFBO(0), depthMap(0), lightSpaceMatrix(1.0f) {}
+    ShadowMap() : lightSpaceMatrix(1.0f), atlasRect(0.0f) {}
 };
 
 struct Light {
@@ -32,9 +39,11 @@ struct Light {
 
 class Renderer {
 public:
-    static const int MAX_LIGHTS = 8;
-    static const int SHADOW_WIDTH = 1024;
-    static const int SHADOW_HEIGHT = 1024;
+    // Lights are shaded through LightClusters; the first MAX_SHADOWED_LIGHTS get
+    // shadow atlas tiles
+    static const int MAX_LIGHTS = static_cast<int>(LightClusters::MAX_LIGHTS);
+    static const int MAX_SHADOWED_LIGHTS = MAX_BLOCK_LIGHTS;
+    static const int SHADOW_ATLAS_SIZE = ShadowAtlas::DEFAULT_SIZE;
 
     Renderer();
     ~Renderer();
@@ -44,11 +53,29 @@ public:
     void clear();
     void setClearColor(const glm::vec4& color);
     
+    // Draw into an offscreen target instead of the default framebuffer (nullptr
+    // switches back). Binds it and sizes the viewport now; clear() binds it again each
+    // frame in case another pass left a different framebuffer bound.
+    void setRenderTarget(const RenderTarget* target);
+    const RenderTarget* getRenderTarget() const { return renderTarget; }
+    
     // Basic rendering functions
     void drawTriangle(const glm::vec2& position, float rotation, const glm::vec2& scale, const glm::vec4& color);
     void drawRectangle(const glm::vec2& position, float rotation, const glm::vec2& scale, const glm::vec4& color);
     void drawCircle(const glm::vec2& position, float radius, const glm::vec4& color);
     
+    // Batching: while enabled the draw calls above only queue instances, and flush()
+    // draws them with one instanced call per layer/blend/shape run. Changing the
+    // camera, the shader or the batching mode flushes first.
+    void setBatching(bool enabled);
+    bool isBatching() const { return batching; }
+    void setBatchLayer(uint16_t layer) { batchLayer = layer; }
+    void flush();
+    
+    // Draw calls issued since the last reset, immediate and batched alike
+    size_t getDrawCallCount() const { return drawCalls; }
+    void resetDrawCallCount() { drawCalls = 0; }
+    
     // Camera control
     void setViewMatrix(const glm::mat4& view);
     void setProjectionMatrix(const glm::mat4& projection);
@@ -59,22 +86,37 @@ public:
     void updateLight(int index, const Light& light);
     void clearLights();
     
+    // Shadows: all lights share one atlas, with tiles sized by importance (intensity
+    // and radius against distance to the camera). renderShadowMaps() redraws only the
+    // tiles whose light or casters changed since the last call.
+    ShadowCasterId addShadowCaster(const ShadowCaster& caster);
+    void setShadowCasterTransform(ShadowCasterId id, const glm::mat4& model);
+    void removeShadowCaster(ShadowCasterId id);
+    void renderShadowMaps();
+    const ShadowAtlas& getShadowAtlas() const { return shadowAtlas; }
+    
     // Shader management
     void loadShader(const std::string& vertexPath, const std::string& fragmentPath);
-    GLuint createShader(const std::string& source, GLenum type);
-    void checkShaderCompilation(GLuint shader, const std::string& type);
+    // Compiles and links, or loads the program from the on-disk cache
+    GLuint createProgram(const std::string& vertexCode, const std::string& fragmentCode);
     void useShader(GLuint shaderProgram);
     
-    // Uniform setting
+    // Uniform setting. Locations come from a per-program cache reflected at link
+    // time; for per-frame values prefer a handle from getUniform().
     void setUniform(const std::string& name, const glm::mat4& value);
     void setUniform(const std::string& name, const glm::vec3& value);
     void setUniform(const std::string& name, const glm::vec4& value);
     void setUniform(const std::string& name, float value);
     void setUniform(const std::string& name, int value);
     
+    // Handle into the current shader, valid until that program is deleted
+    template <typename T>
+    UniformHandle<T> getUniform(const std::string& name) { return uniformsFor(currentShader).cache.handle<T>(name); }
+    
     // Test accessors
     GLuint getDefaultShader() const { return defaultShader; }
     GLuint getShadowShader() const { return shadowShader; }
+    GLuint getBatchShader() const { return batchShader; }
     GLuint getTriangleVAO() const { return triangleVAO; }
     GLuint getRectangleVAO() const { return rectangleVAO; }
     GLuint getCircleVAO() const { return circleVAO; }
@@ -83,13 +125,39 @@ public:
     const glm::mat4& getProjectionMatrix() const { return projectionMatrix; }
 
 private:
-    void initShaders();
+    // Handles the renderer itself sets, resolved once per program
+    struct ProgramUniforms {
+        UniformCache cache;
+        UniformHandle<glm::mat4> model;
+        UniformHandle<glm::mat4> view;
+        UniformHandle<glm::mat4> projection;
+        UniformHandle<glm::mat4> lightSpaceMatrix;
+        UniformHandle<glm::vec4> color;
+    };
+
+    ProgramUniforms& uniformsFor(GLuint program);
+    GLint uniformLocation(const std::string& name);
+
+    // Built-in programs, submitted before the shapes are built and resolved after
+    struct PendingShaders {
+        ProgramHandle defaultShader;
+        ProgramHandle shadowShader;
+        ProgramHandle batchShader;
+    };
+    PendingShaders submitShaders();
+    void resolveShaders(const PendingShaders& pending);
     void initShapes();
+    void initBatch();
+    
+    static constexpr int CIRCLE_SEGMENTS = 32;
     
     // Shader programs
     GLuint defaultShader;
     GLuint shadowShader;
+    GLuint batchShader;
     GLuint currentShader;  // Currently active shader program
+    std::unordered_map<GLuint, ProgramUniforms> programUniforms; // Nodes are stable, so pointers stay valid
+    ProgramUniforms* currentUniforms = nullptr;
     
     // Vertex arrays and buffers
     GLuint triangleVAO;
@@ -100,25 +168,36 @@ private:
     GLuint circleVAO;
     GLuint circleVBO;
     
+    // Instanced shape batching
+    PrimitiveBatch batch;
+    GLStateCache batchState; // Binds and toggles issued by batch flushes
+    bool batching = false;
+    uint16_t batchLayer = 0;
+    size_t drawCalls = 0;
+    
     // Matrices
     glm::mat4 viewMatrix;
     glm::mat4 projectionMatrix;
     
     // State
     glm::vec4 clearColor;
+    const RenderTarget* renderTarget = nullptr; // Not owned
     
     // Lighting
     std::vector<Light> lights;
+    std::vector<LightData> lightData; // Staging for uploadLights()
+    ShadowAtlas shadowAtlas;
     
     // Helper functions
     std::vector<float> generateCircleVertices(int segments);
     
     // Shadow mapping
-    void initShadowMap(Light& light);
-    void renderShadowMaps();
-    void renderSceneToShadowMap(const Light& light);
     glm::mat4 calculateLightSpaceMatrix(const Light& light);
-    void setLightingUniforms();
+    float shadowImportance(const Light& light, const glm::vec3& cameraPosition) const;
+    // Lights live in FrameUniforms (UniformBuffer.hpp), the shared Lights block and
+    // the light clusters: uploaded once when they change, not per program switch
+    void uploadLights();
+    void bindShadowMaps();
 };
 
 } // namespace TurtleEngine 
\ No newline at end of file
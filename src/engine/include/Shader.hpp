@@ -3,6 +3,8 @@
 #include <string>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include "UniformCache.hpp"
+#include "ShaderPipeline.hpp"
 
 namespace TurtleEngine {
 
@@ -12,6 +14,17 @@ public:
     ~Shader();
 
     bool loadFromFiles(const std::string& vertexPath, const std::string& fragmentPath);
+    // loadFromFiles in two halves, so the driver compiles while the caller does other
+    // work: submitFromFiles only reads the files (expanding #include, see
+    // ShaderSourceCache) and queues the program with the ShaderPipeline, and
+    // finishLoading waits for it and reflects its uniforms. The current program stays
+    // in use until a new one has linked, and is kept if it fails.
+    bool submitFromFiles(const std::string& vertexPath, const std::string& fragmentPath);
+    void submitSources(const std::string& vertexCode, const std::string& fragmentCode, const std::string& label);
+    bool finishLoading();
+    bool isLoadPending() const { return m_pending.isValid(); }
+    // Whether finishLoading() would return without waiting
+    bool isLoadReady() const { return m_pending.isReady(); }
     void use();
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
@@ -19,8 +32,15 @@ public:
     void setVec3(const std::string& name, const glm::vec3& value) const;
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+    // Resolve once (after loading), then set per frame with handle.set(value)
+    template <typename T>
+    UniformHandle<T> getUniform(const std::string& name) const { return m_uniforms.handle<T>(name); }
+    const UniformCache& getUniforms() const { return m_uniforms; }
+    unsigned int getProgram() const { return m_program; }
+
 private:
     unsigned int m_program;
-    bool checkCompileErrors(unsigned int shader, const std::string& type);
+    UniformCache m_uniforms; // Reflected at link time; the name setters look up here
+    ProgramHandle m_pending; // Submitted and not yet finished
 };
 } 
\ No newline at end of file
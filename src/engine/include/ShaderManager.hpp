@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Shader.hpp"
+
+namespace TurtleEngine {
+
+using ShaderId = uint32_t;
+constexpr ShaderId INVALID_SHADER = 0xFFFFFFFFu;
+
+struct ShaderReloadStats {
+    size_t changedFiles = 0;
+    size_t reloads = 0;        // Programs rebuilt and swapped in
+    size_t failedReloads = 0;  // Kept the old program (read, compile or link error)
+};
+
+// Shader programs that rebuild themselves when their files change. Sources go
+// through the ShaderSourceCache, so editing a shared include reloads every program
+// that uses it. The directories of all those files are watched with inotify on
+// Linux; elsewhere, or if inotify is unavailable, file times are polled instead.
+//
+// Call update() once a frame on the GL thread. Changed programs are resubmitted to
+// the ShaderPipeline and keep drawing with their current program while the driver
+// compiles; the new one replaces it between frames once it has linked, and a
+// failed build leaves the old program in place. Uniform handles taken from a
+// reloaded Shader are stale; the reload callback is the place to take them again.
+class ShaderManager {
+public:
+    static ShaderManager& shared();
+
+    ShaderManager();
+    ~ShaderManager();
+    ShaderManager(const ShaderManager&) = delete;
+    ShaderManager& operator=(const ShaderManager&) = delete;
+
+    // Loads now (waiting for the link) and starts watching; INVALID_SHADER on failure
+    ShaderId load(const std::string& vertexPath, const std::string& fragmentPath);
+    // load() in two halves, as Shader::submitFromFiles/finishLoading. submit() fails
+    // only if the files cannot be read; finish() reports whether the program linked.
+    ShaderId submit(const std::string& vertexPath, const std::string& fragmentPath);
+    bool finish(ShaderId id);
+    Shader& get(ShaderId id) { return *m_entries[id].shader; }
+    // Deletes the program and stops reloading it; the id is not reused
+    void release(ShaderId id);
+
+    void update();
+    // Releases everything; call before the GL context goes away
+    void cleanup();
+
+    void setReloadCallback(std::function<void(ShaderId)> callback) { m_onReload = std::move(callback); }
+    const ShaderReloadStats& getStats() const { return m_stats; }
+    bool isUsingInotify() const { return m_inotifyFd >= 0; }
+
+private:
+    struct Entry {
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::unique_ptr<Shader> shader;
+        std::vector<std::string> files;        // What the live program was built from
+        std::vector<std::string> pendingFiles; // What the build in flight reads
+        bool loaded = false; // First build finished and linked
+        bool dirty = false;
+    };
+
+    bool readSources(const Entry& entry, std::string& vertexCode, std::string& fragmentCode, std::vector<std::string>& files);
+    void watch(const std::vector<std::string>& files);
+    std::vector<std::string> takeChangedFiles();
+
+    std::vector<Entry> m_entries;
+    std::function<void(ShaderId)> m_onReload;
+    ShaderReloadStats m_stats;
+
+    int m_inotifyFd = -1;
+    std::unordered_map<int, std::string> m_watchedDirectories; // Watch descriptor -> directory
+    // Polling fallback
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_fileTimes;
+    std::chrono::steady_clock::time_point m_lastPoll;
+};
+
+} // namespace TurtleEngine
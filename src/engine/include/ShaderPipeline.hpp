@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TurtleEngine {
+
+enum class ProgramStatus {
+    Compiling,
+    Ready,
+    Failed
+};
+
+// A program submitted to the ShaderPipeline and not yet known to have linked
+struct PendingProgram {
+    GLuint program = 0;
+    GLuint vertex = 0;
+    GLuint fragment = 0;
+    std::string label;
+    std::string vertexCode;   // Kept until linked, for the program cache key
+    std::string fragmentCode;
+    ProgramStatus status = ProgramStatus::Compiling;
+    std::chrono::steady_clock::time_point submitted;
+    double submitMilliseconds = 0.0;
+};
+
+// Program that resolves later. Copies share the same program.
+class ProgramHandle {
+public:
+    ProgramHandle() = default;
+
+    bool isValid() const { return m_state != nullptr; }
+    // Never stalls: true once linked or failed, as far as the driver can say
+    // without waiting (see ShaderPipeline::poll)
+    bool isReady() const;
+    ProgramStatus getStatus() const { return m_state ? m_state->status : ProgramStatus::Failed; }
+    // Waits for the link if needed; 0 if it failed
+    GLuint get() const;
+
+private:
+    friend class ShaderPipeline;
+    explicit ProgramHandle(std::shared_ptr<PendingProgram> state) : m_state(std::move(state)) {}
+
+    std::shared_ptr<PendingProgram> m_state;
+};
+
+// Builds programs without waiting on the driver. submit() issues the compile and
+// link calls and returns at once; nothing asks for a compile or link status until
+// the program is needed, so all startup programs can be submitted up front and
+// compile while other initialisation runs.
+//
+// With KHR_parallel_shader_compile the driver compiles on its own threads and
+// poll() resolves finished programs through GL_COMPLETION_STATUS_KHR. Without it
+// the status query itself would stall, so it is deferred until the handle's get()
+// or finish(). Programs found in the ProgramCache are ready on submit, and newly
+// linked ones are stored there.
+class ShaderPipeline {
+public:
+    static ShaderPipeline& shared();
+
+    // Needs a current GL context
+    bool hasParallelCompile();
+
+    // 'label' names the program in error messages
+    ProgramHandle submit(const std::string& vertexCode, const std::string& fragmentCode, const std::string& label);
+
+    // Resolves what has finished, deletes programs whose handles are all gone and
+    // returns how many are still compiling. ShaderManager::update() calls it once a
+    // frame; settled programs stay listed until the next call.
+    size_t poll();
+    // Resolves everything, waiting where needed
+    void finish();
+
+    size_t getPendingCount() const { return m_pending.size(); }
+
+private:
+    friend class ProgramHandle;
+    static bool isComplete(const PendingProgram& pending);
+    static void resolve(PendingProgram& pending);
+    static void release(PendingProgram& pending);
+
+    std::vector<std::shared_ptr<PendingProgram>> m_pending;
+    int m_parallel = -1; // Unknown until the first call with a context
+};
+
+} // namespace TurtleEngine
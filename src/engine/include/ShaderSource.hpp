@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TurtleEngine {
+
+struct ShaderSourceStats {
+    size_t fileReads = 0;
+    size_t cacheHits = 0;
+};
+
+// Reads shader files and expands `#include "path"` lines, with the path relative
+// to the including file. Raw file contents are cached until invalidate(), so
+// reloading a program after one include changed reads only that file.
+//
+// Each expanded file is bracketed with #line directives whose source-string number
+// is its index in 'files' (0 is the top-level file), so "2:14(3)" in a driver log
+// means line 14 of files[2]. Include cycles and missing files fail the load.
+class ShaderSourceCache {
+public:
+    static ShaderSourceCache& shared();
+
+    // 'files' receives every file the result depends on, top-level first, as
+    // normalised paths (see normalize)
+    bool load(const std::string& path, std::string& source, std::vector<std::string>& files);
+
+    void invalidate(const std::string& path);
+    void clear() { m_files.clear(); }
+
+    const ShaderSourceStats& getStats() const { return m_stats; }
+
+    static std::string normalize(const std::string& path);
+
+private:
+    const std::string* read(const std::string& path);
+    bool expand(const std::string& path, std::string& out, std::vector<std::string>& files, std::vector<std::string>& stack);
+
+    std::unordered_map<std::string, std::string> m_files;
+    ShaderSourceStats m_stats;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "UniformCache.hpp"
+
+namespace TurtleEngine {
+
+// Depth-only geometry: vec3 positions at attribute 0
+struct ShadowCaster {
+    GLuint vao = 0;
+    GLenum mode = GL_TRIANGLES;
+    GLsizei count = 0;
+    GLenum indexType = 0;      // 0 = glDrawArrays
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 boundsMin = glm::vec3(0.0f); // Model-space AABB, used to find the lights it affects
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    bool isStatic = true;      // Static casters are cached; dynamic ones are redrawn when they move
+};
+
+using ShadowCasterId = uint32_t;
+constexpr ShadowCasterId INVALID_SHADOW_CASTER = 0xFFFFFFFFu;
+
+// What update() needs to know about a light
+struct ShadowLightView {
+    glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
+    float importance = 1.0f;   // Relative; decides the tile size
+};
+
+struct ShadowAtlasStats {
+    size_t staticTiles = 0;    // Tiles whose static layer was re-rendered
+    size_t composedTiles = 0;  // Tiles rebuilt from the static cache plus dynamic casters
+    size_t reusedTiles = 0;    // Tiles left untouched
+    size_t casterDraws = 0;
+};
+
+// All shadow maps in one depth texture. Every light gets a square, power-of-two tile
+// sized by its importance relative to the most important light; when the tiles do
+// not fit, all of them shrink a level, down to MIN_TILE_SIZE.
+//
+// Two depth textures of the atlas size are kept: a cache holding only static
+// casters, and the sampled atlas. A tile's static layer is re-rendered only when
+// its light moves, its tile moves or a static caster inside its frustum changes.
+// When only dynamic casters inside the frustum move, the tile is copied from the
+// cache and the dynamic casters are drawn over it. Tiles with no change in view are
+// not touched, so the cost follows what changed in the scene, not the light count.
+class ShadowAtlas {
+public:
+    static constexpr int DEFAULT_SIZE = 2048;
+    static constexpr int MIN_TILE_SIZE = 128;
+
+    ShadowAtlas() = default;
+    ~ShadowAtlas();
+    ShadowAtlas(const ShadowAtlas&) = delete;
+    ShadowAtlas& operator=(const ShadowAtlas&) = delete;
+
+    // 'depthProgram' takes positions at attribute 0 and mat4 uniforms lightSpaceMatrix
+    // and model. 'size' must be a power of two of at least 2 * MIN_TILE_SIZE.
+    bool initialize(GLuint depthProgram, int size = DEFAULT_SIZE);
+    void cleanup();
+
+    ShadowCasterId addCaster(const ShadowCaster& caster);
+    void setCasterTransform(ShadowCasterId id, const glm::mat4& model);
+    void removeCaster(ShadowCasterId id);
+    size_t getCasterCount() const { return m_casterCount; }
+
+    // Assigns tiles to 'count' lights and redraws the tiles that changed. Restores the
+    // framebuffer binding, depth test, depth mask and scissor test it found; the caller
+    // restores its viewport and program.
+    void update(const ShadowLightView* lights, size_t count);
+
+    // Tile of light i in texture coordinates: xy offset, zw scale. A zero scale means
+    // the light got no tile.
+    glm::vec4 getTileRect(size_t light) const;
+    // Tile of light i in texels (0 if none)
+    int getTileSize(size_t light) const;
+
+    GLuint getTexture() const { return m_texture; }
+    int getSize() const { return m_size; }
+    const ShadowAtlasStats& getLastStats() const { return m_stats; }
+
+private:
+    struct CasterSlot {
+        ShadowCaster caster;
+        glm::vec3 worldMin;
+        glm::vec3 worldMax;
+        bool alive = false;
+    };
+
+    // World-space box whose shadows changed since the last update
+    struct DirtyRegion {
+        glm::vec3 min;
+        glm::vec3 max;
+        bool isStatic;
+    };
+
+    struct Tile {
+        int x = 0;
+        int y = 0;
+        int size = 0;          // 0 = no tile
+        int level = 0;
+        glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
+        bool staticValid = false;
+    };
+
+    void assignTiles(const ShadowLightView* lights, size_t count);
+    void markDirty(const CasterSlot& slot);
+    void drawCasters(const Tile& tile, bool isStatic);
+    void beginTile(GLuint framebuffer, const Tile& tile);
+
+    GLuint m_program = 0;
+    UniformHandle<glm::mat4> m_lightSpaceMatrix;
+    UniformHandle<glm::mat4> m_model;
+    int m_size = 0;
+    GLuint m_texture = 0;          // Static and dynamic casters; what shaders sample
+    GLuint m_framebuffer = 0;
+    GLuint m_staticTexture = 0;    // Static casters only
+    GLuint m_staticFramebuffer = 0;
+
+    std::vector<CasterSlot> m_casters;
+    std::vector<ShadowCasterId> m_freeCasters;
+    size_t m_casterCount = 0;
+    std::vector<DirtyRegion> m_dirty;
+
+    std::vector<Tile> m_tiles;
+    ShadowAtlasStats m_stats;
+};
+
+} // namespace TurtleEngine
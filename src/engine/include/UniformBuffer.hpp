@@ -0,0 +1,139 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "LightClusters.hpp"
+
+namespace TurtleEngine {
+
+// Fixed binding points shared by every program that declares the blocks.
+// Shader::loadFromFiles and the Renderer connect them after linking (GLSL 330
+// has no layout(binding = N) for blocks).
+enum UniformBlockBinding : GLuint {
+    CAMERA_BLOCK_BINDING = 0,
+    LIGHTS_BLOCK_BINDING = 1
+};
+
+// Texture units reserved for light data, wired to the lighting samplers at link
+// time like the blocks above
+enum LightTextureUnit : GLint {
+    SHADOW_ATLAS_UNIT = 12,
+    CLUSTER_LIGHTS_UNIT = 13,
+    CLUSTER_RANGES_UNIT = 14,
+    CLUSTER_INDICES_UNIT = 15
+};
+
+// std140 mirrors of the GLSL blocks. vec3s are packed into vec4s so the C++
+// layout matches without padding rules.
+//
+//   layout(std140) uniform Camera {
+//       mat4 view; mat4 projection; mat4 viewProjection; vec4 position;
+//   } camera;
+struct CameraBlock {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 position; // w = 1
+};
+static_assert(sizeof(CameraBlock) == 208, "CameraBlock must match the std140 layout");
+
+//   struct LightData { vec4 positionRadius; vec4 colorIntensity; mat4 lightSpaceMatrix; vec4 shadowRect; };
+//   layout(std140) uniform Lights {
+//       LightData lights[MAX_BLOCK_LIGHTS]; int lightCount; ivec4 clusterGrid; vec4 clusterDepth;
+//   };
+struct LightData {
+    glm::vec4 positionRadius;  // xyz position, w radius
+    glm::vec4 colorIntensity;  // rgb colour, a intensity
+    glm::mat4 lightSpaceMatrix;
+    glm::vec4 shadowRect;      // Shadow atlas tile: xy offset, zw scale; zero scale = no shadow
+};
+static_assert(sizeof(LightData) == 112, "LightData must match the std140 layout");
+
+// Lights with shadow data. Any number of lights is shaded through LightClusters;
+// the first MAX_BLOCK_LIGHTS of them also have an entry here.
+constexpr int MAX_BLOCK_LIGHTS = 8;
+
+struct LightsBlock {
+    LightData lights[MAX_BLOCK_LIGHTS];
+    int32_t lightCount = 0;          // Entries used in 'lights'
+    int32_t padding[3] = {};         // std140 aligns the ivec4 to 16 bytes
+    glm::ivec4 clusterGrid{0};       // Froxels in x, y, z; w = clustered lights (0 = none)
+    glm::vec4 clusterDepth{0.0f};    // LightClusters::getDepthParams()
+};
+static_assert(sizeof(LightsBlock) == MAX_BLOCK_LIGHTS * 112 + 48, "LightsBlock must match the std140 layout");
+
+// A GL uniform buffer attached to one binding point
+class UniformBuffer {
+public:
+    UniformBuffer() = default;
+    ~UniformBuffer();
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    bool initialize(GLuint binding, size_t size);
+    void cleanup();
+
+    // Writes [offset, offset + size) and leaves the buffer bound to its binding point
+    void update(const void* data, size_t size, size_t offset = 0);
+    void bind() const;
+
+    bool isInitialized() const { return m_buffer != 0; }
+    GLuint getBuffer() const { return m_buffer; }
+    GLuint getBinding() const { return m_binding; }
+    size_t getSize() const { return m_size; }
+
+private:
+    GLuint m_buffer = 0;
+    GLuint m_binding = 0;
+    size_t m_size = 0;
+};
+
+// The per-frame camera and light blocks. Every system that draws with the world
+// camera calls setCamera(); an unchanged camera is not re-uploaded, so in a frame
+// the first system pays for the upload and the rest only compare 128 bytes.
+// Buffers are created on first use in the current context.
+class FrameUniforms {
+public:
+    static FrameUniforms& shared();
+
+    // Connects the Camera and Lights blocks of 'program' (if it declares them) to
+    // their binding points, and its light samplers to their texture units
+    static void bindBlocks(GLuint program);
+
+    // Camera position is taken from the inverse view matrix. Light clusters are
+    // rebuilt here when the camera or the lights changed since the last build, so
+    // several light changes in a frame cost one build.
+    void setCamera(const glm::mat4& view, const glm::mat4& projection);
+    // All lights go to the clusters; the first MAX_BLOCK_LIGHTS also to the block
+    void setLights(const LightData* lights, size_t count);
+
+    const CameraBlock& getCamera() const { return m_camera; }
+    size_t getCameraUploads() const { return m_cameraUploads; }
+    size_t getLightUploads() const { return m_lightUploads; }
+    size_t getClusterBuilds() const { return m_clusterBuilds; }
+    const LightClusters& getClusters() const { return m_clusters; }
+
+    // Deletes the buffers; call before destroying the GL context
+    void cleanup();
+
+private:
+    bool ensureBuffers();
+    void updateClusters();
+
+    UniformBuffer m_cameraBuffer;
+    UniformBuffer m_lightsBuffer;
+    CameraBlock m_camera{};
+    bool m_cameraValid = false;
+    size_t m_cameraUploads = 0;
+    size_t m_lightUploads = 0;
+
+    std::vector<LightData> m_lights;
+    LightClusters m_clusters;
+    bool m_clustersDirty = false;
+    size_t m_clusterBuilds = 0;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace TurtleEngine {
+
+    inline void uploadUniform(GLint location, bool value) { glUniform1i(location, static_cast<int>(value)); }
+    inline void uploadUniform(GLint location, int value) { glUniform1i(location, value); }
+    inline void uploadUniform(GLint location, float value) { glUniform1f(location, value); }
+    inline void uploadUniform(GLint location, const glm::vec2& value) { glUniform2fv(location, 1, glm::value_ptr(value)); }
+    inline void uploadUniform(GLint location, const glm::vec3& value) { glUniform3fv(location, 1, glm::value_ptr(value)); }
+    inline void uploadUniform(GLint location, const glm::vec4& value) { glUniform4fv(location, 1, glm::value_ptr(value)); }
+    inline void uploadUniform(GLint location, const glm::mat3& value) { glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+    inline void uploadUniform(GLint location, const glm::mat4& value) { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+
+    // A uniform location resolved once, typed by the value it takes. set() is a single
+    // glUniform call on the bound program; like GL, an unresolved handle is a no-op.
+    template <typename T>
+    struct UniformHandle {
+        GLint location = -1;
+
+        bool isValid() const { return location >= 0; }
+        void set(const T& value) const { uploadUniform(location, value); }
+    };
+
+    // Every active uniform of a linked program, reflected with glGetActiveUniform.
+    // Array uniforms are listed as "name", "name[0]" .. "name[n-1]", struct array
+    // members as "lights[0].position". Lookups are hash probes; no driver queries.
+    class UniformCache {
+    public:
+        void reflect(GLuint program);
+        void clear() { m_locations.clear(); }
+
+        // -1 when the program has no such active uniform
+        GLint find(const std::string& name) const;
+        // Whether 'name' is known, as a uniform or as a recorded miss
+        bool lookup(const std::string& name, GLint& location) const;
+        void insert(const std::string& name, GLint location) { m_locations[name] = location; }
+
+        template <typename T>
+        UniformHandle<T> handle(const std::string& name) const { return UniformHandle<T>{ find(name) }; }
+
+        size_t size() const { return m_locations.size(); }
+
+    private:
+        std::unordered_map<std::string, GLint> m_locations;
+    };
+
+} // namespace TurtleEngine
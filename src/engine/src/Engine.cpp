@@ -1,5 +1,9 @@
 #include <GL/glew.h>
 #include "Engine.hpp"
+#include "FrameProfiler.hpp"
+#include "RenderQueue.hpp"
+#include "JobSystem.hpp"
+#include "ShaderManager.hpp"
 #include <iostream>
 #include <numeric>
 #include <iomanip>
@@ -75,6 +79,7 @@ bool Engine::initialize(const std::string& title, int width, int height) {
         // Create renderer
         renderer = new Renderer();
         renderer->init();
+        FrameProfiler::shared().initialize(); // CPU zones work even if this fails
         
         // Create input manager
         inputManager = new InputManager(window->getHandle());
@@ -96,12 +101,19 @@ void Engine::run() {
     m_isRunning = true; // Ensure isRunning is set
     logToFile("Engine run loop started.");
 
+    // Particles step at a fixed rate so frame hitches do not change trajectories
+    if (m_particleSystem) {
+        m_particleSystem->setFixedTimestep(1.0f / 60.0f);
+    }
+
     while (m_isRunning && !window->shouldClose()) {
+        FrameProfiler::shared().beginFrame();
         auto currentTime = std::chrono::high_resolution_clock::now();
         m_performance.deltaTime = std::chrono::duration<double>(currentTime - m_performance.lastFrameTime).count();
         m_performance.lastFrameTime = currentTime;
 
         glfwPollEvents(); // Poll events early
+        ShaderManager::shared().update(); // Swap in shaders edited on disk
 
         if (m_automatedTestMode) {
             // --- Automated Test Logic ---
@@ -153,30 +165,54 @@ void Engine::run() {
         // Update systems regardless of mode
         updateCamera(); // Update camera based on state/input
         m_gestureRecognizer->update(); // Update Gesture Recognizer
-        m_particleSystem->update(static_cast<float>(m_performance.deltaTime));
 
-        // --- Rendering ---
-        renderer->clear();
-        renderer->drawTriangle(trianglePos, 0.0f, glm::vec2(triangleSize), triangleColor);
-
-        // Get matrices
+        // Get matrices (particles cull against them during update)
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), 
                                                 (float)800 / (float)600, 0.1f, 100.0f);
         glm::mat4 view = glm::lookAt(m_camera.position, m_camera.target, m_camera.up);
 
-        // Render Grid
+        m_particleSystem->setCamera(view, projection, m_camera.position);
+        {
+            ProfileScope zone("Particle update");
+            m_particleSystem->update(static_cast<float>(m_performance.deltaTime));
+        }
+
+        // --- Rendering ---
+        // Systems record packets; the queue sorts them by pass and state and skips
+        // redundant binds. Renderer and particles still draw themselves via callbacks.
+        if (!m_renderQueue) {
+            m_renderQueue = std::make_unique<RenderQueue>();
+        }
+        renderer->clear();
+        m_renderQueue->submitCallback(makeRenderKey(RenderPass::SOLID, 0, 0, 0.0f), [this]() {
+            renderer->useShader(renderer->getDefaultShader()); // The queue may have bound another program
+            renderer->drawTriangle(trianglePos, 0.0f, glm::vec2(triangleSize), triangleColor);
+        });
+
+        // Render Grid: chunk builds and uploads here, packet recording on the job system
         if (m_grid) {
-            m_grid->render(projection, view);
+            ProfileScope zone("Grid record");
+            const size_t chunkPackets = m_grid->prepare(projection, view);
+            m_renderQueue->recordParallel(JobSystem::shared(), chunkPackets, 16,
+                [this, &view](RenderCommandList& list, size_t begin, size_t end) {
+                    m_grid->recordChunks(list, begin, end, view);
+                });
         } else {
              logToFile("[Render] Grid is null!");
         }
 
         // Render Particles
         if (m_particleSystem) {
-             m_particleSystem->render(projection, view);
+            m_renderQueue->submitCallback(makeRenderKey(RenderPass::TRANSLUCENT, 0, 0, 0.0f), [this, &projection, &view]() {
+                m_particleSystem->render(projection, view);
+            });
         } else {
             logToFile("[Render] ParticleSystem is null!");
         }
+        {
+            ProfileScope zone("Render queue", true);
+            m_renderQueue->execute();
+        }
 
         // Update performance metrics
         updatePerformanceMetrics();
@@ -186,6 +222,7 @@ void Engine::run() {
         }
         
         // Swap buffers
+        FrameProfiler::shared().endFrame();
         window->swapBuffers();
     }
     logToFile("Engine run loop finished.");
@@ -295,12 +332,18 @@ void Engine::displayPerformanceMetrics() {
        << "Frame time (ms) - Avg: " << avgFrameTimeMs 
        << " Min: " << minFrameTimeMs 
        << " Max: " << maxFrameTimeMs;
+    // GPU time arrives a few frames late; 0 until the first frame resolves
+    if (const ProfileFrame* frame = FrameProfiler::shared().getLatestFrame()) {
+        ss << "\nGPU time (ms): " << frame->gpuMs;
+    }
     
     std::cout << "\033[2J\033[H";  // Clear console and move cursor to top
     std::cout << ss.str() << std::endl;
 }
 
 void Engine::shutdown() {
+    FrameProfiler::shared().cleanup();
+    ShaderManager::shared().cleanup();
     delete inputManager;
     delete renderer;
     delete window;
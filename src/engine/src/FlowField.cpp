@@ -0,0 +1,273 @@
+#include "FlowField.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr float DIAGONAL = 1.41421356f;
+    // Indexed by FlowField::Direction; north is -Z (cell y - 1)
+    constexpr int STEP_X[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    constexpr int STEP_Y[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+    constexpr float STEP_LENGTH[8] = { 1.0f, DIAGONAL, 1.0f, DIAGONAL, 1.0f, DIAGONAL, 1.0f, DIAGONAL };
+}
+
+FlowField::FlowField(int width, int height, float cellSize)
+    : m_width(std::max(width, 1)), m_height(std::max(height, 1)),
+      m_cellSize(cellSize > 0.0f ? cellSize : 1.0f) {
+    if (width < 1 || height < 1 || cellSize <= 0.0f) {
+        std::cerr << "ERROR::FlowField: invalid size " << width << "x" << height
+                  << " with cell size " << cellSize << std::endl;
+    }
+    m_inverseCellSize = 1.0f / m_cellSize;
+    m_origin = glm::vec2(-m_width * m_cellSize / 2.0f, -m_height * m_cellSize / 2.0f);
+
+    const size_t cells = static_cast<size_t>(m_width) * m_height;
+    m_costs.assign(cells, DEFAULT_COST);
+    m_integration.assign(cells, INFINITY);
+    m_directions.assign((cells + 1) / 2, static_cast<uint8_t>(NONE | (NONE << 4)));
+    m_visitMark.assign(cells, 0);
+}
+
+glm::ivec2 FlowField::worldToCell(const glm::vec3& position) const {
+    int x = static_cast<int>(std::floor((position.x - m_origin.x) * m_inverseCellSize));
+    int y = static_cast<int>(std::floor((position.z - m_origin.y) * m_inverseCellSize));
+    return glm::ivec2(std::clamp(x, 0, m_width - 1), std::clamp(y, 0, m_height - 1));
+}
+
+void FlowField::setCost(int x, int y, uint8_t cost) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return;
+    cost = std::max<uint8_t>(cost, 1);
+    int32_t cell = y * m_width + x;
+    if (m_costs[cell] == cost) return;
+    m_costs[cell] = cost;
+    m_changedCells.push_back(cell);
+}
+
+uint8_t FlowField::getCost(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return IMPASSABLE;
+    return m_costs[static_cast<size_t>(y) * m_width + x];
+}
+
+void FlowField::setGoals(const std::vector<glm::ivec2>& cells) {
+    m_goals.clear();
+    for (const glm::ivec2& cell : cells) {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || cell.y >= m_height) continue;
+        m_goals.push_back(cell.y * m_width + cell.x);
+    }
+    std::sort(m_goals.begin(), m_goals.end());
+    m_goals.erase(std::unique(m_goals.begin(), m_goals.end()), m_goals.end());
+    m_needsBuild = true;
+}
+
+bool FlowField::canStep(int x, int y, int direction) const {
+    int nx = x + STEP_X[direction];
+    int ny = y + STEP_Y[direction];
+    if (getCost(nx, ny) == IMPASSABLE) return false;
+    // Diagonals may not squeeze between two blocked corners or clip one
+    if (STEP_LENGTH[direction] != 1.0f) {
+        return getCost(nx, y) != IMPASSABLE && getCost(x, ny) != IMPASSABLE;
+    }
+    return true;
+}
+
+float FlowField::bestFromNeighbours(int32_t cell, int& direction) const {
+    direction = NONE;
+    if (m_costs[cell] == IMPASSABLE) return INFINITY;
+    if (std::binary_search(m_goals.begin(), m_goals.end(), cell)) {
+        direction = GOAL;
+        return 0.0f;
+    }
+    const int x = cell % m_width;
+    const int y = cell / m_width;
+    float best = INFINITY;
+    for (int d = 0; d < 8; ++d) {
+        if (!canStep(x, y, d)) continue;
+        float candidate = m_integration[cell + STEP_Y[d] * m_width + STEP_X[d]] + m_costs[cell] * STEP_LENGTH[d];
+        if (candidate < best) {
+            best = candidate;
+            direction = d;
+        }
+    }
+    return best;
+}
+
+void FlowField::integrate(std::vector<OpenEntry>& open) {
+    // 'open' is a binary heap; entries whose cost went stale are skipped when popped
+    const auto greater = std::greater<OpenEntry>();
+    std::make_heap(open.begin(), open.end(), greater);
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), greater);
+        OpenEntry current = open.back();
+        open.pop_back();
+        if (current.cost > m_integration[current.cell]) continue;
+
+        const int x = current.cell % m_width;
+        const int y = current.cell / m_width;
+        for (int d = 0; d < 8; ++d) {
+            if (!canStep(x, y, d)) continue;
+            int32_t next = current.cell + STEP_Y[d] * m_width + STEP_X[d];
+            float candidate = current.cost + m_costs[next] * STEP_LENGTH[d];
+            if (candidate < m_integration[next]) {
+                m_integration[next] = candidate;
+                if (m_visitMark[next] != m_pass) {
+                    m_visitMark[next] = m_pass;
+                    m_touched.push_back(next);
+                }
+                open.push_back({ candidate, next });
+                std::push_heap(open.begin(), open.end(), greater);
+            }
+        }
+    }
+}
+
+void FlowField::setDirection(int32_t cell, uint8_t code) {
+    uint8_t& packed = m_directions[cell >> 1];
+    const int shift = (cell & 1) * 4;
+    packed = static_cast<uint8_t>((packed & ~(0xF << shift)) | (code << shift));
+}
+
+void FlowField::refreshDirections() {
+    // A cell's step can only change if it or a neighbour was re-integrated
+    ++m_pass;
+    for (int32_t cell : m_touched) {
+        const int x = cell % m_width;
+        const int y = cell / m_width;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = x + dx, ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height) continue;
+                int32_t neighbour = ny * m_width + nx;
+                if (m_visitMark[neighbour] == m_pass) continue;
+                m_visitMark[neighbour] = m_pass;
+                int direction;
+                bestFromNeighbours(neighbour, direction);
+                if (!std::isfinite(m_integration[neighbour])) direction = NONE;
+                setDirection(neighbour, static_cast<uint8_t>(direction));
+            }
+        }
+    }
+}
+
+void FlowField::build() {
+    ++m_pass;
+    m_touched.clear();
+    std::fill(m_integration.begin(), m_integration.end(), INFINITY);
+
+    std::vector<OpenEntry> open;
+    for (int32_t goal : m_goals) {
+        if (m_costs[goal] == IMPASSABLE) continue;
+        m_integration[goal] = 0.0f;
+        open.push_back({ 0.0f, goal });
+    }
+    integrate(open);
+
+    for (int32_t cell = 0; cell < static_cast<int32_t>(m_integration.size()); ++cell) {
+        int direction;
+        bestFromNeighbours(cell, direction);
+        if (!std::isfinite(m_integration[cell])) direction = NONE;
+        setDirection(cell, static_cast<uint8_t>(direction));
+    }
+    m_lastUpdatedCells = m_integration.size();
+    m_changedCells.clear();
+    m_needsBuild = false;
+}
+
+void FlowField::update() {
+    if (m_needsBuild) {
+        build();
+        return;
+    }
+    if (m_changedCells.empty()) {
+        m_lastUpdatedCells = 0;
+        return;
+    }
+
+    ++m_pass;
+    m_touched.clear();
+    auto invalidate = [this](int32_t cell) {
+        if (m_visitMark[cell] == m_pass) return;
+        m_visitMark[cell] = m_pass;
+        m_integration[cell] = INFINITY;
+        m_touched.push_back(cell);
+    };
+
+    // Changed cells, plus neighbours whose step entered one or cut past its corner
+    for (int32_t cell : m_changedCells) {
+        invalidate(cell);
+        const int x = cell % m_width;
+        const int y = cell / m_width;
+        for (int d = 0; d < 8; ++d) {
+            int nx = x + STEP_X[d], ny = y + STEP_Y[d];
+            if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height) continue;
+            int32_t neighbour = ny * m_width + nx;
+            Direction step = getDirection(nx, ny);
+            if (step >= GOAL) continue;
+            int tx = nx + STEP_X[step], ty = ny + STEP_Y[step];
+            if ((tx == x && ty == y) || (tx == x && ny == y) || (nx == x && ty == y)) invalidate(neighbour);
+        }
+    }
+
+    // Everything downstream of an invalidated cell routed through it
+    for (size_t i = 0; i < m_touched.size(); ++i) {
+        const int x = m_touched[i] % m_width;
+        const int y = m_touched[i] / m_width;
+        for (int d = 0; d < 8; ++d) {
+            int nx = x + STEP_X[d], ny = y + STEP_Y[d];
+            if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height) continue;
+            Direction step = getDirection(nx, ny);
+            if (step < GOAL && nx + STEP_X[step] == x && ny + STEP_Y[step] == y) invalidate(ny * m_width + nx);
+        }
+    }
+
+    // Reseed the invalidated region from its valid border. Neighbours of changed cells
+    // are re-expanded too, since a cheaper or reopened cell can shorten their routes.
+    std::vector<OpenEntry> open;
+    for (int32_t cell : m_touched) {
+        int direction;
+        float cost = bestFromNeighbours(cell, direction);
+        if (std::isfinite(cost)) {
+            m_integration[cell] = cost;
+            open.push_back({ cost, cell });
+        }
+    }
+    for (int32_t cell : m_changedCells) {
+        const int x = cell % m_width;
+        const int y = cell / m_width;
+        for (int d = 0; d < 8; ++d) {
+            int nx = x + STEP_X[d], ny = y + STEP_Y[d];
+            if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height) continue;
+            int32_t neighbour = ny * m_width + nx;
+            if (m_visitMark[neighbour] != m_pass && std::isfinite(m_integration[neighbour])) {
+                open.push_back({ m_integration[neighbour], neighbour });
+            }
+        }
+    }
+    integrate(open);
+
+    m_lastUpdatedCells = m_touched.size();
+    refreshDirections();
+    m_changedCells.clear();
+}
+
+FlowField::Direction FlowField::getDirection(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return NONE;
+    size_t cell = static_cast<size_t>(y) * m_width + x;
+    return static_cast<Direction>((m_directions[cell >> 1] >> ((cell & 1) * 4)) & 0xF);
+}
+
+glm::vec2 FlowField::sampleDirection(const glm::vec3& position) const {
+    glm::ivec2 cell = worldToCell(position);
+    Direction direction = getDirection(cell.x, cell.y);
+    if (direction >= GOAL) return glm::vec2(0.0f);
+    return glm::vec2(STEP_X[direction], STEP_Y[direction]) / STEP_LENGTH[direction];
+}
+
+float FlowField::getIntegration(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return INFINITY;
+    return m_integration[static_cast<size_t>(y) * m_width + x];
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,212 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr size_t UNTIMED_ZONE = static_cast<size_t>(-1);
+
+    void writeEvent(std::ofstream& out, const ProfileZone& zone) {
+        out << ",\n{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << (zone.track == ProfileTrack::CPU ? 1 : 2)
+            << ",\"ts\":" << zone.startMs * 1000.0 << ",\"dur\":" << zone.durationMs * 1000.0 << "}";
+    }
+}
+
+FrameProfiler& FrameProfiler::shared() {
+    static FrameProfiler instance;
+    return instance;
+}
+
+FrameProfiler::FrameProfiler() : m_epoch(std::chrono::steady_clock::now()) {}
+
+FrameProfiler::~FrameProfiler() = default;
+
+bool FrameProfiler::initialize() {
+    if (hasGpuTimers()) return true;
+    if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query) {
+        std::cerr << "ERROR::FrameProfiler: Timer queries unavailable; timing the CPU only" << std::endl;
+        return false;
+    }
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    if (bits == 0) {
+        std::cerr << "ERROR::FrameProfiler: Driver has no timestamp counter; timing the CPU only" << std::endl;
+        return false;
+    }
+    glGenQueries(static_cast<GLsizei>(FRAME_SLOTS * 2 * MAX_GPU_ZONES), &m_queries[0][0]);
+    return true;
+}
+
+void FrameProfiler::cleanup() {
+    if (hasGpuTimers()) {
+        glDeleteQueries(static_cast<GLsizei>(FRAME_SLOTS * 2 * MAX_GPU_ZONES), &m_queries[0][0]);
+        std::fill(&m_queries[0][0], &m_queries[0][0] + FRAME_SLOTS * 2 * MAX_GPU_ZONES, 0u);
+    }
+    // Frames still waiting on their queries keep their CPU zones
+    for (size_t i = 0; i < FRAME_SLOTS; ++i) {
+        m_slots[i].gpuZones.clear();
+    }
+    collectPending();
+    m_current = nullptr;
+}
+
+double FrameProfiler::now() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+void FrameProfiler::beginFrame() {
+    collectPending();
+
+    FrameSlot& slot = m_slots[m_frameNumber % FRAME_SLOTS];
+    if (slot.pending) {
+        // Its queries are FRAME_SLOTS frames old and still not back; waiting
+        // would stall, so keep only its CPU zones
+        ++m_droppedGpuFrames;
+        slot.gpuZones.clear();
+        complete(slot);
+    }
+
+    slot.frame = ProfileFrame();
+    slot.frame.frame = m_frameNumber;
+    slot.gpuZones.clear();
+    if (hasGpuTimers()) {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        slot.gpuBaseNs = gpuNow;
+    }
+    slot.cpuBaseMs = now();
+    m_current = &slot;
+    m_cpuStack.clear();
+    m_gpuStack.clear();
+}
+
+void FrameProfiler::endFrame() {
+    if (!m_current) return;
+    m_current->frame.cpuMs = now() - m_current->cpuBaseMs;
+    m_current->pending = true;
+    m_current = nullptr;
+    ++m_frameNumber;
+    // Frames without GPU zones (or whose queries are already back) finish here
+    collectPending();
+}
+
+void FrameProfiler::beginZone(const char* name, bool gpu) {
+    if (!m_current) return;
+    ProfileZone zone;
+    zone.name = name;
+    zone.depth = static_cast<uint8_t>(m_cpuStack.size());
+    zone.startMs = now();
+    m_cpuStack.push_back(m_current->frame.zones.size());
+    m_current->frame.zones.push_back(zone);
+
+    if (!gpu) return;
+    std::vector<ProfileZone>& gpuZones = m_current->gpuZones;
+    if (!hasGpuTimers() || gpuZones.size() == MAX_GPU_ZONES) {
+        m_gpuStack.push_back(UNTIMED_ZONE);
+        return;
+    }
+    ProfileZone gpuZone;
+    gpuZone.name = name;
+    gpuZone.track = ProfileTrack::GPU;
+    gpuZone.depth = static_cast<uint8_t>(std::count_if(m_gpuStack.begin(), m_gpuStack.end(),
+                                                       [](size_t i) { return i != UNTIMED_ZONE; }));
+    gpuZone.durationMs = -1.0; // Open until endZone
+    const size_t index = gpuZones.size();
+    gpuZones.push_back(gpuZone);
+    glQueryCounter(m_queries[m_current - m_slots][2 * index], GL_TIMESTAMP);
+    m_gpuStack.push_back(index);
+}
+
+void FrameProfiler::endZone(bool gpu) {
+    if (!m_current) return;
+    if (gpu && !m_gpuStack.empty()) {
+        const size_t index = m_gpuStack.back();
+        m_gpuStack.pop_back();
+        if (index != UNTIMED_ZONE) {
+            glQueryCounter(m_queries[m_current - m_slots][2 * index + 1], GL_TIMESTAMP);
+            m_current->gpuZones[index].durationMs = 0.0;
+        }
+    }
+    if (!m_cpuStack.empty()) {
+        ProfileZone& zone = m_current->frame.zones[m_cpuStack.back()];
+        zone.durationMs = now() - zone.startMs;
+        m_cpuStack.pop_back();
+    }
+}
+
+void FrameProfiler::collectPending() {
+    // Oldest first, stopping at the first frame still waiting, so the history
+    // stays in frame order
+    const uint64_t oldest = m_frameNumber >= FRAME_SLOTS ? m_frameNumber - FRAME_SLOTS : 0;
+    for (uint64_t frame = oldest; frame < m_frameNumber; ++frame) {
+        const size_t slotIndex = frame % FRAME_SLOTS;
+        FrameSlot& slot = m_slots[slotIndex];
+        if (!slot.pending || slot.frame.frame != frame) continue;
+        if (!collect(slotIndex)) break;
+        complete(slot);
+    }
+}
+
+bool FrameProfiler::collect(size_t slotIndex) {
+    FrameSlot& slot = m_slots[slotIndex];
+    const GLuint* queries = m_queries[slotIndex];
+    for (size_t i = 0; i < slot.gpuZones.size(); ++i) {
+        if (slot.gpuZones[i].durationMs < 0.0) continue; // Never closed
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[2 * i + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    double gpuStart = 0.0, gpuEnd = 0.0;
+    bool any = false;
+    for (size_t i = 0; i < slot.gpuZones.size(); ++i) {
+        ProfileZone zone = slot.gpuZones[i];
+        if (zone.durationMs < 0.0) continue;
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(queries[2 * i], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(queries[2 * i + 1], GL_QUERY_RESULT, &end);
+        zone.startMs = slot.cpuBaseMs + static_cast<double>(static_cast<int64_t>(begin) - slot.gpuBaseNs) * 1e-6;
+        zone.durationMs = static_cast<double>(end - begin) * 1e-6;
+        slot.frame.zones.push_back(zone);
+
+        gpuStart = any ? std::min(gpuStart, zone.startMs) : zone.startMs;
+        gpuEnd = any ? std::max(gpuEnd, zone.startMs + zone.durationMs) : zone.startMs + zone.durationMs;
+        any = true;
+    }
+    slot.frame.gpuMs = gpuEnd - gpuStart;
+    slot.gpuZones.clear();
+    return true;
+}
+
+void FrameProfiler::complete(FrameSlot& slot) {
+    slot.pending = false;
+    m_history.push_back(std::move(slot.frame));
+    if (m_history.size() > HISTORY_FRAMES) {
+        m_history.pop_front();
+    }
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR::FrameProfiler: Cannot write " << path << std::endl;
+        return false;
+    }
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"traceEvents\":[";
+    out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}}";
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+    for (const ProfileFrame& frame : m_history) {
+        for (const ProfileZone& zone : frame.zones) {
+            writeEvent(out, zone);
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace TurtleEngine
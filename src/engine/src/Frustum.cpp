@@ -0,0 +1,57 @@
+#include "Frustum.hpp"
+
+namespace TurtleEngine {
+
+Frustum Frustum::fromMatrix(const glm::mat4& m) {
+    // glm is column-major: row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[LEFT] = row3 + row0;
+    f.planes[RIGHT] = row3 - row0;
+    f.planes[BOTTOM] = row3 + row1;
+    f.planes[TOP] = row3 - row1;
+    f.planes[NEAR_PLANE] = row3 + row2;
+    f.planes[FAR_PLANE] = row3 - row2;
+
+    for (int i = 0; i < PLANE_COUNT; ++i) {
+        float length = glm::length(glm::vec3(f.planes[i].x, f.planes[i].y, f.planes[i].z));
+        if (length > 0.0f) {
+            f.planes[i] = f.planes[i] / length;
+        }
+    }
+    return f;
+}
+
+bool Frustum::containsPoint(const glm::vec3& point) const {
+    return intersectsSphere(point, 0.0f);
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+    for (int i = 0; i < PLANE_COUNT; ++i) {
+        const glm::vec4& p = planes[i];
+        if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+    for (int i = 0; i < PLANE_COUNT; ++i) {
+        const glm::vec4& p = planes[i];
+        // Test the box corner furthest along the plane normal
+        glm::vec3 positive(p.x >= 0.0f ? max.x : min.x,
+                           p.y >= 0.0f ? max.y : min.y,
+                           p.z >= 0.0f ? max.z : min.z);
+        if (p.x * positive.x + p.y * positive.y + p.z * positive.z + p.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace TurtleEngine
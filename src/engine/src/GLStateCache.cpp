@@ -0,0 +1,94 @@
+#include "GLStateCache.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace TurtleEngine {
+
+void GLStateCache::invalidate() {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_activeUnit = -1;
+    std::fill(std::begin(m_textures), std::end(m_textures), UNKNOWN);
+    m_blend = Toggle::UNKNOWN;
+    m_blendSource = UNKNOWN;
+    m_blendDestination = UNKNOWN;
+    m_depthTest = Toggle::UNKNOWN;
+    m_depthWrite = Toggle::UNKNOWN;
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (program == m_program) {
+        ++m_stats.avoided;
+        return;
+    }
+    glUseProgram(program);
+    m_program = program;
+    ++m_stats.changes;
+}
+
+void GLStateCache::bindVertexArray(GLuint vertexArray) {
+    if (vertexArray == m_vertexArray) {
+        ++m_stats.avoided;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    m_vertexArray = vertexArray;
+    ++m_stats.changes;
+}
+
+void GLStateCache::bindTexture(int unit, GLenum target, GLuint texture) {
+    if (unit < 0 || unit >= MAX_TEXTURE_UNITS) return;
+    if (texture == m_textures[unit] && target == m_textureTargets[unit]) {
+        ++m_stats.avoided;
+        return;
+    }
+    if (unit != m_activeUnit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeUnit = unit;
+    }
+    glBindTexture(target, texture);
+    m_textures[unit] = texture;
+    m_textureTargets[unit] = target;
+    ++m_stats.changes;
+}
+
+bool GLStateCache::setToggle(Toggle& tracked, bool enabled) {
+    const Toggle wanted = enabled ? Toggle::ON : Toggle::OFF;
+    if (tracked == wanted) {
+        ++m_stats.avoided;
+        return false;
+    }
+    tracked = wanted;
+    ++m_stats.changes;
+    return true;
+}
+
+void GLStateCache::setBlend(bool enabled) {
+    if (!setToggle(m_blend, enabled)) return;
+    if (enabled) glEnable(GL_BLEND);
+    else glDisable(GL_BLEND);
+}
+
+void GLStateCache::setBlendFunc(GLenum source, GLenum destination) {
+    if (source == m_blendSource && destination == m_blendDestination) {
+        ++m_stats.avoided;
+        return;
+    }
+    glBlendFunc(source, destination);
+    m_blendSource = source;
+    m_blendDestination = destination;
+    ++m_stats.changes;
+}
+
+void GLStateCache::setDepthTest(bool enabled) {
+    if (!setToggle(m_depthTest, enabled)) return;
+    if (enabled) glEnable(GL_DEPTH_TEST);
+    else glDisable(GL_DEPTH_TEST);
+}
+
+void GLStateCache::setDepthWrite(bool enabled) {
+    if (!setToggle(m_depthWrite, enabled)) return;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+} // namespace TurtleEngine
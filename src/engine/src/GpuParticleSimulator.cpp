@@ -0,0 +1,251 @@
+#include "GpuParticleSimulator.hpp"
+#include "FrameProfiler.hpp"
+#include "ShaderSource.hpp"
+#include "UniformBuffer.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <algorithm>
+
+namespace TurtleEngine {
+
+namespace {
+    GLuint compileStage(GLenum type, const std::string& source) {
+        GLuint shader = glCreateShader(type);
+        const char* src = source.c_str();
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    // Only asked after a failed link, so a good build never waits on a status query
+    void printCompileLog(GLuint shader, const std::string& path) {
+        GLint success = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (success) return;
+        char infoLog[1024];
+        glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+        std::cerr << "ERROR::GpuParticleSimulator: Compile failed for " << path << "\n" << infoLog << std::endl;
+    }
+}
+
+GpuParticleSimulator::GpuParticleSimulator(size_t maxParticles, size_t spawnCapacity)
+    : m_maxParticles(maxParticles), m_spawnCapacity(std::min(spawnCapacity, maxParticles)) {
+}
+
+GpuParticleSimulator::~GpuParticleSimulator() {
+    ShaderManager::shared().release(m_renderShaderId);
+    if (m_initialized) {
+        glDeleteProgram(m_updateProgram);
+        glDeleteTransformFeedbacks(2, m_feedback);
+        glDeleteVertexArrays(2, m_vaos);
+        glDeleteBuffers(2, m_buffers);
+        glDeleteVertexArrays(1, &m_spawnVAO);
+        glDeleteBuffers(1, &m_spawnBuffer);
+        glDeleteQueries(1, &m_writtenQuery);
+    }
+}
+
+bool GpuParticleSimulator::initialize(const std::string& updateVertexPath, const std::string& updateGeometryPath,
+                                      const std::string& renderVertexPath, const std::string& renderFragmentPath) {
+    if (m_initialized) return true;
+
+    if (!GLEW_VERSION_4_0 && !GLEW_ARB_transform_feedback2) {
+        std::cerr << "ERROR::GpuParticleSimulator: glDrawTransformFeedback unavailable (needs GL 4.0 or ARB_transform_feedback2)" << std::endl;
+        return false;
+    }
+
+    // The render program compiles in the driver while the update program is built,
+    // then reloads whenever its files change
+    ShaderManager& shaders = ShaderManager::shared();
+    m_renderShaderId = shaders.submit(renderVertexPath, renderFragmentPath);
+    if (m_renderShaderId == INVALID_SHADER) {
+        std::cerr << "ERROR::GpuParticleSimulator: Failed to load render shaders ("
+                  << renderVertexPath << ", " << renderFragmentPath << ")" << std::endl;
+        return false;
+    }
+    if (!buildUpdateProgram(updateVertexPath, updateGeometryPath)) {
+        shaders.release(m_renderShaderId);
+        m_renderShaderId = INVALID_SHADER;
+        return false;
+    }
+    if (!shaders.finish(m_renderShaderId)) {
+        std::cerr << "ERROR::GpuParticleSimulator: Failed to load render shaders ("
+                  << renderVertexPath << ", " << renderFragmentPath << ")" << std::endl;
+        shaders.release(m_renderShaderId);
+        m_renderShaderId = INVALID_SHADER;
+        glDeleteProgram(m_updateProgram);
+        m_updateProgram = 0;
+        return false;
+    }
+
+    createBuffers();
+    m_initialized = true;
+    return true;
+}
+
+bool GpuParticleSimulator::buildUpdateProgram(const std::string& vertexPath, const std::string& geometryPath) {
+    // Transform feedback needs its varyings set before linking, which the
+    // ShaderPipeline does not do, so only the sources come from the shared cache
+    std::string vertexCode, geometryCode;
+    std::vector<std::string> files;
+    ShaderSourceCache& sources = ShaderSourceCache::shared();
+    if (!sources.load(vertexPath, vertexCode, files) || !sources.load(geometryPath, geometryCode, files)) {
+        std::cerr << "ERROR::GpuParticleSimulator: Failed to read update shaders ("
+                  << vertexPath << ", " << geometryPath << ")" << std::endl;
+        return false;
+    }
+
+    GLuint vertex = compileStage(GL_VERTEX_SHADER, vertexCode);
+    GLuint geometry = compileStage(GL_GEOMETRY_SHADER, geometryCode);
+    m_updateProgram = glCreateProgram();
+    glAttachShader(m_updateProgram, vertex);
+    glAttachShader(m_updateProgram, geometry);
+
+    // Captured outputs must be declared before linking
+    const char* varyings[] = { "outPosLife", "outVelInitLife", "outColorStart", "outColorEnd" };
+    glTransformFeedbackVaryings(m_updateProgram, 4, varyings, GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(m_updateProgram);
+
+    GLint success = 0;
+    glGetProgramiv(m_updateProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        printCompileLog(vertex, vertexPath);
+        printCompileLog(geometry, geometryPath);
+    }
+    glDeleteShader(vertex);
+    glDeleteShader(geometry);
+    if (!success) {
+        char infoLog[1024];
+        glGetProgramInfoLog(m_updateProgram, sizeof(infoLog), nullptr, infoLog);
+        std::cerr << "ERROR::GpuParticleSimulator: Update program link failed\n" << infoLog << std::endl;
+        glDeleteProgram(m_updateProgram);
+        m_updateProgram = 0;
+        return false;
+    }
+
+    m_deltaTimeLocation = glGetUniformLocation(m_updateProgram, "deltaTime");
+    m_cameraPositionLocation = glGetUniformLocation(m_updateProgram, "cameraPosition");
+    m_cullDistanceSqLocation = glGetUniformLocation(m_updateProgram, "cullDistanceSq");
+    return true;
+}
+
+void GpuParticleSimulator::setupAttributes(GLuint vao, GLuint buffer) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    const GLsizei stride = sizeof(GpuParticle);
+    for (GLuint i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribPointer(i, 4, GL_FLOAT, GL_FALSE, stride, (void*)(i * sizeof(glm::vec4)));
+    }
+}
+
+void GpuParticleSimulator::createBuffers() {
+    glGenBuffers(2, m_buffers);
+    glGenVertexArrays(2, m_vaos);
+    glGenTransformFeedbacks(2, m_feedback);
+
+    for (int i = 0; i < 2; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, m_maxParticles * sizeof(GpuParticle), nullptr, GL_DYNAMIC_COPY);
+        setupAttributes(m_vaos[i], m_buffers[i]);
+
+        // Each feedback object remembers its output buffer and the vertex count it recorded
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, m_feedback[i]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_buffers[i]);
+    }
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+
+    // Spawn staging buffer: the only per-frame CPU -> GPU traffic
+    glGenBuffers(1, &m_spawnBuffer);
+    glGenVertexArrays(1, &m_spawnVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_spawnBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_spawnCapacity * sizeof(GpuParticle), nullptr, GL_STREAM_DRAW);
+    setupAttributes(m_spawnVAO, m_spawnBuffer);
+
+    glGenQueries(1, &m_writtenQuery);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuParticleSimulator::update(float deltaTime) {
+    if (!m_initialized) return;
+
+    const size_t spawnCount = std::min(m_pendingSpawns.size(), m_spawnCapacity);
+    if (!m_hasData[m_current] && spawnCount == 0) return; // Nothing alive, nothing to add
+    ProfileScope zone("Particle simulation", true);
+
+    if (spawnCount > 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_spawnBuffer);
+        // Orphan first so the driver does not wait on last frame's draw
+        glBufferData(GL_ARRAY_BUFFER, m_spawnCapacity * sizeof(GpuParticle), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, spawnCount * sizeof(GpuParticle), m_pendingSpawns.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    const int source = m_current;
+    const int target = 1 - m_current;
+
+    glUseProgram(m_updateProgram);
+    glUniform1f(m_deltaTimeLocation, deltaTime);
+    glUniform3fv(m_cameraPositionLocation, 1, glm::value_ptr(m_cameraPosition));
+    glUniform1f(m_cullDistanceSqLocation, m_cullDistance > 0.0f ? m_cullDistance * m_cullDistance : 0.0f);
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, m_feedback[target]);
+    glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, m_writtenQuery);
+    glBeginTransformFeedback(GL_POINTS);
+
+    // Existing particles first, then new spawns append behind them.
+    // Output beyond the buffer size is discarded by GL, which caps the pool.
+    if (m_hasData[source]) {
+        glBindVertexArray(m_vaos[source]);
+        glDrawTransformFeedback(GL_POINTS, m_feedback[source]);
+    }
+    if (spawnCount > 0) {
+        glBindVertexArray(m_spawnVAO);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(spawnCount));
+    }
+
+    glEndTransformFeedback();
+    glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+    glBindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    m_hasData[target] = true;
+    m_current = target;
+    m_pendingSpawns.erase(m_pendingSpawns.begin(), m_pendingSpawns.begin() + spawnCount);
+}
+
+void GpuParticleSimulator::render(const glm::mat4& projection, const glm::mat4& view, float time, float pointScale) {
+    if (!m_initialized || !m_hasData[m_current]) return;
+
+    // Looked up each frame: a reload replaces the program
+    Shader& shader = ShaderManager::shared().get(m_renderShaderId);
+    shader.use();
+    FrameUniforms::shared().setCamera(view, projection);
+    shader.setFloat("time", time);
+    shader.setFloat("pointScale", pointScale);
+
+    glBindVertexArray(m_vaos[m_current]);
+    glDrawTransformFeedback(GL_POINTS, m_feedback[m_current]);
+    glBindVertexArray(0);
+}
+
+size_t GpuParticleSimulator::readBack(std::vector<GpuParticle>& out) {
+    out.clear();
+    if (!m_initialized || !m_hasData[m_current]) return 0;
+
+    GLuint written = 0;
+    glGetQueryObjectuiv(m_writtenQuery, GL_QUERY_RESULT, &written);
+    out.resize(written);
+    if (written > 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers[m_current]);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, written * sizeof(GpuParticle), out.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    return out.size();
+}
+
+} // namespace TurtleEngine
@@ -1,173 +1,478 @@
 #include "Grid.hpp"
+#include "FrameProfiler.hpp"
+#include "Frustum.hpp"
+#include "RenderQueue.hpp"
+#include "UniformBuffer.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <iostream>
 
 namespace TurtleEngine {
 
-Grid::Grid(int width, int height, float cellSize)
-    : m_width(width), m_height(height), m_cellSize(cellSize) {
-    m_colors.resize(width * height, glm::vec3(0.2f, 0.2f, 0.2f));
+namespace {
+    constexpr int VERTICES_PER_CELL = 4;
+    constexpr size_t BYTES_PER_TEXEL = 3;
+    constexpr uint8_t DEFAULT_SHADE = 51; // 0.2 grey
+
+    // Dirty spans closer than this (in cells) are uploaded as one range: re-sending
+    // a few clean cells is cheaper than another upload call
+    constexpr size_t MERGE_GAP_CELLS = 64;
+
+    // The plane has no thickness; pad the boxes so edge-on chunks are not lost to rounding
+    constexpr float CHUNK_BOUNDS_PADDING = 0.01f;
+
+    uint8_t toByte(float channel) {
+        return static_cast<uint8_t>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+Grid::Grid(int width, int height, float cellSize, GridRenderMode mode, int chunkSize)
+    : m_width(width), m_height(height), m_cellSize(cellSize), m_mode(mode),
+      m_chunkSize(std::clamp(chunkSize, 1, MAX_CHUNK_SIZE)) {
+    m_colors.assign(static_cast<size_t>(width) * height * BYTES_PER_TEXEL, DEFAULT_SHADE);
+
+    // Chunk bookkeeping only; GPU resources are built on first sight
+    m_chunksX = (width + m_chunkSize - 1) / m_chunkSize;
+    const int chunksY = (height + m_chunkSize - 1) / m_chunkSize;
+    const float halfWidth = width * cellSize / 2.0f;
+    const float halfHeight = height * cellSize / 2.0f;
+    m_chunks.resize(static_cast<size_t>(m_chunksX) * chunksY);
+    for (int cy = 0; cy < chunksY; ++cy) {
+        for (int cx = 0; cx < m_chunksX; ++cx) {
+            Chunk& chunk = m_chunks[cy * m_chunksX + cx];
+            chunk.x0 = cx * m_chunkSize;
+            chunk.y0 = cy * m_chunkSize;
+            chunk.width = std::min(m_chunkSize, width - chunk.x0);
+            chunk.height = std::min(m_chunkSize, height - chunk.y0);
+            chunk.boundsMin = glm::vec3(chunk.x0 * cellSize - halfWidth, -CHUNK_BOUNDS_PADDING,
+                                        chunk.y0 * cellSize - halfHeight);
+            chunk.boundsMax = glm::vec3((chunk.x0 + chunk.width) * cellSize - halfWidth, CHUNK_BOUNDS_PADDING,
+                                        (chunk.y0 + chunk.height) * cellSize - halfHeight);
+        }
+    }
     initializeGrid();
 }
 
 Grid::~Grid() {
-    glDeleteVertexArrays(1, &m_VAO);
-    glDeleteBuffers(1, &m_VBO);
+    ShaderManager::shared().release(m_shaderId);
+    for (Chunk& chunk : m_chunks) {
+        destroyChunk(chunk);
+    }
     glDeleteBuffers(1, &m_EBO);
 }
 
 void Grid::initializeGrid() {
-    // Load shaders
-    m_shader.loadFromFiles("shaders/basic.vert", "shaders/basic.frag");
-    createBuffers();
-}
-
-void Grid::createBuffers() {
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    
-    // Create vertices for each cell
-    for (int y = 0; y < m_height; ++y) {
-        for (int x = 0; x < m_width; ++x) {
-            float xPos = x * m_cellSize - (m_width * m_cellSize) / 2.0f;
-            float zPos = y * m_cellSize - (m_height * m_cellSize) / 2.0f;
-            
-            // Add vertices for the cell (quad)
-            vertices.push_back(xPos);          // Position
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos);
-            vertices.push_back(m_colors[y * m_width + x].r);  // Color
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            vertices.push_back(xPos + m_cellSize);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            vertices.push_back(xPos + m_cellSize);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos + m_cellSize);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            vertices.push_back(xPos);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos + m_cellSize);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            // Add indices for the cell
-            unsigned int baseIndex = (y * m_width + x) * 4;
-            indices.push_back(baseIndex);
-            indices.push_back(baseIndex + 1);
-            indices.push_back(baseIndex + 2);
-            indices.push_back(baseIndex);
-            indices.push_back(baseIndex + 2);
-            indices.push_back(baseIndex + 3);
+    if (m_mode == GridRenderMode::COLOR_TEXTURE) {
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        if (m_chunkSize > maxTextureSize) {
+            std::cerr << "ERROR::Grid: Chunk size " << m_chunkSize << " exceeds GL_MAX_TEXTURE_SIZE ("
+                      << maxTextureSize << "), falling back to per-vertex colours" << std::endl;
+            m_mode = GridRenderMode::PER_VERTEX_COLOR;
         }
     }
 
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
-    glGenBuffers(1, &m_EBO);
+    // The index buffer is built while the driver compiles the shaders
+    ShaderManager& shaders = ShaderManager::shared();
+    if (m_mode == GridRenderMode::COLOR_TEXTURE) {
+        m_shaderId = shaders.submit("shaders/grid_textured.vert", "shaders/grid_textured.frag");
+    } else {
+        m_shaderId = shaders.submit("shaders/basic.vert", "shaders/basic.frag");
+    }
+    createSharedIndices();
+    if (m_shaderId != INVALID_SHADER && !shaders.finish(m_shaderId)) {
+        shaders.release(m_shaderId);
+        m_shaderId = INVALID_SHADER;
+    }
+    if (m_shaderId == INVALID_SHADER) {
+        std::cerr << "ERROR::Grid: Failed to load grid shaders" << std::endl;
+    }
+}
 
-    glBindVertexArray(m_VAO);
+Shader* Grid::getShader() const {
+    if (m_shaderId == INVALID_SHADER) return nullptr;
+    Shader& shader = ShaderManager::shared().get(m_shaderId);
+    return shader.getProgram() != 0 ? &shader : nullptr;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+void Grid::createSharedIndices() {
+    // Cell i of any chunk uses vertices 4i .. 4i+3, so one buffer sized for a full
+    // chunk serves them all (a textured chunk is just cell 0)
+    const size_t cells = static_cast<size_t>(m_chunkSize) * m_chunkSize;
+    std::vector<uint16_t> indices;
+    indices.reserve(cells * 6);
+    for (size_t cell = 0; cell < cells; ++cell) {
+        uint16_t baseIndex = static_cast<uint16_t>(cell * VERTICES_PER_CELL);
+        indices.push_back(baseIndex);
+        indices.push_back(baseIndex + 1);
+        indices.push_back(baseIndex + 2);
+        indices.push_back(baseIndex);
+        indices.push_back(baseIndex + 2);
+        indices.push_back(baseIndex + 3);
+    }
 
+    glGenBuffers(1, &m_EBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Grid::buildChunk(Chunk& chunk) {
+    glGenVertexArrays(1, &chunk.vao);
+    glBindVertexArray(chunk.vao);
+    if (m_mode == GridRenderMode::COLOR_TEXTURE) {
+        buildTexturedChunk(chunk);
+    } else {
+        buildVertexChunk(chunk);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO); // Recorded in the VAO
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    chunk.dirtyMin.assign(chunk.height, chunk.width);
+    chunk.dirtyMax.assign(chunk.height, -1);
+    chunk.built = true;
+    ++m_builtChunks;
+}
+
+void Grid::buildVertexChunk(Chunk& chunk) {
+    const size_t cellCount = static_cast<size_t>(chunk.width) * chunk.height;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> colors;
+    positions.reserve(cellCount * VERTICES_PER_CELL);
+    colors.reserve(cellCount * VERTICES_PER_CELL);
+
+    // Create vertices for each cell, chunk-local row-major
+    for (int y = chunk.y0; y < chunk.y0 + chunk.height; ++y) {
+        for (int x = chunk.x0; x < chunk.x0 + chunk.width; ++x) {
+            float xPos = x * m_cellSize - (m_width * m_cellSize) / 2.0f;
+            float zPos = y * m_cellSize - (m_height * m_cellSize) / 2.0f;
+
+            // Add vertices for the cell (quad)
+            positions.emplace_back(xPos, 0.0f, zPos);
+            positions.emplace_back(xPos + m_cellSize, 0.0f, zPos);
+            positions.emplace_back(xPos + m_cellSize, 0.0f, zPos + m_cellSize);
+            positions.emplace_back(xPos, 0.0f, zPos + m_cellSize);
+            colors.insert(colors.end(), VERTICES_PER_CELL, getCellColor(x, y));
+        }
+    }
+
+    // Positions never change; colours live in their own buffer so an update only
+    // touches the 48 bytes of each changed cell
+    glGenBuffers(1, &chunk.positionVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.positionVBO);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
     glEnableVertexAttribArray(0);
 
-    // Color attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glGenBuffers(1, &chunk.colorVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.colorVBO);
+    glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec3), colors.data(), GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
     glEnableVertexAttribArray(1);
 }
 
-void Grid::render(const glm::mat4& projection, const glm::mat4& view) {
-    // logToFile("[Grid Render] Entered."); // Removed entry log
+void Grid::buildTexturedChunk(Chunk& chunk) {
+    // One quad over the chunk; the second attribute is the chunk-space cell corner,
+    // which the fragment shader turns into a texel index
+    const glm::vec3& lo = chunk.boundsMin;
+    const glm::vec3& hi = chunk.boundsMax;
+    const float w = static_cast<float>(chunk.width);
+    const float h = static_cast<float>(chunk.height);
+    const float vertices[] = {
+        lo.x, 0.0f, lo.z,  0.0f, 0.0f,
+        hi.x, 0.0f, lo.z,  w,    0.0f,
+        hi.x, 0.0f, hi.z,  w,    h,
+        lo.x, 0.0f, hi.z,  0.0f, h,
+    };
+
+    glGenBuffers(1, &chunk.positionVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.positionVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
 
-    m_shader.use();
-    
-    // Check shader program validity after use()
-    GLint currentProgram = 0;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    // logToFile(std::string("[Grid Render] Shader ID: ") + std::to_string(currentProgram)); // Removed shader ID log
+    glGenTextures(1, &chunk.texture);
+    glBindTexture(GL_TEXTURE_2D, chunk.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    // RGB8 rows are not 4-byte aligned for odd widths; read the chunk out of the whole-grid mirror
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width);
+    const uint8_t* first = &m_colors[(static_cast<size_t>(chunk.y0) * m_width + chunk.x0) * BYTES_PER_TEXEL];
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, chunk.width, chunk.height, 0, GL_RGB, GL_UNSIGNED_BYTE, first);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Grid::destroyChunk(Chunk& chunk) {
+    if (!chunk.built) return;
+    glDeleteVertexArrays(1, &chunk.vao);
+    glDeleteBuffers(1, &chunk.positionVBO);
+    glDeleteBuffers(1, &chunk.colorVBO);
+    glDeleteTextures(1, &chunk.texture);
+    chunk.built = false;
+}
+
+void Grid::prepareVisibleChunks(const glm::mat4& projection, const glm::mat4& view) {
+    const bool flushing = !m_dirtyChunks.empty();
+    if (flushing) {
+        m_lastFlushBytes = 0;
+        m_lastFlushUploads = 0;
+    }
+
+    // Cost follows what is on screen: hidden chunks are neither built, flushed nor drawn
+    const Frustum frustum = Frustum::fromMatrix(projection * view);
+    m_visibleChunks.clear();
+    for (uint32_t index = 0; index < m_chunks.size(); ++index) {
+        Chunk& chunk = m_chunks[index];
+        if (!frustum.intersectsAABB(chunk.boundsMin, chunk.boundsMax)) continue;
+
+        if (!chunk.built) {
+            buildChunk(chunk);
+        } else if (!chunk.dirtyRows.empty()) {
+            flushChunk(chunk);
+        }
+        m_visibleChunks.push_back(index);
+    }
+    m_lastVisibleChunks = m_visibleChunks.size();
+
+    // Chunks still dirty (off screen) wait for their next appearance
+    if (flushing) {
+        m_dirtyChunks.erase(std::remove_if(m_dirtyChunks.begin(), m_dirtyChunks.end(),
+                                           [this](uint32_t index) { return m_chunks[index].dirtyRows.empty(); }),
+                            m_dirtyChunks.end());
+    }
+}
 
-    if (currentProgram == 0) {
-        logToFile("[Grid Render] Error: Shader program is not valid or not bound.");
+void Grid::render(const glm::mat4& projection, const glm::mat4& view) {
+    ProfileScope zone("Grid", true);
+    Shader* shader = getShader();
+    if (!shader) {
+        std::cerr << "ERROR::Grid: Shader program is not valid" << std::endl;
         return; // Don't attempt to render without a valid shader
     }
+    shader->use();
 
     glm::mat4 model = glm::mat4(1.0f); // Identity matrix for model
-    m_shader.setMat4("projection", projection);
-    m_shader.setMat4("view", view);
-    m_shader.setMat4("model", model);
-
-    glBindVertexArray(m_VAO);
-    // logToFile(std::string("[Grid Render] Drawing Elements: mode=GL_TRIANGLES, count=") + // Removed draw log
-    //           std::to_string(m_indices.size()) + ", type=GL_UNSIGNED_INT, indices=0");
-    glDrawElements(GL_TRIANGLES, m_width * m_height * 6, GL_UNSIGNED_INT, 0);
+    FrameUniforms::shared().setCamera(view, projection);
+    shader->setMat4("model", model);
+
+    const bool textured = m_mode == GridRenderMode::COLOR_TEXTURE;
+    if (textured) {
+        glActiveTexture(GL_TEXTURE0);
+        shader->setInt("cellColors", 0);
+    }
+
+    prepareVisibleChunks(projection, view);
+    for (uint32_t index : m_visibleChunks) {
+        const Chunk& chunk = m_chunks[index];
+        glBindVertexArray(chunk.vao);
+        if (textured) {
+            glBindTexture(GL_TEXTURE_2D, chunk.texture);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
+        } else {
+            glDrawElements(GL_TRIANGLES, chunk.width * chunk.height * 6, GL_UNSIGNED_SHORT, 0);
+        }
+    }
     glBindVertexArray(0);
-    glUseProgram(0); // Unbind shader
+    if (textured) glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Grid::submit(RenderCommandList& list, const glm::mat4& projection, const glm::mat4& view) {
+    recordChunks(list, 0, prepare(projection, view), view);
+}
+
+size_t Grid::prepare(const glm::mat4& projection, const glm::mat4& view) {
+    if (!getShader()) {
+        std::cerr << "ERROR::Grid: Shader program is not valid" << std::endl;
+        m_visibleChunks.clear();
+        return 0;
+    }
+    FrameUniforms::shared().setCamera(view, projection);
+    prepareVisibleChunks(projection, view);
+    return m_visibleChunks.size();
+}
+
+void Grid::recordChunks(RenderCommandList& list, size_t begin, size_t end, const glm::mat4& view) const {
+    const Shader* shader = getShader();
+    if (!shader) return;
+    const GLuint program = shader->getProgram();
+    const UniformHandle<glm::mat4> modelUniform = shader->getUniform<glm::mat4>("model");
+    const UniformHandle<int> cellColorsUniform = shader->getUniform<int>("cellColors");
+    const bool textured = m_mode == GridRenderMode::COLOR_TEXTURE;
+
+    end = std::min(end, m_visibleChunks.size());
+    for (size_t i = begin; i < end; ++i) {
+        const Chunk& chunk = m_chunks[m_visibleChunks[i]];
+        // Front to back by chunk centre; the queue skips the repeated uniforms
+        const glm::vec3 centre = (chunk.boundsMin + chunk.boundsMax) * 0.5f;
+        const float depth = -(view * glm::vec4(centre, 1.0f)).z;
+        RenderCommand& command = list.submit(makeRenderKey(RenderPass::SOLID, program, textured ? chunk.texture : 0, depth));
+        command.program = program;
+        command.vertexArray = chunk.vao;
+        command.indexType = GL_UNSIGNED_SHORT;
+        if (textured) {
+            command.textures[0].texture = chunk.texture;
+            command.count = 6;
+        } else {
+            command.count = chunk.width * chunk.height * 6;
+        }
+        list.setUniform(modelUniform, glm::mat4(1.0f));
+        if (textured) list.setUniform(cellColorsUniform, 0);
+    }
+}
+
+void Grid::markDirty(int x, int y) {
+    const uint32_t index = static_cast<uint32_t>((y / m_chunkSize) * m_chunksX + x / m_chunkSize);
+    Chunk& chunk = m_chunks[index];
+    if (!chunk.built) return; // Built from m_colors when first seen
+
+    const int localX = x - chunk.x0;
+    const int localY = y - chunk.y0;
+    if (chunk.dirtyRows.empty()) {
+        m_dirtyChunks.push_back(index);
+    }
+    if (chunk.dirtyMax[localY] < 0) {
+        chunk.dirtyRows.push_back(localY);
+    }
+    chunk.dirtyMin[localY] = std::min(chunk.dirtyMin[localY], localX);
+    chunk.dirtyMax[localY] = std::max(chunk.dirtyMax[localY], localX);
 }
 
 void Grid::setCellColor(int x, int y, const glm::vec3& color) {
     if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
-        m_colors[y * m_width + x] = color;
-        updateColors();
+        uint8_t* texel = &m_colors[(static_cast<size_t>(y) * m_width + x) * BYTES_PER_TEXEL];
+        texel[0] = toByte(color.r);
+        texel[1] = toByte(color.g);
+        texel[2] = toByte(color.b);
+        markDirty(x, y);
     }
 }
 
-void Grid::updateColors() {
-    // Update the VBO with new colors
-    std::vector<float> vertices;
-    for (int y = 0; y < m_height; ++y) {
-        for (int x = 0; x < m_width; ++x) {
-            float xPos = x * m_cellSize - (m_width * m_cellSize) / 2.0f;
-            float zPos = y * m_cellSize - (m_height * m_cellSize) / 2.0f;
-            
-            // Add vertices for the cell (quad)
-            vertices.push_back(xPos);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            vertices.push_back(xPos + m_cellSize);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            vertices.push_back(xPos + m_cellSize);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos + m_cellSize);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
-            
-            vertices.push_back(xPos);
-            vertices.push_back(0.0f);
-            vertices.push_back(zPos + m_cellSize);
-            vertices.push_back(m_colors[y * m_width + x].r);
-            vertices.push_back(m_colors[y * m_width + x].g);
-            vertices.push_back(m_colors[y * m_width + x].b);
+void Grid::setCellColors(const GridCellColor* cells, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        setCellColor(cells[i].x, cells[i].y, cells[i].color);
+    }
+}
+
+glm::vec3 Grid::getCellColor(int x, int y) const {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return glm::vec3(0.0f);
+    const uint8_t* texel = &m_colors[(static_cast<size_t>(y) * m_width + x) * BYTES_PER_TEXEL];
+    return glm::vec3(texel[0], texel[1], texel[2]) / 255.0f;
+}
+
+void Grid::flushColors() {
+    if (m_dirtyChunks.empty()) return;
+    m_lastFlushBytes = 0;
+    m_lastFlushUploads = 0;
+    for (uint32_t index : m_dirtyChunks) {
+        flushChunk(m_chunks[index]);
+    }
+    m_dirtyChunks.clear();
+}
+
+void Grid::flushChunk(Chunk& chunk) {
+    // Walking rows in order lets nearby spans merge into one upload
+    std::sort(chunk.dirtyRows.begin(), chunk.dirtyRows.end());
+    if (m_mode == GridRenderMode::COLOR_TEXTURE) {
+        flushColorTexture(chunk);
+    } else {
+        flushVertexColors(chunk);
+    }
+
+    for (int row : chunk.dirtyRows) {
+        chunk.dirtyMin[row] = chunk.width;
+        chunk.dirtyMax[row] = -1;
+    }
+    chunk.dirtyRows.clear();
+}
+
+void Grid::flushVertexColors(Chunk& chunk) {
+    // Rows are contiguous in the chunk's buffer, so spans merge across row ends too
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.colorVBO);
+    size_t rangeStart = 0, rangeEnd = 0; // Chunk-local cell indices, end exclusive
+    bool haveRange = false;
+    for (int row : chunk.dirtyRows) {
+        size_t start = static_cast<size_t>(row) * chunk.width + chunk.dirtyMin[row];
+        size_t end = static_cast<size_t>(row) * chunk.width + chunk.dirtyMax[row] + 1;
+
+        if (haveRange && start <= rangeEnd + MERGE_GAP_CELLS) {
+            rangeEnd = end;
+            continue;
         }
+        if (haveRange) uploadColorRange(chunk, rangeStart, rangeEnd - rangeStart);
+        rangeStart = start;
+        rangeEnd = end;
+        haveRange = true;
     }
+    uploadColorRange(chunk, rangeStart, rangeEnd - rangeStart);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Grid::flushColorTexture(Chunk& chunk) {
+    // Consecutive rows grow one rectangle while it wastes at most MERGE_GAP_CELLS clean texels
+    glBindTexture(GL_TEXTURE_2D, chunk.texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width); // Rectangles read straight out of m_colors
+
+    int minX = 0, maxX = -1, firstRow = 0, lastRow = -1;
+    size_t dirtyCells = 0;
+    for (int row : chunk.dirtyRows) {
+        const int spanMin = chunk.dirtyMin[row];
+        const int spanMax = chunk.dirtyMax[row];
+        const size_t spanCells = static_cast<size_t>(spanMax - spanMin + 1);
+
+        if (lastRow >= 0 && row == lastRow + 1) {
+            int mergedMin = std::min(minX, spanMin);
+            int mergedMax = std::max(maxX, spanMax);
+            size_t mergedArea = static_cast<size_t>(mergedMax - mergedMin + 1) * (row - firstRow + 1);
+            if (mergedArea - (dirtyCells + spanCells) <= MERGE_GAP_CELLS) {
+                minX = mergedMin;
+                maxX = mergedMax;
+                lastRow = row;
+                dirtyCells += spanCells;
+                continue;
+            }
+        }
+        if (lastRow >= 0) uploadColorRect(chunk, minX, firstRow, maxX - minX + 1, lastRow - firstRow + 1);
+        minX = spanMin;
+        maxX = spanMax;
+        firstRow = lastRow = row;
+        dirtyCells = spanCells;
+    }
+    uploadColorRect(chunk, minX, firstRow, maxX - minX + 1, lastRow - firstRow + 1);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-} 
\ No newline at end of file
+void Grid::uploadColorRange(const Chunk& chunk, size_t firstCell, size_t cellCount) {
+    m_uploadScratch.clear();
+    for (size_t cell = firstCell; cell < firstCell + cellCount; ++cell) {
+        int x = chunk.x0 + static_cast<int>(cell % chunk.width);
+        int y = chunk.y0 + static_cast<int>(cell / chunk.width);
+        m_uploadScratch.insert(m_uploadScratch.end(), VERTICES_PER_CELL, getCellColor(x, y));
+    }
+    const size_t bytesPerCell = VERTICES_PER_CELL * sizeof(glm::vec3);
+    glBufferSubData(GL_ARRAY_BUFFER, firstCell * bytesPerCell, cellCount * bytesPerCell, m_uploadScratch.data());
+    m_lastFlushBytes += cellCount * bytesPerCell;
+    ++m_lastFlushUploads;
+}
+
+void Grid::uploadColorRect(const Chunk& chunk, int x, int y, int width, int height) {
+    // Texel coordinates are chunk-local; the source is the grid-wide mirror
+    const uint8_t* first = &m_colors[(static_cast<size_t>(chunk.y0 + y) * m_width + chunk.x0 + x) * BYTES_PER_TEXEL];
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, first);
+    m_lastFlushBytes += static_cast<size_t>(width) * height * BYTES_PER_TEXEL;
+    ++m_lastFlushUploads;
+}
+
+}
@@ -0,0 +1,204 @@
+#include "GridOccupancy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace TurtleEngine {
+
+GridOccupancy::GridOccupancy(int width, int height, float cellSize)
+    : m_width(std::max(width, 1)), m_height(std::max(height, 1)),
+      m_cellSize(cellSize > 0.0f ? cellSize : 1.0f) {
+    if (width < 1 || height < 1 || cellSize <= 0.0f) {
+        std::cerr << "ERROR::GridOccupancy: invalid size " << width << "x" << height
+                  << " with cell size " << cellSize << std::endl;
+    }
+    m_inverseCellSize = 1.0f / m_cellSize;
+    m_origin = glm::vec2(-m_width * m_cellSize / 2.0f, -m_height * m_cellSize / 2.0f);
+    m_cellHead.assign(static_cast<size_t>(m_width) * m_height, -1);
+    m_cellCount.assign(m_cellHead.size(), 0);
+}
+
+glm::ivec2 GridOccupancy::worldToCell(const glm::vec3& position) const {
+    int x = static_cast<int>(std::floor((position.x - m_origin.x) * m_inverseCellSize));
+    int y = static_cast<int>(std::floor((position.z - m_origin.y) * m_inverseCellSize));
+    return glm::ivec2(std::clamp(x, 0, m_width - 1), std::clamp(y, 0, m_height - 1));
+}
+
+glm::vec3 GridOccupancy::cellToWorld(int x, int y) const {
+    return glm::vec3(m_origin.x + (x + 0.5f) * m_cellSize, 0.0f, m_origin.y + (y + 0.5f) * m_cellSize);
+}
+
+bool GridOccupancy::isInside(const glm::vec3& position) const {
+    return position.x >= m_origin.x && position.x < m_origin.x + m_width * m_cellSize &&
+           position.z >= m_origin.y && position.z < m_origin.y + m_height * m_cellSize;
+}
+
+int32_t GridOccupancy::cellIndexOf(float x, float z) const {
+    glm::ivec2 cell = worldToCell(glm::vec3(x, 0.0f, z));
+    return cell.y * m_width + cell.x;
+}
+
+void GridOccupancy::reserve(size_t occupants) {
+    m_cell.reserve(occupants);
+    m_next.reserve(occupants);
+    m_previous.reserve(occupants);
+    m_centre.reserve(occupants);
+    m_halfExtents.reserve(occupants);
+    m_y.reserve(occupants);
+}
+
+void GridOccupancy::link(OccupantId id, int32_t cell) {
+    int32_t head = m_cellHead[cell];
+    m_cell[id] = cell;
+    m_previous[id] = -1;
+    m_next[id] = head;
+    if (head >= 0) m_previous[head] = static_cast<int32_t>(id);
+    m_cellHead[cell] = static_cast<int32_t>(id);
+    ++m_cellCount[cell];
+}
+
+void GridOccupancy::unlink(OccupantId id) {
+    int32_t cell = m_cell[id];
+    if (m_previous[id] >= 0) m_next[m_previous[id]] = m_next[id];
+    else m_cellHead[cell] = m_next[id];
+    if (m_next[id] >= 0) m_previous[m_next[id]] = m_previous[id];
+    --m_cellCount[cell];
+    m_cell[id] = -1;
+}
+
+void GridOccupancy::place(OccupantId id, const glm::vec3& position, const glm::vec2& halfExtents) {
+    m_centre[id] = glm::vec2(position.x, position.z);
+    m_halfExtents[id] = glm::abs(halfExtents);
+    m_y[id] = position.y;
+    m_maxHalfExtents = glm::max(m_maxHalfExtents, m_halfExtents[id]);
+}
+
+OccupantId GridOccupancy::insert(const glm::vec3& position, const glm::vec2& halfExtents) {
+    OccupantId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = static_cast<OccupantId>(m_cell.size());
+        m_cell.push_back(-1);
+        m_next.push_back(-1);
+        m_previous.push_back(-1);
+        m_centre.emplace_back(0.0f);
+        m_halfExtents.emplace_back(0.0f);
+        m_y.push_back(0.0f);
+    }
+    place(id, position, halfExtents);
+    link(id, cellIndexOf(position.x, position.z));
+    ++m_occupantCount;
+    return id;
+}
+
+OccupantId GridOccupancy::insert(const HitboxAABB& hitbox) {
+    return insert(hitbox.center, glm::vec2(hitbox.halfExtents.x, hitbox.halfExtents.z));
+}
+
+void GridOccupancy::move(OccupantId id, const glm::vec3& position) {
+    if (!contains(id)) {
+        std::cerr << "ERROR::GridOccupancy: move of unknown occupant " << id << std::endl;
+        return;
+    }
+    move(id, position, m_halfExtents[id]);
+}
+
+void GridOccupancy::move(OccupantId id, const glm::vec3& position, const glm::vec2& halfExtents) {
+    if (!contains(id)) {
+        std::cerr << "ERROR::GridOccupancy: move of unknown occupant " << id << std::endl;
+        return;
+    }
+    place(id, position, halfExtents);
+    // Most moves stay inside the cell and skip the list updates
+    int32_t cell = cellIndexOf(position.x, position.z);
+    if (cell != m_cell[id]) {
+        unlink(id);
+        link(id, cell);
+    }
+}
+
+void GridOccupancy::move(OccupantId id, const HitboxAABB& hitbox) {
+    move(id, hitbox.center, glm::vec2(hitbox.halfExtents.x, hitbox.halfExtents.z));
+}
+
+void GridOccupancy::remove(OccupantId id) {
+    if (!contains(id)) {
+        std::cerr << "ERROR::GridOccupancy: remove of unknown occupant " << id << std::endl;
+        return;
+    }
+    unlink(id);
+    m_freeIds.push_back(id);
+    --m_occupantCount;
+}
+
+void GridOccupancy::clear() {
+    std::fill(m_cellHead.begin(), m_cellHead.end(), -1);
+    std::fill(m_cellCount.begin(), m_cellCount.end(), 0u);
+    m_cell.clear();
+    m_next.clear();
+    m_previous.clear();
+    m_centre.clear();
+    m_halfExtents.clear();
+    m_y.clear();
+    m_freeIds.clear();
+    m_occupantCount = 0;
+    m_maxHalfExtents = glm::vec2(0.0f);
+}
+
+glm::vec3 GridOccupancy::getPosition(OccupantId id) const {
+    if (!contains(id)) return glm::vec3(0.0f);
+    return glm::vec3(m_centre[id].x, m_y[id], m_centre[id].y);
+}
+
+uint32_t GridOccupancy::getCellCount(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return 0;
+    return m_cellCount[static_cast<size_t>(y) * m_width + x];
+}
+
+size_t GridOccupancy::queryCell(int x, int y, std::vector<OccupantId>& out) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return 0;
+    size_t before = out.size();
+    for (int32_t id = m_cellHead[static_cast<size_t>(y) * m_width + x]; id >= 0; id = m_next[id]) {
+        out.push_back(static_cast<OccupantId>(id));
+    }
+    return out.size() - before;
+}
+
+template <typename Accept>
+size_t GridOccupancy::gather(const glm::vec2& minXZ, const glm::vec2& maxXZ, Accept accept,
+                             std::vector<OccupantId>& out) const {
+    // An occupant filed under cell c may overhang it by up to its half extents
+    glm::ivec2 first = worldToCell(glm::vec3(minXZ.x - m_maxHalfExtents.x, 0.0f, minXZ.y - m_maxHalfExtents.y));
+    glm::ivec2 last = worldToCell(glm::vec3(maxXZ.x + m_maxHalfExtents.x, 0.0f, maxXZ.y + m_maxHalfExtents.y));
+    size_t before = out.size();
+    for (int y = first.y; y <= last.y; ++y) {
+        const int32_t* row = &m_cellHead[static_cast<size_t>(y) * m_width];
+        for (int x = first.x; x <= last.x; ++x) {
+            for (int32_t id = row[x]; id >= 0; id = m_next[id]) {
+                glm::vec2 lo = m_centre[id] - m_halfExtents[id];
+                glm::vec2 hi = m_centre[id] + m_halfExtents[id];
+                if (hi.x < minXZ.x || lo.x > maxXZ.x || hi.y < minXZ.y || lo.y > maxXZ.y) continue;
+                if (accept(lo, hi)) out.push_back(static_cast<OccupantId>(id));
+            }
+        }
+    }
+    return out.size() - before;
+}
+
+size_t GridOccupancy::queryAABB(const glm::vec2& minXZ, const glm::vec2& maxXZ, std::vector<OccupantId>& out) const {
+    return gather(minXZ, maxXZ, [](const glm::vec2&, const glm::vec2&) { return true; }, out);
+}
+
+size_t GridOccupancy::queryRadius(const glm::vec3& centre, float radius, std::vector<OccupantId>& out) const {
+    const glm::vec2 c(centre.x, centre.z);
+    const float radiusSquared = radius * radius;
+    return gather(c - glm::vec2(radius), c + glm::vec2(radius),
+        [&](const glm::vec2& lo, const glm::vec2& hi) {
+            glm::vec2 d = c - glm::clamp(c, lo, hi);
+            return glm::dot(d, d) <= radiusSquared;
+        }, out);
+}
+
+} // namespace TurtleEngine
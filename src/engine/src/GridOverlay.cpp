@@ -0,0 +1,206 @@
+#include "GridOverlay.hpp"
+#include "Grid.hpp"
+#include "UniformBuffer.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace TurtleEngine {
+
+GridOverlay::GridOverlay(const Grid& grid)
+    : m_width(grid.getWidth()), m_height(grid.getHeight()), m_cellSize(grid.getCellSize()) {
+    const size_t cells = static_cast<size_t>(m_width) * m_height;
+    m_values[0].assign(cells, 0.0f);
+    m_values[1].assign(cells, 0.0f);
+    m_initialized = initialize();
+}
+
+GridOverlay::~GridOverlay() {
+    ShaderManager::shared().release(m_shaderId);
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_VBO);
+    glDeleteTextures(1, &m_valueTexture);
+    glDeleteTextures(1, &m_paletteTexture);
+}
+
+bool GridOverlay::initialize() {
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if (m_width > maxTextureSize || m_height > maxTextureSize) {
+        std::cerr << "ERROR::GridOverlay: " << m_width << "x" << m_height
+                  << " exceeds GL_MAX_TEXTURE_SIZE (" << maxTextureSize << "), overlay disabled" << std::endl;
+        return false;
+    }
+    // Same vertex layout as the textured grid: the overlay is one more textured quad
+    m_shaderId = ShaderManager::shared().load("shaders/grid_textured.vert", "shaders/grid_overlay.frag");
+    if (m_shaderId == INVALID_SHADER) {
+        std::cerr << "ERROR::GridOverlay: Failed to load overlay shaders" << std::endl;
+        return false;
+    }
+
+    const float halfWidth = m_width * m_cellSize / 2.0f;
+    const float halfHeight = m_height * m_cellSize / 2.0f;
+    const float w = static_cast<float>(m_width);
+    const float h = static_cast<float>(m_height);
+    const float vertices[] = {
+        -halfWidth, 0.0f, -halfHeight,  0.0f, 0.0f,
+         halfWidth, 0.0f, -halfHeight,  w,    0.0f,
+         halfWidth, 0.0f,  halfHeight,  w,    h,
+        -halfWidth, 0.0f,  halfHeight,  0.0f, h,
+    };
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenTextures(1, &m_valueTexture);
+    glBindTexture(GL_TEXTURE_2D, m_valueTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, m_width, m_height, 0, GL_RED, GL_FLOAT, m_values[0].data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Linear filtering between palette entries; clamping keeps the ends exact
+    glGenTextures(1, &m_paletteTexture);
+    glBindTexture(GL_TEXTURE_1D, m_paletteTexture);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA8, PALETTE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    m_initialized = true;
+    setPalette(heatPalette());
+    return true;
+}
+
+void GridOverlay::setValue(int x, int y, float value) {
+    if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
+        m_values[m_writeIndex][static_cast<size_t>(y) * m_width + x] = value;
+    }
+}
+
+void GridOverlay::clearWriteBuffer(float value) {
+    std::fill(m_values[m_writeIndex].begin(), m_values[m_writeIndex].end(), value);
+}
+
+void GridOverlay::swap() {
+    m_writeIndex ^= 1;
+    m_pendingUpload = true;
+}
+
+float GridOverlay::getValue(int x, int y) const {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return 0.0f;
+    return m_values[m_writeIndex ^ 1][static_cast<size_t>(y) * m_width + x];
+}
+
+void GridOverlay::setRange(float minValue, float maxValue) {
+    m_minValue = minValue;
+    m_maxValue = maxValue;
+}
+
+void GridOverlay::setPalette(const std::vector<OverlayPaletteStop>& stops) {
+    if (stops.empty() || !m_initialized) return;
+    std::vector<OverlayPaletteStop> sorted = stops;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const OverlayPaletteStop& a, const OverlayPaletteStop& b) { return a.position < b.position; });
+
+    // Bake the gradient once; the shader only does a lookup
+    std::vector<uint8_t> texels(PALETTE_SIZE * 4);
+    size_t stop = 0;
+    for (int i = 0; i < PALETTE_SIZE; ++i) {
+        float t = static_cast<float>(i) / (PALETTE_SIZE - 1);
+        while (stop + 1 < sorted.size() && sorted[stop + 1].position <= t) ++stop;
+        glm::vec4 color = sorted[stop].color;
+        if (stop + 1 < sorted.size() && t > sorted[stop].position) {
+            float span = sorted[stop + 1].position - sorted[stop].position;
+            color = glm::mix(sorted[stop].color, sorted[stop + 1].color, (t - sorted[stop].position) / span);
+        }
+        for (int c = 0; c < 4; ++c) {
+            texels[i * 4 + c] = static_cast<uint8_t>(std::clamp(color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+    glBindTexture(GL_TEXTURE_1D, m_paletteTexture);
+    glTexSubImage1D(GL_TEXTURE_1D, 0, 0, PALETTE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
+
+std::vector<OverlayPaletteStop> GridOverlay::heatPalette() {
+    // Zero is see-through, so untouched cells show the grid underneath
+    return {
+        { 0.0f,  glm::vec4(0.0f, 0.0f, 1.0f, 0.0f) },
+        { 0.25f, glm::vec4(0.0f, 0.4f, 1.0f, 0.6f) },
+        { 0.5f,  glm::vec4(0.0f, 1.0f, 0.2f, 0.7f) },
+        { 0.75f, glm::vec4(1.0f, 1.0f, 0.0f, 0.8f) },
+        { 1.0f,  glm::vec4(1.0f, 0.0f, 0.0f, 0.9f) },
+    };
+}
+
+void GridOverlay::uploadValues() {
+    glBindTexture(GL_TEXTURE_2D, m_valueTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RED, GL_FLOAT, m_values[m_writeIndex ^ 1].data());
+    m_lastUploadBytes = m_values[0].size() * sizeof(float);
+    m_pendingUpload = false;
+}
+
+void GridOverlay::render(const glm::mat4& projection, const glm::mat4& view) {
+    if (!m_initialized || !m_visible) return;
+    m_lastUploadBytes = 0;
+
+    // Looked up each frame: a reload replaces the program
+    Shader& shader = ShaderManager::shared().get(m_shaderId);
+    shader.use();
+    // Sampler units are program state: set once per linked program
+    if (shader.getProgram() != m_samplerProgram) {
+        shader.setInt("overlayValues", 0);
+        shader.setInt("palette", 1);
+        m_samplerProgram = shader.getProgram();
+    }
+    FrameUniforms::shared().setCamera(view, projection);
+    shader.setMat4("model", glm::mat4(1.0f));
+    const float span = m_maxValue - m_minValue;
+    shader.setFloat("valueMin", m_minValue);
+    shader.setFloat("valueScale", span != 0.0f ? 1.0f / span : 0.0f);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_valueTexture);
+    if (m_pendingUpload) uploadValues();
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_1D, m_paletteTexture);
+
+    // Coplanar with the grid: pull it forward in depth instead of lifting the quad.
+    // The blend and depth state is put back afterwards for later draws.
+    const GLboolean blend = glIsEnabled(GL_BLEND);
+    GLint blendSource = GL_ONE, blendDestination = GL_ZERO;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource);
+    glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination);
+    GLboolean depthMask = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(-1.0f, -1.0f);
+    glDepthMask(GL_FALSE);
+
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    glBindVertexArray(0);
+
+    glDepthMask(depthMask);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBlendFunc(static_cast<GLenum>(blendSource), static_cast<GLenum>(blendDestination));
+    if (!blend) glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+}
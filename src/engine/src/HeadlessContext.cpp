@@ -0,0 +1,201 @@
+#include "HeadlessContext.hpp"
+#include <GL/glew.h>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#if defined(__linux__) && __has_include(<EGL/egl.h>)
+#define TURTLE_HEADLESS_EGL 1
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <dlfcn.h>
+#endif
+
+namespace TurtleEngine {
+
+#ifdef TURTLE_HEADLESS_EGL
+namespace {
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+    constexpr EGLenum EGL_PLATFORM_SURFACELESS_MESA = 0x31DD;
+#endif
+
+    // The EGL entry points in use, resolved from the loaded library
+    struct EglApi {
+        PFNEGLGETPROCADDRESSPROC getProcAddress = nullptr;
+        PFNEGLQUERYSTRINGPROC queryString = nullptr;
+        PFNEGLGETDISPLAYPROC getDisplay = nullptr;
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = nullptr; // Null without EGL_EXT_platform_base
+        PFNEGLINITIALIZEPROC initialize = nullptr;
+        PFNEGLTERMINATEPROC terminate = nullptr;
+        PFNEGLBINDAPIPROC bindApi = nullptr;
+        PFNEGLCHOOSECONFIGPROC chooseConfig = nullptr;
+        PFNEGLCREATECONTEXTPROC createContext = nullptr;
+        PFNEGLDESTROYCONTEXTPROC destroyContext = nullptr;
+        PFNEGLCREATEPBUFFERSURFACEPROC createPbufferSurface = nullptr;
+        PFNEGLDESTROYSURFACEPROC destroySurface = nullptr;
+        PFNEGLMAKECURRENTPROC makeCurrent = nullptr;
+    };
+
+    bool loadEgl(void* library, EglApi& egl) {
+        egl.getProcAddress = reinterpret_cast<PFNEGLGETPROCADDRESSPROC>(dlsym(library, "eglGetProcAddress"));
+        if (!egl.getProcAddress) return false;
+        auto load = [&](auto& function, const char* name) {
+            function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(egl.getProcAddress(name));
+            return function != nullptr;
+        };
+        load(egl.getPlatformDisplay, "eglGetPlatformDisplayEXT");
+        return load(egl.queryString, "eglQueryString") && load(egl.getDisplay, "eglGetDisplay") &&
+               load(egl.initialize, "eglInitialize") && load(egl.terminate, "eglTerminate") &&
+               load(egl.bindApi, "eglBindAPI") && load(egl.chooseConfig, "eglChooseConfig") &&
+               load(egl.createContext, "eglCreateContext") && load(egl.destroyContext, "eglDestroyContext") &&
+               load(egl.createPbufferSurface, "eglCreatePbufferSurface") &&
+               load(egl.destroySurface, "eglDestroySurface") && load(egl.makeCurrent, "eglMakeCurrent");
+    }
+
+    bool hasExtension(const char* extensions, const char* name) {
+        if (!extensions) return false;
+        const size_t length = std::strlen(name);
+        for (const char* at = std::strstr(extensions, name); at; at = std::strstr(at + length, name)) {
+            const bool starts = at == extensions || at[-1] == ' ';
+            const bool ends = at[length] == ' ' || at[length] == '\0';
+            if (starts && ends) return true;
+        }
+        return false;
+    }
+}
+#endif
+
+HeadlessContext::HeadlessContext() = default;
+
+HeadlessContext::~HeadlessContext() {
+    cleanup();
+}
+
+bool HeadlessContext::initialize(int majorVersion, int minorVersion) {
+    if (isValid()) return true;
+    if (!createContext(majorVersion, minorVersion)) {
+        cleanup();
+        return false;
+    }
+
+    glewExperimental = GL_TRUE;
+    GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLX builds of GLEW load the GL entry points first, then fail looking for an
+    // X display that a headless context does not need
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY) err = GLEW_OK;
+#endif
+    if (err != GLEW_OK) {
+        std::cerr << "ERROR::HeadlessContext: GLEW initialization failed: " << glewGetErrorString(err) << std::endl;
+        cleanup();
+        return false;
+    }
+    while (glGetError() != GL_NO_ERROR) {} // glewInit can leave GL_INVALID_ENUM behind on core profiles
+    return true;
+}
+
+bool HeadlessContext::createContext(int majorVersion, int minorVersion) {
+#ifdef TURTLE_HEADLESS_EGL
+    m_library = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (!m_library) {
+        std::cerr << "ERROR::HeadlessContext: libEGL.so.1 not found" << std::endl;
+        return false;
+    }
+    EglApi egl;
+    if (!loadEgl(m_library, egl)) {
+        std::cerr << "ERROR::HeadlessContext: libEGL is missing entry points" << std::endl;
+        return false;
+    }
+
+    // Client extensions need EGL_NO_DISPLAY
+    const char* clientExtensions = egl.queryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    EGLDisplay display = EGL_NO_DISPLAY;
+    if (egl.getPlatformDisplay && hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        display = egl.getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = egl.getDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !egl.initialize(display, &major, &minor)) {
+        std::cerr << "ERROR::HeadlessContext: No EGL display" << std::endl;
+        return false;
+    }
+    m_display = display;
+
+    if (!egl.bindApi(EGL_OPENGL_API)) {
+        std::cerr << "ERROR::HeadlessContext: EGL driver has no desktop OpenGL" << std::endl;
+        return false;
+    }
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!egl.chooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        std::cerr << "ERROR::HeadlessContext: No EGL config for OpenGL" << std::endl;
+        return false;
+    }
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, majorVersion,
+        EGL_CONTEXT_MINOR_VERSION, minorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    m_context = egl.createContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (!m_context) {
+        std::cerr << "ERROR::HeadlessContext: Cannot create an OpenGL " << majorVersion << "." << minorVersion
+                  << " core context" << std::endl;
+        return false;
+    }
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (hasExtension(egl.queryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        m_backend = "EGL surfaceless";
+    } else {
+        const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = egl.createPbufferSurface(display, config, pbufferAttributes);
+        if (surface == EGL_NO_SURFACE) {
+            std::cerr << "ERROR::HeadlessContext: Cannot create a pbuffer surface" << std::endl;
+            return false;
+        }
+        m_surface = surface;
+        m_backend = "EGL pbuffer";
+    }
+    if (!egl.makeCurrent(display, surface, surface, m_context)) {
+        std::cerr << "ERROR::HeadlessContext: Cannot make the context current" << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void)majorVersion;
+    (void)minorVersion;
+    std::cerr << "ERROR::HeadlessContext: Not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+void HeadlessContext::cleanup() {
+#ifdef TURTLE_HEADLESS_EGL
+    if (!m_library) return;
+    EglApi egl;
+    if (loadEgl(m_library, egl) && m_display) {
+        egl.makeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_surface) egl.destroySurface(m_display, m_surface);
+        if (m_context) egl.destroyContext(m_display, m_context);
+        egl.terminate(m_display);
+    }
+    dlclose(m_library);
+#endif
+    m_library = nullptr;
+    m_display = nullptr;
+    m_context = nullptr;
+    m_surface = nullptr;
+    m_backend.clear();
+}
+
+} // namespace TurtleEngine
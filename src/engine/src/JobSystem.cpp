@@ -0,0 +1,107 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+namespace TurtleEngine {
+
+namespace {
+    thread_local bool t_insideJob = false;
+}
+
+JobSystem::JobSystem(size_t workerCount) {
+    if (workerCount == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+JobSystem& JobSystem::shared() {
+    static JobSystem instance;
+    return instance;
+}
+
+void JobSystem::parallelFor(size_t count, size_t minBatch, const std::function<void(size_t, size_t)>& job) {
+    if (count == 0) return;
+    minBatch = std::max<size_t>(minBatch, 1);
+
+    // Small ranges, nested calls and empty pools are not worth a hand-off
+    if (m_workers.empty() || count <= minBatch || t_insideJob) {
+        job(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submitMutex);
+
+    // A few batches per thread so uneven batches balance out
+    size_t batchCount = std::min(getConcurrency() * 4, (count + minBatch - 1) / minBatch);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_count = count;
+        m_batchSize = (count + batchCount - 1) / batchCount;
+        m_batchCount = (count + m_batchSize - 1) / m_batchSize;
+        m_nextBatch = 0;
+        m_finishedBatches = 0;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runBatches(job);
+
+    // Wait for the last batch and for every worker to let go of the job
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_finishedBatches == m_batchCount && m_activeWorkers == 0; });
+    m_job = nullptr;
+}
+
+void JobSystem::runBatches(const std::function<void(size_t, size_t)>& job) {
+    t_insideJob = true;
+    for (;;) {
+        size_t batch = m_nextBatch.fetch_add(1);
+        if (batch >= m_batchCount) break;
+        size_t begin = batch * m_batchSize;
+        size_t end = std::min(begin + m_batchSize, m_count);
+        job(begin, end);
+        m_finishedBatches.fetch_add(1);
+    }
+    t_insideJob = false;
+}
+
+void JobSystem::workerLoop() {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        const std::function<void(size_t, size_t)>* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || (m_job && m_generation != seenGeneration); });
+            if (m_stop) return;
+            seenGeneration = m_generation;
+            job = m_job;
+            ++m_activeWorkers;
+        }
+
+        runBatches(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeWorkers;
+        }
+        m_done.notify_all();
+    }
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,230 @@
+#include "LightClusters.hpp"
+#include "UniformBuffer.hpp"
+#include "Frustum.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr size_t SLICE_CLUSTERS = static_cast<size_t>(LightClusters::GRID_X) * LightClusters::GRID_Y;
+    constexpr float MIN_NEAR = 0.01f; // Exponential slices need a positive near plane
+
+    enum BufferSlot { LIGHTS = 0, RANGES, INDICES, SLOT_COUNT };
+
+    glm::vec3 unproject(const glm::mat4& inverseProjection, float x, float y, float z) {
+        glm::vec4 p = inverseProjection * glm::vec4(x, y, z, 1.0f);
+        return glm::vec3(p) / p.w;
+    }
+
+    // Same as the lighting shader's slice lookup, clamped to the grid
+    int sliceFor(const glm::vec4& depthParams, float viewDepth) {
+        const float slice = std::log(std::max(viewDepth, 1e-4f)) * depthParams.z + depthParams.w;
+        return std::clamp(static_cast<int>(std::floor(slice)), 0, LightClusters::GRID_Z - 1);
+    }
+}
+
+LightClusters::~LightClusters() {
+    cleanup();
+}
+
+void LightClusters::computeBounds(const glm::mat4& projection) {
+    const glm::mat4 inverseProjection = glm::inverse(projection);
+    const float nearPlane = std::max(-unproject(inverseProjection, 0.0f, 0.0f, -1.0f).z, MIN_NEAR);
+    const float farPlane = std::max(-unproject(inverseProjection, 0.0f, 0.0f, 1.0f).z, nearPlane * 1.001f);
+    const float logRatio = std::log(farPlane / nearPlane);
+    m_depthParams = glm::vec4(nearPlane, farPlane, GRID_Z / logRatio, -GRID_Z * std::log(nearPlane) / logRatio);
+
+    m_minX.resize(CLUSTER_COUNT); m_minY.resize(CLUSTER_COUNT); m_minZ.resize(CLUSTER_COUNT);
+    m_maxX.resize(CLUSTER_COUNT); m_maxY.resize(CLUSTER_COUNT); m_maxZ.resize(CLUSTER_COUNT);
+
+    // Corner rays of every tile, as near- and far-plane points; works for both
+    // perspective and orthographic projections
+    glm::vec3 nearPoints[GRID_Y + 1][GRID_X + 1];
+    glm::vec3 farPoints[GRID_Y + 1][GRID_X + 1];
+    for (int y = 0; y <= GRID_Y; ++y) {
+        for (int x = 0; x <= GRID_X; ++x) {
+            const float ndcX = -1.0f + 2.0f * x / GRID_X;
+            const float ndcY = -1.0f + 2.0f * y / GRID_Y;
+            nearPoints[y][x] = unproject(inverseProjection, ndcX, ndcY, -1.0f);
+            farPoints[y][x] = unproject(inverseProjection, ndcX, ndcY, 1.0f);
+        }
+    }
+
+    for (int z = 0; z < GRID_Z; ++z) {
+        const float sliceNear = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / GRID_Z);
+        const float sliceFar = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z + 1) / GRID_Z);
+        for (int y = 0; y < GRID_Y; ++y) {
+            for (int x = 0; x < GRID_X; ++x) {
+                // The froxel is the hull of its 8 corners, so their box bounds it
+                glm::vec3 lo(INFINITY), hi(-INFINITY);
+                for (int corner = 0; corner < 4; ++corner) {
+                    const glm::vec3& a = nearPoints[y + (corner >> 1)][x + (corner & 1)];
+                    const glm::vec3& b = farPoints[y + (corner >> 1)][x + (corner & 1)];
+                    for (float depth : { sliceNear, sliceFar }) {
+                        const float t = (depth + a.z) / (a.z - b.z);
+                        const glm::vec3 p = a + (b - a) * t;
+                        lo = glm::min(lo, p);
+                        hi = glm::max(hi, p);
+                    }
+                }
+                const size_t c = clusterIndex(x, y, z);
+                m_minX[c] = lo.x; m_minY[c] = lo.y; m_minZ[c] = lo.z;
+                m_maxX[c] = hi.x; m_maxY[c] = hi.y; m_maxZ[c] = hi.z;
+            }
+        }
+    }
+    m_projection = projection;
+}
+
+int LightClusters::sliceOf(float viewDepth) const {
+    return sliceFor(m_depthParams, viewDepth);
+}
+
+void LightClusters::build(const glm::mat4& view, const glm::mat4& projection, const LightData* lights, size_t count, JobSystem* jobs) {
+    m_stats = LightClusterStats();
+    count = std::min(count, MAX_LIGHTS);
+    m_stats.lights = count;
+    if (std::memcmp(&m_projection, &projection, sizeof(projection)) != 0) {
+        computeBounds(projection);
+    }
+    m_bins.resize(CLUSTER_COUNT);
+
+    // Frustum cull, then move the survivors to view space
+    const Frustum frustum = Frustum::fromMatrix(projection * view);
+    m_lightX.clear(); m_lightY.clear(); m_lightZ.clear(); m_lightRadius.clear();
+    m_lightIndex.clear(); m_firstSlice.clear(); m_lastSlice.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3 center(lights[i].positionRadius);
+        const float radius = lights[i].positionRadius.w;
+        if (radius <= 0.0f || !frustum.intersectsSphere(center, radius)) continue;
+        const glm::vec3 v = glm::vec3(view * glm::vec4(center, 1.0f));
+        m_lightX.push_back(v.x);
+        m_lightY.push_back(v.y);
+        m_lightZ.push_back(v.z);
+        m_lightRadius.push_back(radius);
+        m_lightIndex.push_back(static_cast<uint32_t>(i));
+        m_firstSlice.push_back(sliceOf(-v.z - radius));
+        m_lastSlice.push_back(sliceOf(-v.z + radius));
+    }
+    m_stats.visibleLights = m_lightIndex.size();
+
+    // Each slice writes only its own froxels' bins
+    auto binSlices = [this](size_t begin, size_t end) {
+        for (size_t z = begin; z < end; ++z) binSlice(static_cast<int>(z));
+    };
+    if (jobs != nullptr && m_lightIndex.size() >= PARALLEL_THRESHOLD) {
+        jobs->parallelFor(GRID_Z, 1, binSlices);
+    } else {
+        binSlices(0, GRID_Z);
+    }
+
+    // Flatten into (offset, count) ranges over one index list
+    m_ranges.resize(CLUSTER_COUNT * 2);
+    m_indices.clear();
+    for (size_t c = 0; c < CLUSTER_COUNT; ++c) {
+        m_ranges[2 * c] = static_cast<uint32_t>(m_indices.size());
+        m_ranges[2 * c + 1] = static_cast<uint32_t>(m_bins[c].size());
+        m_indices.insert(m_indices.end(), m_bins[c].begin(), m_bins[c].end());
+        m_stats.maxPerCluster = std::max(m_stats.maxPerCluster, m_bins[c].size());
+    }
+    m_stats.references = m_indices.size();
+}
+
+void LightClusters::binSlice(int slice) {
+    const size_t base = static_cast<size_t>(slice) * SLICE_CLUSTERS;
+    for (size_t c = 0; c < SLICE_CLUSTERS; ++c) m_bins[base + c].clear();
+
+    const float* minX = &m_minX[base]; const float* minY = &m_minY[base]; const float* minZ = &m_minZ[base];
+    const float* maxX = &m_maxX[base]; const float* maxY = &m_maxY[base]; const float* maxZ = &m_maxZ[base];
+    uint8_t hit[SLICE_CLUSTERS];
+    for (size_t l = 0; l < m_lightIndex.size(); ++l) {
+        if (slice < m_firstSlice[l] || slice > m_lastSlice[l]) continue;
+        const float x = m_lightX[l], y = m_lightY[l], z = m_lightZ[l];
+        const float radiusSquared = m_lightRadius[l] * m_lightRadius[l];
+        // Sphere against every froxel box of the slice; no branches, so it vectorises
+        for (size_t c = 0; c < SLICE_CLUSTERS; ++c) {
+            const float dx = std::max(minX[c] - x, 0.0f) + std::max(x - maxX[c], 0.0f);
+            const float dy = std::max(minY[c] - y, 0.0f) + std::max(y - maxY[c], 0.0f);
+            const float dz = std::max(minZ[c] - z, 0.0f) + std::max(z - maxZ[c], 0.0f);
+            hit[c] = static_cast<uint8_t>(dx * dx + dy * dy + dz * dz <= radiusSquared);
+        }
+        for (size_t c = 0; c < SLICE_CLUSTERS; ++c) {
+            if (hit[c]) m_bins[base + c].push_back(m_lightIndex[l]);
+        }
+    }
+}
+
+const uint32_t* LightClusters::getClusterLights(size_t cluster, size_t& count) const {
+    if (cluster >= CLUSTER_COUNT || m_ranges.empty()) {
+        count = 0;
+        return nullptr;
+    }
+    count = m_ranges[2 * cluster + 1];
+    return m_indices.data() + m_ranges[2 * cluster];
+}
+
+bool LightClusters::upload(const LightData* lights, size_t count) {
+    count = std::min(count, MAX_LIGHTS);
+    if (m_buffers[LIGHTS] == 0) {
+        glGenBuffers(SLOT_COUNT, m_buffers);
+        glGenTextures(SLOT_COUNT, m_textures);
+        if (m_buffers[LIGHTS] == 0 || m_textures[LIGHTS] == 0) {
+            std::cerr << "ERROR::LightClusters: Failed to create texture buffers" << std::endl;
+            cleanup();
+            return false;
+        }
+        const GLenum formats[SLOT_COUNT] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+        for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+            glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[slot]);
+            glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+            glBindTexture(GL_TEXTURE_BUFFER, m_textures[slot]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[slot], m_buffers[slot]);
+        }
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    m_lightTexels.resize(std::max<size_t>(count, 1) * 2, glm::vec4(0.0f));
+    for (size_t i = 0; i < count; ++i) {
+        m_lightTexels[2 * i] = lights[i].positionRadius;
+        m_lightTexels[2 * i + 1] = lights[i].colorIntensity;
+    }
+    if (m_ranges.empty()) m_ranges.assign(CLUSTER_COUNT * 2, 0);
+    if (m_indices.empty()) m_indices.push_back(0); // Never sized zero; no range points at it
+
+    // Orphan and refill; the data changes whenever the camera or lights do
+    const void* data[SLOT_COUNT] = { m_lightTexels.data(), m_ranges.data(), m_indices.data() };
+    const size_t sizes[SLOT_COUNT] = { m_lightTexels.size() * sizeof(glm::vec4), m_ranges.size() * sizeof(uint32_t),
+                                       m_indices.size() * sizeof(uint32_t) };
+    for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+        glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[slot]);
+        glBufferData(GL_TEXTURE_BUFFER, sizes[slot], data[slot], GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    bind();
+    return true;
+}
+
+void LightClusters::bind() const {
+    const GLint units[SLOT_COUNT] = { CLUSTER_LIGHTS_UNIT, CLUSTER_RANGES_UNIT, CLUSTER_INDICES_UNIT };
+    for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+        glActiveTexture(GL_TEXTURE0 + units[slot]);
+        glBindTexture(GL_TEXTURE_BUFFER, m_textures[slot]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LightClusters::cleanup() {
+    if (m_buffers[LIGHTS] != 0) {
+        glDeleteBuffers(SLOT_COUNT, m_buffers);
+        glDeleteTextures(SLOT_COUNT, m_textures);
+        std::fill(std::begin(m_buffers), std::end(m_buffers), 0u);
+        std::fill(std::begin(m_textures), std::end(m_textures), 0u);
+    }
+}
+
+} // namespace TurtleEngine
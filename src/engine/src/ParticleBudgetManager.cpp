@@ -0,0 +1,71 @@
+#include "ParticleBudgetManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace TurtleEngine {
+
+void ParticleBudgetManager::reportCost(float updateMs, float renderMs) {
+    m_counters.updateMs = updateMs;
+    m_counters.renderMs = renderMs;
+
+    float cost = updateMs + renderMs;
+    if (!m_hasCostSample) {
+        m_counters.smoothedCostMs = cost;
+        m_hasCostSample = true;
+    } else {
+        m_counters.smoothedCostMs += (cost - m_counters.smoothedCostMs) * m_settings.costSmoothing;
+    }
+
+    if (!m_settings.enabled || m_settings.frameBudgetMs <= 0.0f) {
+        m_counters.pressure = 0.0f;
+        std::fill(std::begin(m_counters.spawnScale), std::end(m_counters.spawnScale), 1.0f);
+        return;
+    }
+
+    m_counters.pressure = m_counters.smoothedCostMs / m_settings.frameBudgetMs;
+
+    // 0 below the threshold, 1 at (or over) the full budget
+    float headroom = std::max(1.0f - m_settings.pressureThreshold, 1e-3f);
+    float reduction = std::clamp((m_counters.pressure - m_settings.pressureThreshold) / headroom, 0.0f, 1.0f);
+
+    // Spread the reduction over the tiers so the lowest priority is cut fully
+    // before the next one starts to shrink
+    float throttle = reduction * PARTICLE_PRIORITY_LEVELS;
+    for (int level = 0; level < PARTICLE_PRIORITY_LEVELS; ++level) {
+        float cut = std::clamp(throttle - static_cast<float>(level), 0.0f, 1.0f);
+        m_counters.spawnScale[level] = 1.0f - cut * (1.0f - m_settings.minSpawnScale);
+    }
+}
+
+float ParticleBudgetManager::getSpawnScale(int priority) const {
+    priority = std::clamp(priority, 0, PARTICLE_PRIORITY_LEVELS - 1);
+    return m_counters.spawnScale[priority];
+}
+
+void ParticleBudgetManager::beginFrame() {
+    m_counters.spawnsRequested = 0;
+    m_counters.spawnsSuppressed = 0;
+    m_counters.spawnsDropped = 0;
+    m_counters.culledByDistance = 0;
+    m_counters.culledByFrustum = 0;
+}
+
+void ParticleBudgetManager::recordSpawns(size_t requested, size_t suppressed) {
+    m_counters.spawnsRequested += requested;
+    m_counters.spawnsSuppressed += suppressed;
+}
+
+void ParticleBudgetManager::endFrame() {
+    // Fewer, larger points: grow size with 1/sqrt of the fraction actually spawned,
+    // which keeps roughly the same screen coverage
+    if (m_counters.spawnsRequested > 0) {
+        float kept = 1.0f - static_cast<float>(m_counters.spawnsSuppressed) / m_counters.spawnsRequested;
+        float target = kept > 0.0f ? 1.0f / std::sqrt(kept) : m_settings.maxPointSizeScale;
+        m_counters.pointSizeScale = std::clamp(target, 1.0f, m_settings.maxPointSizeScale);
+    } else if (m_counters.pressure < m_settings.pressureThreshold) {
+        m_counters.pointSizeScale = 1.0f;
+    }
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,258 @@
+#include "ParticleCollider.hpp"
+#include "ParticleSimulation.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr size_t BATCH_SIZE = 256;              // Particles gathered into SoA at a time
+    constexpr size_t PARALLEL_THRESHOLD = 16 * 1024; // Below this one thread is faster
+    constexpr size_t MIN_BUCKETS = 64;
+    constexpr float CONTACT_OFFSET = 1e-4f;         // Keeps resolved particles just outside the surface
+
+    enum CandidateBits : uint8_t {
+        HIT_GROUND = 1,
+        NEAR_HITBOXES = 2
+    };
+
+    // floor() without the libm call, so the batch loops vectorise
+    inline int cellCoord(float value, float inverseCellSize) {
+        float scaled = value * inverseCellSize;
+        int truncated = static_cast<int>(scaled);
+        return truncated - (scaled < static_cast<float>(truncated));
+    }
+
+    inline glm::ivec3 cellOf(const glm::vec3& point, float inverseCellSize) {
+        return glm::ivec3(cellCoord(point.x, inverseCellSize), cellCoord(point.y, inverseCellSize), cellCoord(point.z, inverseCellSize));
+    }
+}
+
+void ParticleCollider::setGroundPlane(float height, const glm::vec2& minXZ, const glm::vec2& maxXZ) {
+    m_groundHeight = height;
+    m_groundMin = minXZ;
+    m_groundMax = maxXZ;
+    m_hasGround = true;
+}
+
+uint32_t ParticleCollider::bucketOf(int x, int y, int z) const {
+    uint32_t h = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u ^ static_cast<uint32_t>(z) * 83492791u;
+    return h & m_bucketMask;
+}
+
+void ParticleCollider::setHitboxes(const HitboxAABB* hitboxes, size_t count) {
+    m_boxMin.resize(count);
+    m_boxMax.resize(count);
+    m_bucketEntries.clear();
+    if (count == 0) {
+        m_bucketStart.assign(2, 0);
+        m_bucketMask = 0;
+        return;
+    }
+
+    m_inverseCellSize = 1.0f / std::max(m_settings.hashCellSize, 1e-3f);
+    m_boundsMin = glm::vec3(INFINITY);
+    m_boundsMax = glm::vec3(-INFINITY);
+    size_t insertions = 0;
+    for (size_t i = 0; i < count; ++i) {
+        m_boxMin[i] = hitboxes[i].center - hitboxes[i].halfExtents;
+        m_boxMax[i] = hitboxes[i].center + hitboxes[i].halfExtents;
+        m_boundsMin = glm::min(m_boundsMin, m_boxMin[i]);
+        m_boundsMax = glm::max(m_boundsMax, m_boxMax[i]);
+
+        glm::ivec3 lo = cellOf(m_boxMin[i], m_inverseCellSize);
+        glm::ivec3 hi = cellOf(m_boxMax[i], m_inverseCellSize);
+        insertions += static_cast<size_t>(hi.x - lo.x + 1) * (hi.y - lo.y + 1) * (hi.z - lo.z + 1);
+    }
+
+    // Power-of-two bucket count with a load factor of at most 0.25; sparse buckets
+    // keep unrelated cells from sharing a list
+    size_t buckets = MIN_BUCKETS;
+    while (buckets < insertions * 4) buckets <<= 1;
+    m_bucketMask = static_cast<uint32_t>(buckets - 1);
+
+    // Counting sort of (bucket, hitbox) pairs into one flat array
+    auto forEachCell = [&](size_t box, auto&& visit) {
+        glm::ivec3 lo = cellOf(m_boxMin[box], m_inverseCellSize);
+        glm::ivec3 hi = cellOf(m_boxMax[box], m_inverseCellSize);
+        for (int z = lo.z; z <= hi.z; ++z)
+            for (int y = lo.y; y <= hi.y; ++y)
+                for (int x = lo.x; x <= hi.x; ++x)
+                    visit(bucketOf(x, y, z));
+    };
+
+    m_bucketStart.assign(buckets + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        forEachCell(i, [&](uint32_t bucket) { ++m_bucketStart[bucket + 1]; });
+    }
+    for (size_t b = 0; b < buckets; ++b) {
+        m_bucketStart[b + 1] += m_bucketStart[b];
+    }
+    m_bucketEntries.resize(insertions);
+    std::vector<uint32_t> cursor(m_bucketStart.begin(), m_bucketStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        forEachCell(i, [&](uint32_t bucket) { m_bucketEntries[cursor[bucket]++] = static_cast<uint32_t>(i); });
+    }
+}
+
+bool ParticleCollider::findHitbox(uint32_t bucket, const glm::vec3& from, const glm::vec3& to, int32_t& hitbox, float& entryT, glm::vec3& normal) const {
+    const glm::vec3 delta = to - from;
+    bool found = false;
+
+    for (uint32_t e = m_bucketStart[bucket]; e < m_bucketStart[bucket + 1]; ++e) {
+        uint32_t box = m_bucketEntries[e];
+        const glm::vec3& lo = m_boxMin[box];
+        const glm::vec3& hi = m_boxMax[box];
+
+        // Entered this step: inside now, outside before
+        bool insideNow = to.x > lo.x && to.x < hi.x && to.y > lo.y && to.y < hi.y && to.z > lo.z && to.z < hi.z;
+        bool insideBefore = from.x > lo.x && from.x < hi.x && from.y > lo.y && from.y < hi.y && from.z > lo.z && from.z < hi.z;
+        if (!insideNow || insideBefore) continue;
+
+        // Latest slab entry along the step gives the face that was crossed
+        float t = 0.0f;
+        glm::vec3 n(0.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            if (delta[axis] == 0.0f) continue;
+            float side = delta[axis] > 0.0f ? lo[axis] : hi[axis];
+            float axisT = (side - from[axis]) / delta[axis];
+            if (axisT >= t) {
+                t = axisT;
+                n = glm::vec3(0.0f);
+                n[axis] = delta[axis] > 0.0f ? -1.0f : 1.0f;
+            }
+        }
+        if (n == glm::vec3(0.0f)) continue; // Started on the surface
+
+        if (!found || t < entryT) {
+            found = true;
+            hitbox = static_cast<int32_t>(box);
+            entryT = t;
+            normal = n;
+        }
+    }
+    return found;
+}
+
+void ParticleCollider::respond(Particle& p, ParticleCollisionResponse response, const glm::vec3& contact, const glm::vec3& normal) const {
+    switch (response) {
+        case ParticleCollisionResponse::BOUNCE: {
+            float normalSpeed = glm::dot(p.velocity, normal);
+            glm::vec3 tangent = p.velocity - normal * normalSpeed;
+            p.velocity = tangent * (1.0f - m_settings.friction) - normal * (normalSpeed * m_settings.restitution);
+            p.position = contact + normal * CONTACT_OFFSET;
+            break;
+        }
+        case ParticleCollisionResponse::STICK:
+            p.velocity = glm::vec3(0.0f);
+            p.position = contact + normal * CONTACT_OFFSET;
+            break;
+        case ParticleCollisionResponse::DIE:
+            p.position = contact;
+            p.life = 0.0f;
+            break;
+        default:
+            break;
+    }
+}
+
+void ParticleCollider::collideRange(std::vector<Particle>& particles, const ParticlePositionStream& stream, size_t begin, size_t end,
+                                    const ParticleCollisionResponse* responses, size_t responseCount,
+                                    std::vector<ParticleHitEvent>& events) const {
+    const bool hasBoxes = !m_boxMin.empty();
+    const float groundY = m_hasGround ? m_groundHeight : -INFINITY;
+
+    uint32_t bucket[BATCH_SIZE];
+    uint8_t candidate[BATCH_SIZE];
+
+    for (size_t base = begin; base < end; base += BATCH_SIZE) {
+        const size_t n = std::min(BATCH_SIZE, end - base);
+        const float* px = &stream.x[base];
+        const float* py = &stream.y[base];
+        const float* pz = &stream.z[base];
+        const float* prevY = &stream.previousY[base];
+
+        // Branch-free reject: most particles are nowhere near anything
+        for (size_t i = 0; i < n; ++i) {
+            bool ground = (py[i] < groundY) & (prevY[i] >= groundY) &
+                          (px[i] >= m_groundMin.x) & (px[i] <= m_groundMax.x) &
+                          (pz[i] >= m_groundMin.y) & (pz[i] <= m_groundMax.y);
+            bool nearBoxes = hasBoxes &
+                             (px[i] > m_boundsMin.x) & (px[i] < m_boundsMax.x) &
+                             (py[i] > m_boundsMin.y) & (py[i] < m_boundsMax.y) &
+                             (pz[i] > m_boundsMin.z) & (pz[i] < m_boundsMax.z);
+            candidate[i] = static_cast<uint8_t>((ground ? HIT_GROUND : 0) | (nearBoxes ? NEAR_HITBOXES : 0));
+
+            bucket[i] = bucketOf(cellCoord(px[i], m_inverseCellSize), cellCoord(py[i], m_inverseCellSize),
+                                 cellCoord(pz[i], m_inverseCellSize));
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            // Near the hitboxes but in an empty bucket: nothing to test
+            if ((candidate[i] & NEAR_HITBOXES) && m_bucketStart[bucket[i]] == m_bucketStart[bucket[i] + 1]) {
+                candidate[i] &= ~NEAR_HITBOXES;
+            }
+            if (!candidate[i]) continue;
+
+            const size_t index = base + i;
+            const glm::vec3 from(stream.previousX[index], prevY[i], stream.previousZ[index]);
+            const glm::vec3 to(px[i], py[i], pz[i]);
+            glm::vec3 contact, normal;
+            int32_t hitbox = -1;
+            if (candidate[i] & HIT_GROUND) {
+                float t = (from.y - groundY) / (from.y - to.y);
+                contact = glm::mix(from, to, t);
+                contact.y = groundY;
+                normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            } else {
+                float t = 0.0f;
+                if (!findHitbox(bucket[i], from, to, hitbox, t, normal)) continue;
+                contact = glm::mix(from, to, t);
+            }
+
+            // Only real contacts read the particle itself
+            const uint32_t slot = stream.slots[index];
+            Particle& p = particles[slot];
+            ParticleCollisionResponse response = m_settings.looseResponse;
+            if (p.emitter >= 0 && static_cast<size_t>(p.emitter) < responseCount) {
+                response = responses[p.emitter];
+            }
+            if (response == ParticleCollisionResponse::NONE) continue;
+
+            float impactSpeed = -glm::dot(p.velocity, normal);
+            respond(p, response, contact, normal);
+            events.push_back(ParticleHitEvent{slot, p.emitter, hitbox, response, contact, normal, impactSpeed});
+        }
+    }
+}
+
+void ParticleCollider::collide(std::vector<Particle>& particles, const ParticlePositionStream& stream,
+                               const ParticleCollisionResponse* responses, size_t responseCount,
+                               std::vector<ParticleHitEvent>& events, JobSystem* jobs) {
+    const size_t count = stream.size();
+    if (count == 0 || !hasColliders()) return;
+
+    if (!jobs || count < PARALLEL_THRESHOLD || jobs->getWorkerCount() == 0) {
+        collideRange(particles, stream, 0, count, responses, responseCount, events);
+        return;
+    }
+
+    // Contiguous chunks, merged in order so the event list does not depend on scheduling
+    const size_t chunkCount = jobs->getConcurrency();
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    m_chunkEvents.resize(chunkCount);
+    jobs->parallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            m_chunkEvents[chunk].clear();
+            size_t first = chunk * chunkSize;
+            if (first >= count) continue;
+            collideRange(particles, stream, first, std::min(first + chunkSize, count), responses, responseCount, m_chunkEvents[chunk]);
+        }
+    });
+    for (const std::vector<ParticleHitEvent>& chunk : m_chunkEvents) {
+        events.insert(events.end(), chunk.begin(), chunk.end());
+    }
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,117 @@
+#include "ParticleEmitter.hpp"
+#include "ParticleSimulation.hpp"
+#include <cmath>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr float TWO_PI = 6.28318530718f;
+    constexpr size_t RANDOMS_PER_PARTICLE = 8;
+
+    // Builds an orthonormal basis around 'n' (n must be normalized)
+    void buildBasis(const glm::vec3& n, glm::vec3& t, glm::vec3& b) {
+        glm::vec3 helper = std::fabs(n.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        t = glm::normalize(glm::cross(helper, n));
+        b = glm::cross(n, t);
+    }
+}
+
+ParticleEmitter::ParticleEmitter(const ParticleEmitterDesc& desc, uint64_t seed)
+    : m_desc(desc), m_rng(seed) {
+}
+
+size_t ParticleEmitter::accumulate(float deltaTime, float spawnScale) {
+    size_t count = 0;
+    m_lastRequested = 0;
+    m_lastSuppressed = 0;
+
+    if (m_pendingBurst > 0) {
+        size_t kept = static_cast<size_t>(std::lround(m_pendingBurst * spawnScale));
+        if (kept > m_pendingBurst) kept = m_pendingBurst;
+        count += kept;
+        m_lastRequested += m_pendingBurst;
+        m_lastSuppressed += m_pendingBurst - kept;
+        m_pendingBurst = 0;
+    }
+
+    if (m_active && m_desc.rate > 0.0f) {
+        m_accumulator += m_desc.rate * spawnScale * deltaTime;
+        float whole = std::floor(m_accumulator);
+        m_accumulator -= whole;
+        count += static_cast<size_t>(whole);
+
+        m_requestAccumulator += m_desc.rate * deltaTime;
+        float requested = std::floor(m_requestAccumulator);
+        m_requestAccumulator -= requested;
+        m_lastRequested += static_cast<size_t>(requested);
+        if (requested > whole) {
+            m_lastSuppressed += static_cast<size_t>(requested - whole);
+        }
+    }
+
+    size_t budget = getBudgetRemaining();
+    return count < budget ? count : budget;
+}
+
+void ParticleEmitter::spawnInto(std::vector<Particle>& pool, const uint32_t* slots, size_t count, int32_t emitterIndex) {
+    if (count == 0) return;
+
+    // Draw every uniform for the batch up front so the generator runs in one tight loop
+    m_random.resize(count * RANDOMS_PER_PARTICLE);
+    m_rng.fillUniform(m_random.data(), m_random.size());
+
+    const ParticleEmitterDesc& d = m_desc;
+    const glm::vec4 startColor = d.colorOverLife.evaluate(0.0f);
+    const float speedRange = d.speedMax - d.speedMin;
+    const float lifeRange = d.lifetimeMax - d.lifetimeMin;
+
+    glm::vec3 coneAxis(0.0f, 1.0f, 0.0f), coneT, coneB;
+    float cosMax = 1.0f;
+    if (d.shape == EmitterShape::CONE) {
+        if (glm::length(d.direction) > 0.0f) coneAxis = glm::normalize(d.direction);
+        buildBasis(coneAxis, coneT, coneB);
+        cosMax = std::cos(d.coneAngle);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const float* u = &m_random[i * RANDOMS_PER_PARTICLE];
+        Particle& p = pool[slots[i]];
+
+        glm::vec3 dir;
+        if (d.shape == EmitterShape::CONE) {
+            // Uniform over the spherical cap around the cone axis
+            float cosTheta = 1.0f - u[0] * (1.0f - cosMax);
+            float sinTheta = std::sqrt(std::fmax(0.0f, 1.0f - cosTheta * cosTheta));
+            float phi = u[1] * TWO_PI;
+            dir = coneAxis * cosTheta + (coneT * std::cos(phi) + coneB * std::sin(phi)) * sinTheta;
+        } else {
+            // Uniform direction on the unit sphere
+            float z = 1.0f - 2.0f * u[0];
+            float r = std::sqrt(std::fmax(0.0f, 1.0f - z * z));
+            float phi = u[1] * TWO_PI;
+            dir = glm::vec3(r * std::cos(phi), r * std::sin(phi), z);
+        }
+
+        glm::vec3 offset(0.0f);
+        switch (d.shape) {
+            case EmitterShape::SPHERE:
+                offset = dir * (d.radius * std::cbrt(u[4]));
+                break;
+            case EmitterShape::BOX:
+                offset = glm::vec3(u[5] * 2.0f - 1.0f, u[6] * 2.0f - 1.0f, u[7] * 2.0f - 1.0f) * d.boxHalfExtents;
+                break;
+            default:
+                break;
+        }
+
+        p.position = d.position + offset;
+        p.previousPosition = p.position;
+        p.velocity = dir * (d.speedMin + u[2] * speedRange);
+        p.color = startColor;
+        p.initialLife = d.lifetimeMin + u[3] * lifeRange;
+        p.life = p.initialLife;
+        p.emitter = emitterIndex;
+    }
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,124 @@
+#include "ParticleRenderer.hpp"
+#include "FrameProfiler.hpp"
+#include "UniformBuffer.hpp"
+#include <iostream> // For errors
+#include <algorithm> // For std::min
+
+namespace TurtleEngine {
+
+ParticleRenderer::ParticleRenderer(size_t maxParticles)
+    : m_maxParticles(maxParticles) {
+}
+
+ParticleRenderer::~ParticleRenderer() {
+    if (m_shaderId != INVALID_SHADER) {
+        ShaderManager::shared().release(m_shaderId);
+    }
+    if (m_initialized) {
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_VBO);
+    }
+}
+
+bool ParticleRenderer::initialize(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
+    if (m_initialized) return true;
+
+    // The buffers are created while the driver compiles the shaders, which then
+    // reload whenever their files change
+    ShaderManager& shaders = ShaderManager::shared();
+    m_shaderId = shaders.submit(vertexShaderPath, fragmentShaderPath);
+    if (m_shaderId == INVALID_SHADER) {
+        std::cerr << "ERROR::ParticleRenderer: Failed to load shaders ("
+                  << vertexShaderPath << ", " << fragmentShaderPath << ")" << std::endl;
+        return false;
+    }
+    createBuffers();
+    if (!shaders.finish(m_shaderId)) {
+        std::cerr << "ERROR::ParticleRenderer: Failed to load shaders ("
+                  << vertexShaderPath << ", " << fragmentShaderPath << ")" << std::endl;
+        shaders.release(m_shaderId);
+        m_shaderId = INVALID_SHADER;
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_VBO);
+        m_VAO = 0;
+        m_VBO = 0;
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+void ParticleRenderer::createBuffers() {
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    // Allocate buffer memory (dynamic draw because updated frequently)
+    glBufferData(GL_ARRAY_BUFFER, m_maxParticles * PARTICLE_VERTEX_FLOATS * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+
+    // Define vertex attributes
+    size_t stride = PARTICLE_VERTEX_FLOATS * sizeof(float); // 3 pos + 4 color + 1 life
+
+    // Position attribute (location = 0)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+    // Color attribute (location = 1)
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+
+    // Life Ratio attribute (location = 2)
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(7 * sizeof(float))); // Offset = 3 pos + 4 color
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void ParticleRenderer::render(const ParticleRenderView& particles, const glm::mat4& projection, const glm::mat4& view, float time) {
+    if (!m_initialized || particles.count == 0) return;
+    ProfileScope zone("Particles", true);
+
+    const size_t count = std::min(particles.count, m_maxParticles);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    // Upload only the data for visible particles
+    // Use glBufferSubData to avoid reallocating the entire buffer
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * PARTICLE_VERTEX_FLOATS * sizeof(float), particles.vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Looked up each frame: a reload replaces the program
+    Shader& shader = ShaderManager::shared().get(m_shaderId);
+    if (shader.getProgram() == 0) {
+        std::cerr << "ERROR::ParticleRenderer: Shader program is not valid" << std::endl;
+        return;
+    }
+    shader.use();
+    FrameUniforms::shared().setCamera(view, projection);
+
+    shader.setFloat("time", time);
+    shader.setFloat("pointScale", particles.pointScale);
+
+    // Back-to-front order makes regular alpha blending correct.
+    // Disable depth writing so particles dont obscure each other incorrectly
+    if (particles.depthSorted) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+    }
+
+    shader.setMat4("model", glm::mat4(1.0f)); // Use identity model matrix for world-space particles
+
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(count));
+    glBindVertexArray(0);
+
+    // Restore blend/depth state if changed
+    if (particles.depthSorted) {
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,493 @@
+#include "ParticleSimulation.hpp"
+#include <algorithm> // For std::min
+#include <chrono>
+#include <cmath>
+#include "JobSystem.hpp"
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr uint64_t DEFAULT_SEED = 0x7475727463ull;
+
+    // A depth order stays valid while the camera moves less than this
+    constexpr float SORT_REUSE_DISTANCE = 0.05f;
+    constexpr float SORT_REUSE_MIN_COS = 0.99995f; // ~0.6 degrees
+    constexpr double MAX_SORT_REUSE_SECONDS = 0.1; // Particles move too, so resort regularly
+
+    // Float drift in the accumulator must not turn one step into zero-then-two
+    constexpr double STEP_EPSILON = 1e-6;
+}
+
+ParticleSimulation::ParticleSimulation(size_t maxParticles)
+    : m_maxParticles(maxParticles),
+      m_burstEmitter(ParticleEmitterDesc{}, DEFAULT_SEED),
+      m_seed(DEFAULT_SEED) {
+    m_burstEmitter = ParticleEmitter(ParticleEmitterDesc{}, emitterSeed(-1));
+    m_particles.resize(m_maxParticles);
+    // Pre-allocate render view storage to avoid reallocations
+    m_vertexData.reserve(m_maxParticles * PARTICLE_VERTEX_FLOATS);
+
+    // Free list is a stack; push in reverse so slot 0 is handed out first
+    m_freeSlots.reserve(m_maxParticles);
+    for (size_t i = m_maxParticles; i > 0; --i) {
+        m_freeSlots.push_back(static_cast<uint32_t>(i - 1));
+    }
+    m_spawnSlots.reserve(m_maxParticles);
+}
+
+size_t ParticleSimulation::acquireSlots(size_t count) {
+    count = std::min(count, m_freeSlots.size());
+    m_spawnSlots.assign(m_freeSlots.end() - count, m_freeSlots.end());
+    m_freeSlots.resize(m_freeSlots.size() - count);
+    return count;
+}
+
+void ParticleSimulation::spawnFromEmitter(ParticleEmitter& emitter, int32_t emitterIndex, size_t count) {
+    if (m_stepHandler) {
+        stageExternalSpawns(emitter, emitterIndex, count);
+        return;
+    }
+
+    const size_t requested = count;
+    count = acquireSlots(count);
+    m_budget.recordDroppedSpawns(requested - count);
+    if (count == 0) return;
+    emitter.spawnInto(m_particles, m_spawnSlots.data(), count, emitterIndex);
+    if (emitterIndex >= 0) {
+        emitter.onParticleSpawned(count);
+    }
+}
+
+size_t ParticleSimulation::reserveExternalSlots(size_t count) {
+    // The integrator's buffers hold m_maxParticles; anything past that would be
+    // silently dropped by GL while still charging its emitter
+    const size_t room = m_maxParticles - std::min(m_externalLive, m_maxParticles);
+    if (count > room) {
+        m_budget.recordDroppedSpawns(count - room);
+        count = room;
+    }
+    m_externalLive += count;
+    return count;
+}
+
+void ParticleSimulation::stageExternalSpawns(ParticleEmitter& emitter, int32_t emitterIndex, size_t count) {
+    count = reserveExternalSlots(count);
+    if (count == 0) return;
+
+    // Generate exactly as the CPU path would, then stage for the integrator
+    if (m_externalSlots.size() < count) {
+        for (size_t i = m_externalSlots.size(); i < count; ++i) {
+            m_externalSlots.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (m_externalStaging.size() < count) {
+        m_externalStaging.resize(count);
+    }
+    emitter.spawnInto(m_externalStaging, m_externalSlots.data(), count, emitterIndex);
+
+    // Integrators lerp between the first and last colour keys only
+    const glm::vec4 endColor = emitter.getDesc().colorOverLife.evaluate(1.0f);
+    for (size_t i = 0; i < count; ++i) {
+        const Particle& p = m_externalStaging[i];
+        m_externalSpawns.push_back(ParticleSpawnRecord{p.position, p.velocity, p.color, endColor, p.life, p.initialLife});
+    }
+
+    // Live counts are never read back; release the slots (and the emitter's budget)
+    // once the longest-lived particle must be dead
+    if (emitterIndex >= 0) {
+        emitter.onParticleSpawned(count);
+    }
+    m_budgetReleases.push_back(BudgetRelease{emitterIndex, m_externalClock + emitter.getDesc().lifetimeMax, count});
+}
+
+void ParticleSimulation::releaseExternalBudgets() {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_budgetReleases.size(); ++i) {
+        const BudgetRelease& release = m_budgetReleases[i];
+        if (release.time <= m_externalClock) {
+            m_externalLive -= release.count;
+            if (release.emitter >= 0) {
+                m_emitters[release.emitter].onParticlesDied(release.count);
+            }
+        } else {
+            m_budgetReleases[kept++] = release;
+        }
+    }
+    m_budgetReleases.resize(kept);
+}
+
+void ParticleSimulation::setExternalIntegration(ParticleStepHandler handler) {
+    m_stepHandler = std::move(handler);
+    m_externalSpawns.clear();
+}
+
+void ParticleSimulation::spawnParticle(const Particle& particleProperties) {
+    if (particleProperties.initialLife <= 0.0f) return; // Would never be reclaimed
+    if (m_stepHandler) {
+        if (reserveExternalSlots(1) == 0) return;
+        const Particle& p = particleProperties;
+        m_budgetReleases.push_back(BudgetRelease{-1, m_externalClock + p.initialLife, 1});
+        m_externalSpawns.push_back(ParticleSpawnRecord{p.position, p.velocity, p.color, p.color, p.initialLife, p.initialLife});
+        return;
+    }
+    if (acquireSlots(1) == 0) { // All particles are active
+        m_budget.recordDroppedSpawns(1);
+        return;
+    }
+
+    uint32_t particleIndex = m_spawnSlots[0];
+    // Use the provided properties, ensuring initialLife is set
+    m_particles[particleIndex] = particleProperties;
+    // Ensure life is also set if not already in properties
+    m_particles[particleIndex].life = particleProperties.initialLife;
+    m_particles[particleIndex].previousPosition = particleProperties.position; // No motion to interpolate yet
+    m_particles[particleIndex].emitter = -1;
+}
+
+void ParticleSimulation::spawnBurst(int count, glm::vec3 origin, float initialSpeed, float lifetime, glm::vec4 color) {
+    if (count <= 0) return;
+
+    // Same distribution as before (speed 50-100%, lifetime 80-120%), drawn in one batch
+    ParticleEmitterDesc& desc = m_burstEmitter.getDesc();
+    desc.shape = EmitterShape::POINT;
+    desc.position = origin;
+    desc.speedMin = initialSpeed * 0.5f;
+    desc.speedMax = initialSpeed;
+    desc.lifetimeMin = lifetime * 0.8f;
+    desc.lifetimeMax = lifetime * 1.2f;
+    desc.colorOverLife = ParticleCurve<glm::vec4>(color);
+
+    spawnFromEmitter(m_burstEmitter, -1, static_cast<size_t>(count));
+}
+
+EmitterHandle ParticleSimulation::addEmitter(const ParticleEmitterDesc& desc) {
+    // Reuse a retired slot once all of its particles have died
+    for (size_t i = 0; i < m_emitters.size(); ++i) {
+        if (m_emitters[i].isRetired() && m_emitters[i].getLiveCount() == 0) {
+            uint64_t seed = desc.seed != 0 ? desc.seed : emitterSeed(static_cast<int32_t>(i));
+            m_emitters[i] = ParticleEmitter(desc, seed);
+            return static_cast<EmitterHandle>(i);
+        }
+    }
+    int32_t index = static_cast<int32_t>(m_emitters.size());
+    m_emitters.emplace_back(desc, desc.seed != 0 ? desc.seed : emitterSeed(index));
+    return static_cast<EmitterHandle>(index);
+}
+
+uint64_t ParticleSimulation::emitterSeed(int32_t emitterIndex) const {
+    // Independent of creation order and of other emitters' draws
+    uint64_t state = m_seed ^ (0x9E3779B97F4A7C15ull * static_cast<uint64_t>(static_cast<int64_t>(emitterIndex) + 2));
+    return splitMix64(state);
+}
+
+void ParticleSimulation::setSeed(uint64_t seed) {
+    m_seed = seed;
+    ParticleEmitterDesc burstDesc = m_burstEmitter.getDesc();
+    m_burstEmitter = ParticleEmitter(burstDesc, emitterSeed(-1));
+}
+
+void ParticleSimulation::setFixedTimestep(float step, int maxSubSteps) {
+    m_fixedTimestep = step > 0.0f ? step : 0.0f;
+    m_maxSubSteps = std::max(maxSubSteps, 1);
+    m_timeAccumulator = 0.0;
+    m_interpolationAlpha = 1.0f;
+}
+
+void ParticleSimulation::removeEmitter(EmitterHandle handle) {
+    if (ParticleEmitter* emitter = getEmitter(handle)) {
+        emitter->retire();
+    }
+}
+
+ParticleEmitter* ParticleSimulation::getEmitter(EmitterHandle handle) {
+    if (handle < 0 || static_cast<size_t>(handle) >= m_emitters.size() || m_emitters[handle].isRetired()) {
+        return nullptr;
+    }
+    return &m_emitters[handle];
+}
+
+void ParticleSimulation::emitBurst(EmitterHandle handle, size_t count) {
+    if (ParticleEmitter* emitter = getEmitter(handle)) {
+        emitter->requestBurst(count);
+    }
+}
+
+void ParticleSimulation::setCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition) {
+    m_frustum = Frustum::fromMatrix(projection * view);
+    m_cameraPosition = cameraPosition;
+    // Third row of the view rotation is the camera's back vector
+    m_cameraForward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+    m_hasCamera = true;
+}
+
+float ParticleSimulation::getActiveCullDistance() const {
+    const ParticleBudgetSettings& budget = m_budget.getSettings();
+    return (m_budget.isCulling() && m_hasCamera && budget.cullDistance > 0.0f) ? budget.cullDistance : 0.0f;
+}
+
+void ParticleSimulation::update(float deltaTime) {
+    auto updateStart = std::chrono::steady_clock::now();
+    m_budget.reportCost(m_lastUpdateMs, m_lastRenderMs);
+    m_budget.beginFrame();
+    m_hitEvents.clear();
+    m_elapsedTime += deltaTime;
+
+    // logToFile(std::string("[ParticleSystem Update] Received deltaTime: ") + std::to_string(deltaTime)); // Removed deltaTime log
+
+    if (m_fixedTimestep > 0.0f) {
+        m_timeAccumulator += deltaTime;
+        int steps = 0;
+        while (m_timeAccumulator + STEP_EPSILON >= m_fixedTimestep && steps < m_maxSubSteps) {
+            simulateStep(m_fixedTimestep);
+            m_timeAccumulator -= m_fixedTimestep;
+            ++steps;
+        }
+        // Behind by more than maxSubSteps: drop the backlog instead of spiralling
+        if (m_timeAccumulator + STEP_EPSILON >= m_fixedTimestep) {
+            m_timeAccumulator = std::fmod(m_timeAccumulator, static_cast<double>(m_fixedTimestep));
+        }
+        m_interpolationAlpha = glm::clamp(static_cast<float>(m_timeAccumulator / m_fixedTimestep), 0.0f, 1.0f);
+        m_lastStepCount = steps;
+    } else {
+        simulateStep(deltaTime);
+        m_interpolationAlpha = 1.0f;
+        m_lastStepCount = 1;
+    }
+
+    // External integrators draw from their own state
+    if (!m_stepHandler) {
+        emitVisible();
+    }
+
+    if (m_hitCallback && !m_hitEvents.empty()) {
+        m_hitCallback(m_hitEvents);
+    }
+
+    m_budget.endFrame();
+    m_lastUpdateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
+}
+
+void ParticleSimulation::simulateStep(float deltaTime) {
+    const ParticleBudgetSettings& budget = m_budget.getSettings();
+
+    if (m_stepHandler) {
+        m_externalClock += deltaTime;
+        releaseExternalBudgets();
+    }
+
+    // Emit first so new particles are simulated and drawn this frame
+    for (size_t e = 0; e < m_emitters.size(); ++e) {
+        ParticleEmitter& emitter = m_emitters[e];
+        if (emitter.isRetired()) continue;
+        float spawnScale = budget.enabled ? m_budget.getSpawnScale(emitter.getDesc().priority) : 1.0f;
+        size_t count = emitter.accumulate(deltaTime, spawnScale);
+        m_budget.recordSpawns(emitter.getLastRequested(), emitter.getLastSuppressed());
+        if (count > 0) {
+            spawnFromEmitter(emitter, static_cast<int32_t>(e), count);
+        }
+    }
+
+    if (m_stepHandler) {
+        // The integrator advances and culls its own state; it only needs the new spawns
+        m_stepHandler(m_externalSpawns, deltaTime);
+        m_externalSpawns.clear();
+        return;
+    }
+
+    const bool cullDistance = m_budget.isCulling() && m_hasCamera && budget.cullDistance > 0.0f;
+    const float cullDistanceSq = budget.cullDistance * budget.cullDistance;
+
+    m_activeParticleCount = 0; 
+    size_t distanceCulled = 0;
+    const bool collide = m_collisionEnabled && m_collider.hasColliders();
+    m_liveStream.clear();
+
+    for (size_t i = 0; i < m_maxParticles; ++i) {
+        Particle& p = m_particles[i];
+
+        if (p.life > 0.0f) {
+            p.life -= deltaTime;
+
+            // Far-away particles are dropped from the simulation entirely
+            if (p.life > 0.0f && cullDistance) {
+                glm::vec3 toCamera = p.position - m_cameraPosition;
+                if (glm::dot(toCamera, toCamera) > cullDistanceSq) {
+                    p.life = 0.0f;
+                    ++distanceCulled;
+                }
+            }
+
+            if (p.life > 0.0f) {
+                // Update position (simple Euler integration)
+                p.previousPosition = p.position;
+                p.position += p.velocity * deltaTime;
+                // Optional: Add gravity or other forces
+                // p.velocity.y -= 9.81f * deltaTime;
+
+                m_activeParticleCount++;
+                if (collide) m_liveStream.push(static_cast<uint32_t>(i), p.position, p.previousPosition);
+            } else {
+                // Particle just died: return its slot and release the emitter budget
+                if (p.emitter >= 0) {
+                    m_emitters[p.emitter].onParticleDied();
+                    p.emitter = -1;
+                }
+                m_freeSlots.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    // logToFile(std::string("[ParticleSystem Update] Active particles after loop: ") + std::to_string(m_activeParticleCount)); // Removed active count log
+
+    m_budget.recordDistanceCulls(distanceCulled);
+
+    if (collide) {
+        collideLiveParticles();
+    }
+}
+
+void ParticleSimulation::collideLiveParticles() {
+    m_collisionResponses.resize(m_emitters.size());
+    for (size_t e = 0; e < m_emitters.size(); ++e) {
+        m_collisionResponses[e] = m_emitters[e].getDesc().collision;
+    }
+
+    size_t firstHit = m_hitEvents.size();
+    m_collider.collide(m_particles, m_liveStream,
+                       m_collisionResponses.data(), m_collisionResponses.size(), m_hitEvents, &JobSystem::shared());
+
+    // Particles killed on contact go back to the pool right away
+    for (size_t h = firstHit; h < m_hitEvents.size(); ++h) {
+        const ParticleHitEvent& hit = m_hitEvents[h];
+        if (hit.response != ParticleCollisionResponse::DIE) continue;
+        Particle& p = m_particles[hit.particle];
+        if (p.emitter >= 0) {
+            m_emitters[p.emitter].onParticleDied();
+            p.emitter = -1;
+        }
+        m_freeSlots.push_back(hit.particle);
+        m_activeParticleCount--;
+    }
+}
+
+void ParticleSimulation::emitVisible() {
+    const ParticleBudgetSettings& budget = m_budget.getSettings();
+    const bool cullFrustum = m_budget.isCulling() && m_hasCamera && budget.frustumCulling;
+    const float alpha = m_interpolationAlpha;
+
+    m_vertexData.clear();
+    m_visibleSlots.clear();
+    size_t frustumCulled = 0;
+
+    for (size_t i = 0; i < m_maxParticles; ++i) {
+        const Particle& p = m_particles[i];
+        if (p.life <= 0.0f) continue;
+
+        // Off-screen particles keep simulating but are not drawn
+        if (cullFrustum && !m_frustum.containsPoint(glm::mix(p.previousPosition, p.position, alpha))) {
+            ++frustumCulled;
+            continue;
+        }
+        m_visibleSlots.push_back(static_cast<uint32_t>(i));
+    }
+
+    const std::vector<uint32_t>* drawOrder = &m_visibleSlots;
+    m_sortReused = false;
+    if (m_sortEnabled && m_hasCamera) {
+        sortVisibleSlots();
+        drawOrder = &m_sortedSlots;
+    }
+
+    m_vertexData.reserve(drawOrder->size() * PARTICLE_VERTEX_FLOATS);
+    for (uint32_t slot : *drawOrder) {
+        Particle& p = m_particles[slot];
+        glm::vec3 position = glm::mix(p.previousPosition, p.position, alpha);
+
+        // Calculate normalized life ratio
+        float lifeRatio = 0.0f;
+        if (p.initialLife > 0.0f) { // Avoid division by zero
+            lifeRatio = glm::clamp(p.life / p.initialLife, 0.0f, 1.0f);
+        }
+
+        // Emitter-owned particles follow their colour-over-life curve
+        if (p.emitter >= 0) {
+            p.color = m_emitters[p.emitter].getDesc().colorOverLife.evaluate(1.0f - lifeRatio);
+        }
+
+        // Add particle data to the render view
+        m_vertexData.push_back(position.x);
+        m_vertexData.push_back(position.y);
+        m_vertexData.push_back(position.z);
+        m_vertexData.push_back(p.color.r);
+        m_vertexData.push_back(p.color.g);
+        m_vertexData.push_back(p.color.b);
+        m_vertexData.push_back(p.color.a);
+        m_vertexData.push_back(lifeRatio);
+    }
+    m_emittedParticleCount = drawOrder->size();
+
+    m_budget.recordFrustumCulls(frustumCulled);
+}
+
+ParticleRenderView ParticleSimulation::getRenderView() const {
+    ParticleRenderView view;
+    if (!m_stepHandler) {
+        view.vertices = m_vertexData.data();
+        view.count = m_emittedParticleCount;
+        view.depthSorted = m_sortEnabled;
+    }
+    view.pointScale = m_budget.getPointSizeScale();
+    return view;
+}
+
+void ParticleSimulation::sortVisibleSlots() {
+    ++m_sortFrame;
+    if (m_sortFrame == 0) ++m_sortFrame; // 0 marks "not visible"
+    if (m_slotStamp.size() != m_maxParticles) m_slotStamp.assign(m_maxParticles, 0);
+
+    bool cameraSteady = m_hasSortedOrder && m_elapsedTime - m_sortTime < MAX_SORT_REUSE_SECONDS &&
+                        glm::length(m_cameraPosition - m_sortCameraPosition) < SORT_REUSE_DISTANCE &&
+                        glm::dot(m_cameraForward, m_sortCameraForward) > SORT_REUSE_MIN_COS;
+
+    if (cameraSteady) {
+        // Keep last frame's order for the survivors, then append newcomers
+        for (uint32_t slot : m_visibleSlots) m_slotStamp[slot] = m_sortFrame;
+        m_sortScratch.clear();
+        for (uint32_t slot : m_sortedSlots) {
+            if (m_slotStamp[slot] == m_sortFrame) {
+                m_sortScratch.push_back(slot);
+                m_slotStamp[slot] = 0;
+            }
+        }
+        for (uint32_t slot : m_visibleSlots) {
+            if (m_slotStamp[slot] == m_sortFrame) m_sortScratch.push_back(slot);
+        }
+        m_sortedSlots.swap(m_sortScratch);
+        m_sortReused = true;
+        return;
+    }
+
+    // Descending view depth at the interpolated positions that get drawn: farthest
+    // particle gets the smallest key
+    const size_t count = m_visibleSlots.size();
+    m_sortKeys.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Particle& p = m_particles[m_visibleSlots[i]];
+        const glm::vec3 position = glm::mix(p.previousPosition, p.position, m_interpolationAlpha);
+        float depth = glm::dot(position - m_cameraPosition, m_cameraForward);
+        m_sortKeys[i] = ~floatToSortableKey(depth);
+    }
+    m_sorter.sort(m_sortKeys.data(), count, m_sortOrder, &JobSystem::shared());
+
+    m_sortedSlots.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_sortedSlots[i] = m_visibleSlots[m_sortOrder[i]];
+    }
+
+    m_sortCameraPosition = m_cameraPosition;
+    m_sortCameraForward = m_cameraForward;
+    m_sortTime = m_elapsedTime;
+    m_hasSortedOrder = true;
+}
+
+} // namespace TurtleEngine
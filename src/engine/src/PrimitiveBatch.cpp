@@ -0,0 +1,168 @@
+#include "PrimitiveBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr size_t SHAPE_COUNT = static_cast<size_t>(PrimitiveShape::COUNT);
+    constexpr size_t MIN_INSTANCE_CAPACITY = 256;
+
+    // Key layout (before the submission index): layer 16 bits | blend 8 bits | shape 8 bits
+    uint32_t makeKey(uint16_t layer, bool translucent, PrimitiveShape shape) {
+        return (static_cast<uint32_t>(layer) << 16) | (static_cast<uint32_t>(translucent) << 8) | static_cast<uint32_t>(shape);
+    }
+}
+
+PrimitiveBatch::~PrimitiveBatch() {
+    cleanup();
+}
+
+bool PrimitiveBatch::initialize(GLuint program, const PrimitiveShapeGeometry (&shapes)[SHAPE_COUNT]) {
+    cleanup();
+    if (program == 0) {
+        std::cerr << "ERROR::PrimitiveBatch: No instanced program" << std::endl;
+        return false;
+    }
+    m_program = program;
+    UniformCache uniforms;
+    uniforms.reflect(program);
+    m_view = uniforms.handle<glm::mat4>("view");
+    m_projection = uniforms.handle<glm::mat4>("projection");
+
+    glGenBuffers(1, &m_instanceBuffer);
+    growInstanceBuffer(MIN_INSTANCE_CAPACITY);
+
+    // One VAO per shape: its unit geometry plus the shared instance stream
+    glGenVertexArrays(static_cast<GLsizei>(SHAPE_COUNT), m_vaos);
+    for (size_t s = 0; s < SHAPE_COUNT; ++s) {
+        m_shapes[s] = shapes[s];
+        glBindVertexArray(m_vaos[s]);
+        glBindBuffer(GL_ARRAY_BUFFER, shapes[s].vertexBuffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        if (shapes[s].indexBuffer != 0) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shapes[s].indexBuffer);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        for (GLuint attribute = 1; attribute <= 4; ++attribute) {
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribDivisor(attribute, 1);
+        }
+        pointInstanceAttributes(0);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void PrimitiveBatch::cleanup() {
+    if (m_vaos[0] != 0) {
+        glDeleteVertexArrays(static_cast<GLsizei>(SHAPE_COUNT), m_vaos);
+        std::fill(std::begin(m_vaos), std::end(m_vaos), 0u);
+    }
+    if (m_instanceBuffer != 0) {
+        glDeleteBuffers(1, &m_instanceBuffer);
+        m_instanceBuffer = 0;
+    }
+    m_instanceCapacity = 0;
+    m_program = 0; // Owned by the renderer
+    m_instances.clear();
+    m_keys.clear();
+}
+
+void PrimitiveBatch::growInstanceBuffer(size_t count) {
+    if (count <= m_instanceCapacity) return;
+    m_instanceCapacity = std::max(count, std::max(m_instanceCapacity * 2, MIN_INSTANCE_CAPACITY));
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+}
+
+void PrimitiveBatch::pointInstanceAttributes(size_t firstInstance) {
+    // Expects the shape's VAO and the instance buffer to be bound
+    const GLsizei stride = sizeof(Instance);
+    const size_t base = firstInstance * sizeof(Instance);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(Instance, position)));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(Instance, scale)));
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(Instance, rotation)));
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(Instance, color)));
+}
+
+void PrimitiveBatch::add(PrimitiveShape shape, const glm::vec2& position, float rotation, const glm::vec2& scale,
+                         const glm::vec4& color, uint16_t layer) {
+    Instance instance;
+    instance.position[0] = position.x;
+    instance.position[1] = position.y;
+    instance.scale[0] = scale.x;
+    instance.scale[1] = scale.y;
+    instance.rotation[0] = std::cos(rotation);
+    instance.rotation[1] = std::sin(rotation);
+    instance.color[0] = color.r;
+    instance.color[1] = color.g;
+    instance.color[2] = color.b;
+    instance.color[3] = color.a;
+
+    const uint64_t key = makeKey(layer, color.a < 1.0f, shape);
+    m_keys.push_back((key << 32) | static_cast<uint32_t>(m_instances.size()));
+    m_instances.push_back(instance);
+}
+
+size_t PrimitiveBatch::flush(const glm::mat4& view, const glm::mat4& projection, GLStateCache& state) {
+    if (m_instances.empty() || m_program == 0) {
+        m_instances.clear();
+        m_keys.clear();
+        return 0;
+    }
+
+    // The submission index in the low bits makes the sort stable
+    std::sort(m_keys.begin(), m_keys.end());
+    m_sorted.resize(m_instances.size());
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        m_sorted[i] = m_instances[static_cast<uint32_t>(m_keys[i])];
+    }
+
+    growInstanceBuffer(m_sorted.size());
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    // Orphan the old storage so the driver need not wait for last frame's draws
+    glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_sorted.size() * sizeof(Instance), m_sorted.data());
+
+    state.useProgram(m_program);
+    m_view.set(view);
+    m_projection.set(projection);
+
+    size_t draws = 0;
+    size_t runStart = 0;
+    while (runStart < m_keys.size()) {
+        const uint32_t key = static_cast<uint32_t>(m_keys[runStart] >> 32);
+        size_t runEnd = runStart + 1;
+        while (runEnd < m_keys.size() && static_cast<uint32_t>(m_keys[runEnd] >> 32) == key) ++runEnd;
+
+        const size_t shape = key & 0xFF;
+        const bool translucent = ((key >> 8) & 0xFF) != 0;
+        state.setBlend(translucent);
+        if (translucent) state.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        const PrimitiveShapeGeometry& geometry = m_shapes[shape];
+        const GLsizei instances = static_cast<GLsizei>(runEnd - runStart);
+        state.bindVertexArray(m_vaos[shape]);
+        pointInstanceAttributes(runStart);
+        if (geometry.indexBuffer != 0) {
+            glDrawElementsInstanced(geometry.mode, geometry.count, GL_UNSIGNED_INT, 0, instances);
+        } else {
+            glDrawArraysInstanced(geometry.mode, 0, geometry.count, instances);
+        }
+        ++draws;
+        runStart = runEnd;
+    }
+
+    state.bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_instances.clear();
+    m_keys.clear();
+    return draws;
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,240 @@
+#include "ProgramCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr uint32_t ENTRY_MAGIC = 0x31425054u; // "TPB1"
+    constexpr uint32_t MAX_BINARY_LENGTH = 64u << 20;
+
+    struct EntryHeader {
+        uint32_t magic;
+        uint32_t format;
+        uint64_t key;
+        uint32_t length;
+        float compileMilliseconds;
+    };
+
+    // FNV-1a, 64 bit
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::string glString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+}
+
+ProgramCache& ProgramCache::shared() {
+    static ProgramCache instance;
+    return instance;
+}
+
+ProgramCache::ProgramCache() {
+    const char* directory = std::getenv("TURTLE_SHADER_CACHE");
+    m_directory = directory ? directory : "shader_cache";
+}
+
+void ProgramCache::setDirectory(const std::string& directory) {
+    m_directory = directory;
+}
+
+bool ProgramCache::isEnabled() {
+    if (m_directory.empty()) return false;
+    if (m_supported < 0) {
+        GLint formats = 0;
+        if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        m_supported = formats > 0 ? 1 : 0;
+        m_driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+    }
+    return m_supported == 1;
+}
+
+uint64_t ProgramCache::makeKey(std::initializer_list<const std::string*> sources) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = hashBytes(hash, m_driver.data(), m_driver.size() + 1);
+    for (const std::string* source : sources) {
+        // Include the terminator so that moving text between stages changes the key
+        hash = hashBytes(hash, source->c_str(), source->size() + 1);
+    }
+    return hash;
+}
+
+std::string ProgramCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+GLuint ProgramCache::getProgram(std::initializer_list<const std::string*> sources, const std::function<bool(GLuint program)>& build) {
+    GLuint program = lookup(sources);
+    if (program != 0) return program;
+
+    const auto start = std::chrono::steady_clock::now();
+    program = createProgram();
+    if (!build(program)) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    store(sources, program, millisecondsSince(start));
+    return program;
+}
+
+GLuint ProgramCache::lookup(std::initializer_list<const std::string*> sources) {
+    if (isEnabled()) {
+        const auto start = std::chrono::steady_clock::now();
+        GLuint program = load(makeKey(sources));
+        if (program != 0) {
+            ++m_stats.hits;
+            m_stats.loadMilliseconds += millisecondsSince(start);
+            return program;
+        }
+    }
+    ++m_stats.misses;
+    return 0;
+}
+
+GLuint ProgramCache::createProgram() {
+    GLuint program = glCreateProgram();
+    if (isEnabled()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    return program;
+}
+
+void ProgramCache::store(std::initializer_list<const std::string*> sources, GLuint program, double compileMilliseconds) {
+    m_stats.compileMilliseconds += compileMilliseconds;
+    if (isEnabled()) {
+        write(makeKey(sources), program, compileMilliseconds);
+    }
+}
+
+GLuint ProgramCache::load(uint64_t key) {
+    const std::string path = pathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    EntryHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool valid = file && header.magic == ENTRY_MAGIC && header.key == key && header.length > 0 && header.length <= MAX_BINARY_LENGTH;
+
+    // glProgramBinary raises GL_INVALID_ENUM for formats the driver does not list
+    if (valid) {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        std::vector<GLint> formats(static_cast<size_t>(std::max(formatCount, 0)));
+        if (!formats.empty()) {
+            glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+        }
+        valid = std::find(formats.begin(), formats.end(), static_cast<GLint>(header.format)) != formats.end();
+    }
+
+    std::vector<char> binary;
+    if (valid) {
+        binary.resize(header.length);
+        file.read(binary.data(), header.length);
+        valid = static_cast<bool>(file);
+    }
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    file.close();
+
+    if (program == 0) {
+        // Stale or corrupt; the compiled program will replace it
+        ++m_stats.rejected;
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return 0;
+    }
+    m_stats.savedMilliseconds += std::max(0.0, static_cast<double>(header.compileMilliseconds) - millisecondsSince(start));
+    return program;
+}
+
+void ProgramCache::write(uint64_t key, GLuint program, double compileMilliseconds) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || static_cast<uint32_t>(length) > MAX_BINARY_LENGTH) return;
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        std::cerr << "ERROR::ProgramCache: Cannot create " << m_directory << ": " << error.message() << std::endl;
+        return;
+    }
+
+    // Written beside the entry and renamed, so another process never reads half a file
+    const std::string path = pathFor(key);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        EntryHeader header{ ENTRY_MAGIC, format, key, static_cast<uint32_t>(written), static_cast<float>(compileMilliseconds) };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            std::cerr << "ERROR::ProgramCache: Failed to write " << temporary << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+    ++m_stats.stores;
+}
+
+std::string ProgramCache::describeStats() const {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+    if (m_supported != 1 || m_directory.empty()) {
+        out << "Shader cache: disabled, " << m_stats.misses << " programs compiled in " << m_stats.compileMilliseconds << " ms";
+        return out.str();
+    }
+    out << "Shader cache: " << m_stats.hits << (m_stats.hits == 1 ? " hit, " : " hits, ")
+        << m_stats.misses << (m_stats.misses == 1 ? " miss" : " misses");
+    if (m_stats.rejected > 0) {
+        out << " (" << m_stats.rejected << " rejected)";
+    }
+    out << ", " << m_stats.savedMilliseconds << " ms saved";
+    return out.str();
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,95 @@
+#include "RadixSort.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr size_t RADIX = 256;
+    constexpr int PASSES = 4;
+    constexpr int KEY_SHIFT = 32; // Keys live in the upper half of each item
+}
+
+void RadixSorter::sort(const uint32_t* keys, size_t count, std::vector<uint32_t>& order, JobSystem* jobs) {
+    order.resize(count);
+    if (count == 0) return;
+
+    size_t chunkCount = 1;
+    if (jobs && count >= PARALLEL_THRESHOLD) {
+        chunkCount = std::min(jobs->getConcurrency(), count / (PARALLEL_THRESHOLD / 4));
+        chunkCount = std::max<size_t>(chunkCount, 1);
+    }
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    m_items.resize(count);
+    m_scratch.resize(count);
+    m_histograms.resize(chunkCount * RADIX);
+
+    for (size_t i = 0; i < count; ++i) {
+        m_items[i] = (static_cast<uint64_t>(keys[i]) << KEY_SHIFT) | static_cast<uint32_t>(i);
+    }
+
+    uint64_t* source = m_items.data();
+    uint64_t* target = m_scratch.data();
+
+    auto forEachChunk = [&](auto&& body) {
+        if (chunkCount == 1) {
+            body(0);
+        } else {
+            jobs->parallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c) body(c);
+            });
+        }
+    };
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        const int shift = KEY_SHIFT + pass * 8;
+
+        forEachChunk([&](size_t chunk) {
+            uint32_t* histogram = &m_histograms[chunk * RADIX];
+            std::fill(histogram, histogram + RADIX, 0u);
+            size_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                ++histogram[(source[i] >> shift) & 0xFF];
+            }
+        });
+
+        // Every key shares this digit: the pass would be an identity copy
+        bool trivial = false;
+        for (size_t digit = 0; digit < RADIX && !trivial; ++digit) {
+            uint32_t total = 0;
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk) total += m_histograms[chunk * RADIX + digit];
+            if (total == count) trivial = true;
+            else if (total != 0) break;
+        }
+        if (trivial) continue;
+
+        // Exclusive prefix over (digit, chunk) keeps the sort stable across chunks
+        uint32_t offset = 0;
+        for (size_t digit = 0; digit < RADIX; ++digit) {
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                uint32_t& slot = m_histograms[chunk * RADIX + digit];
+                uint32_t n = slot;
+                slot = offset;
+                offset += n;
+            }
+        }
+
+        forEachChunk([&](size_t chunk) {
+            uint32_t* offsets = &m_histograms[chunk * RADIX];
+            size_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                uint64_t item = source[i];
+                target[offsets[(item >> shift) & 0xFF]++] = item;
+            }
+        });
+
+        std::swap(source, target);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<uint32_t>(source[i]);
+    }
+}
+
+} // namespace TurtleEngine
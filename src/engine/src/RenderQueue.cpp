@@ -0,0 +1,237 @@
+#include "RenderQueue.hpp"
+#include "JobSystem.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace TurtleEngine {
+
+namespace {
+    constexpr uint64_t SHADER_BITS = 12;
+    constexpr uint64_t MATERIAL_BITS = 16;
+    constexpr uint64_t STATE_BITS = SHADER_BITS + MATERIAL_BITS;
+
+    size_t floatCount(uint8_t type) {
+        static const size_t counts[] = { 1, 1, 2, 3, 4, 9, 16 };
+        return counts[type];
+    }
+}
+
+uint64_t makeRenderKey(RenderPass pass, uint32_t shader, uint32_t material, float depth) {
+    const uint64_t state = (static_cast<uint64_t>(shader & ((1u << SHADER_BITS) - 1)) << MATERIAL_BITS) |
+                           (material & ((1u << MATERIAL_BITS) - 1));
+    const uint64_t depthBits = floatToSortableKey(depth);
+    const uint64_t passBits = static_cast<uint64_t>(pass) << 60;
+    if (pass == RenderPass::TRANSLUCENT) {
+        return passBits | ((~depthBits & 0xFFFFFFFFull) << STATE_BITS) | state;
+    }
+    return passBits | (state << 32) | depthBits;
+}
+
+RenderCommand& RenderCommandList::submit(uint64_t key) {
+    m_commands.emplace_back();
+    RenderCommand& command = m_commands.back();
+    command.key = key;
+    command.uniformBegin = static_cast<uint32_t>(m_uniforms.size());
+    return command;
+}
+
+void RenderCommandList::submitCallback(uint64_t key, std::function<void()> callback) {
+    submit(key).callback = std::move(callback);
+}
+
+void RenderCommandList::appendUniform(GLint location, UniformType type, const float* data, size_t floats) {
+    if (location < 0 || m_commands.empty()) return;
+    m_uniforms.push_back({ location, type, static_cast<uint32_t>(m_uniformData.size()) });
+    m_uniformData.insert(m_uniformData.end(), data, data + floats);
+    ++m_commands.back().uniformCount;
+}
+
+void RenderCommandList::setUniform(GLint location, int value) {
+    float bits;
+    std::memcpy(&bits, &value, sizeof(bits)); // Stored bit-for-bit alongside the floats
+    appendUniform(location, UniformType::INT, &bits, 1);
+}
+
+void RenderCommandList::setUniform(GLint location, float value) { appendUniform(location, UniformType::FLOAT, &value, 1); }
+void RenderCommandList::setUniform(GLint location, const glm::vec2& value) { appendUniform(location, UniformType::VEC2, glm::value_ptr(value), 2); }
+void RenderCommandList::setUniform(GLint location, const glm::vec3& value) { appendUniform(location, UniformType::VEC3, glm::value_ptr(value), 3); }
+void RenderCommandList::setUniform(GLint location, const glm::vec4& value) { appendUniform(location, UniformType::VEC4, glm::value_ptr(value), 4); }
+void RenderCommandList::setUniform(GLint location, const glm::mat3& value) { appendUniform(location, UniformType::MAT3, glm::value_ptr(value), 9); }
+void RenderCommandList::setUniform(GLint location, const glm::mat4& value) { appendUniform(location, UniformType::MAT4, glm::value_ptr(value), 16); }
+
+void RenderCommandList::clear() {
+    m_commands.clear();
+    m_uniforms.clear();
+    m_uniformData.clear();
+}
+
+void RenderQueue::recordParallel(JobSystem& jobs, size_t count, size_t minBatch,
+                                 const std::function<void(RenderCommandList&, size_t, size_t)>& record) {
+    const size_t call = m_recordCalls++;
+    jobs.parallelFor(count, minBatch, [this, &record, call](size_t begin, size_t end) {
+        RecordedList* recorded = nullptr;
+        {
+            // One short lock per batch to claim a list; recording itself is unshared
+            std::lock_guard<std::mutex> lock(m_recordMutex);
+            if (m_recordedUsed == m_recorded.size()) {
+                m_recorded.push_back(std::make_unique<RecordedList>());
+            }
+            recorded = m_recorded[m_recordedUsed++].get();
+        }
+        recorded->call = call;
+        recorded->begin = begin;
+        record(recorded->list, begin, end);
+    });
+}
+
+void RenderQueue::gather(const RenderCommandList& list) {
+    for (uint32_t i = 0; i < list.m_commands.size(); ++i) {
+        m_refs.push_back({ &list, i });
+        m_keys.push_back(list.m_commands[i].key);
+    }
+}
+
+void RenderQueue::uploadUniforms(const RenderCommandList& list, const RenderCommand& command) {
+    for (uint32_t i = command.uniformBegin; i < command.uniformBegin + command.uniformCount; ++i) {
+        const UniformValue& uniform = list.m_uniforms[i];
+        const float* data = list.m_uniformData.data() + uniform.offset;
+        const size_t floats = floatCount(static_cast<uint8_t>(uniform.type));
+
+        // Uniform values live in the program, so identical values need not be re-sent
+        const uint64_t slot = (static_cast<uint64_t>(command.program) << 32) | static_cast<uint32_t>(uniform.location);
+        auto previous = m_uploaded.find(slot);
+        if (previous != m_uploaded.end() && previous->second.type == uniform.type &&
+            std::memcmp(previous->second.data, data, floats * sizeof(float)) == 0) {
+            ++m_stats.uniformsSkipped;
+            continue;
+        }
+        m_uploaded[slot] = { data, uniform.type };
+        ++m_stats.uniformUploads;
+
+        switch (uniform.type) {
+            case UniformType::INT: {
+                int value;
+                std::memcpy(&value, data, sizeof(value));
+                glUniform1i(uniform.location, value);
+                break;
+            }
+            case UniformType::FLOAT: glUniform1fv(uniform.location, 1, data); break;
+            case UniformType::VEC2: glUniform2fv(uniform.location, 1, data); break;
+            case UniformType::VEC3: glUniform3fv(uniform.location, 1, data); break;
+            case UniformType::VEC4: glUniform4fv(uniform.location, 1, data); break;
+            case UniformType::MAT3: glUniformMatrix3fv(uniform.location, 1, GL_FALSE, data); break;
+            case UniformType::MAT4: glUniformMatrix4fv(uniform.location, 1, GL_FALSE, data); break;
+        }
+    }
+}
+
+void RenderQueue::draw(const RenderCommandList& list, const RenderCommand& command) {
+    m_state.setBlend(command.state.blend);
+    if (command.state.blend) {
+        m_state.setBlendFunc(command.state.blendSource, command.state.blendDestination);
+    }
+    m_state.setDepthTest(command.state.depthTest);
+    m_state.setDepthWrite(command.state.depthWrite);
+    m_state.useProgram(command.program);
+    m_state.bindVertexArray(command.vertexArray);
+    for (int unit = 0; unit < RenderCommand::MAX_TEXTURES; ++unit) {
+        const RenderTexture& texture = command.textures[unit];
+        if (texture.texture != 0) {
+            m_state.bindTexture(unit, texture.target, texture.texture);
+        }
+    }
+    uploadUniforms(list, command);
+
+    if (command.indexType != 0) {
+        const size_t indexSize = command.indexType == GL_UNSIGNED_BYTE ? 1 : command.indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+        const void* offset = reinterpret_cast<const void*>(static_cast<size_t>(command.first) * indexSize);
+        if (command.instanceCount == 1) {
+            glDrawElements(command.mode, command.count, command.indexType, offset);
+        } else {
+            glDrawElementsInstanced(command.mode, command.count, command.indexType, offset, command.instanceCount);
+        }
+    } else if (command.instanceCount == 1) {
+        glDrawArrays(command.mode, command.first, command.count);
+    } else {
+        glDrawArraysInstanced(command.mode, command.first, command.count, command.instanceCount);
+    }
+    ++m_stats.draws;
+}
+
+void RenderQueue::execute() {
+    m_stats = RenderQueueStats();
+    m_state.resetStats();
+
+    // Directly submitted packets first, then the job lists in recording order
+    m_refs.clear();
+    m_keys.clear();
+    gather(*this);
+    std::sort(m_recorded.begin(), m_recorded.begin() + m_recordedUsed,
+              [](const std::unique_ptr<RecordedList>& a, const std::unique_ptr<RecordedList>& b) {
+                  return a->call != b->call ? a->call < b->call : a->begin < b->begin;
+              });
+    for (size_t i = 0; i < m_recordedUsed; ++i) {
+        gather(m_recorded[i]->list);
+    }
+    const size_t count = m_refs.size();
+    if (count == 0) {
+        clear();
+        return;
+    }
+    m_stats.commands = count;
+
+    // 64-bit keys as two stable 32-bit sorts: by the low word, then by the high word
+    m_keyWords.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_keyWords[i] = static_cast<uint32_t>(m_keys[i]);
+    }
+    m_sorter.sort(m_keyWords.data(), count, m_lowOrder);
+    for (size_t i = 0; i < count; ++i) {
+        m_keyWords[i] = static_cast<uint32_t>(m_keys[m_lowOrder[i]] >> 32);
+    }
+    m_sorter.sort(m_keyWords.data(), count, m_order);
+    for (size_t i = 0; i < count; ++i) {
+        m_order[i] = m_lowOrder[m_order[i]];
+    }
+
+    m_state.invalidate();
+    m_uploaded.clear();
+    for (uint32_t index : m_order) {
+        const CommandRef& ref = m_refs[index];
+        const RenderCommand& command = ref.list->m_commands[ref.index];
+        if (command.callback) {
+            command.callback();
+            ++m_stats.callbacks;
+            // Whatever the callback bound is unknown to the cache
+            m_state.invalidate();
+            m_uploaded.clear();
+            continue;
+        }
+        draw(*ref.list, command);
+    }
+    m_state.bindVertexArray(0);
+
+    m_stats.state = m_state.getStats();
+    clear();
+}
+
+void RenderQueue::clear() {
+    RenderCommandList::clear();
+    for (size_t i = 0; i < m_recordedUsed; ++i) {
+        m_recorded[i]->list.clear();
+    }
+    m_recordedUsed = 0;
+    m_recordCalls = 0;
+}
+
+size_t RenderQueue::size() const {
+    size_t total = RenderCommandList::size();
+    for (size_t i = 0; i < m_recordedUsed; ++i) {
+        total += m_recorded[i]->list.size();
+    }
+    return total;
+}
+
+} // namespace TurtleEngine
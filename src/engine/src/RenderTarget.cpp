@@ -0,0 +1,106 @@
+#include "RenderTarget.hpp"
+#include <fstream>
+#include <iostream>
+
+namespace TurtleEngine {
+
+RenderTarget::~RenderTarget() {
+    cleanup();
+}
+
+bool RenderTarget::initialize(int width, int height) {
+    cleanup();
+    if (width <= 0 || height <= 0) {
+        std::cerr << "ERROR::RenderTarget: Invalid size " << width << "x" << height << std::endl;
+        return false;
+    }
+    m_width = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous));
+    if (!complete) {
+        std::cerr << "ERROR::RenderTarget: Framebuffer incomplete" << std::endl;
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+void RenderTarget::cleanup() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_color != 0) {
+        glDeleteRenderbuffers(1, &m_color);
+        m_color = 0;
+    }
+    if (m_depth != 0) {
+        glDeleteRenderbuffers(1, &m_depth);
+        m_depth = 0;
+    }
+    m_width = 0;
+    m_height = 0;
+}
+
+void RenderTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void RenderTarget::readPixels(std::vector<uint8_t>& pixels) const {
+    pixels.resize(static_cast<size_t>(m_width) * m_height * 4);
+    if (!isValid()) return;
+    GLint previous = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previous));
+}
+
+uint64_t RenderTarget::hashPixels() const {
+    std::vector<uint8_t> pixels;
+    readPixels(pixels);
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : pixels) {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool RenderTarget::writePPM(const std::string& path) const {
+    std::vector<uint8_t> pixels;
+    readPixels(pixels);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::RenderTarget: Cannot write " << path << std::endl;
+        return false;
+    }
+    file << "P6\n" << m_width << " " << m_height << "\n255\n";
+    for (int y = m_height - 1; y >= 0; --y) {
+        const uint8_t* row = pixels.data() + static_cast<size_t>(y) * m_width * 4;
+        for (int x = 0; x < m_width; ++x) {
+            file.write(reinterpret_cast<const char*>(row + x * 4), 3);
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace TurtleEngine
@@ -1,9 +1,11 @@
 #include "Renderer.hpp"
+#include "FrameProfiler.hpp"
+#include "ProgramCache.hpp"
+#include "ShaderSource.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
 #include <cmath>
 
 #ifndef M_PI
@@ -12,9 +14,12 @@
 
 namespace TurtleEngine {
 
+static_assert(Renderer::MAX_SHADOWED_LIGHTS <= MAX_BLOCK_LIGHTS, "Every shadowed light needs a slot in the Lights block");
+
 Renderer::Renderer() :
     defaultShader(0),
     shadowShader(0),
+    batchShader(0),
     currentShader(0),
     triangleVAO(0),
     triangleVBO(0),
@@ -37,6 +42,10 @@ void Renderer::init() {
     // Initialize GLEW
     glewExperimental = GL_TRUE;
     GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // A headless (EGL) context has no X display; the GL entry points are loaded anyway
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY) err = GLEW_OK;
+#endif
     if (err != GLEW_OK) {
         std::cerr << "GLEW Error: " << glewGetErrorString(err) << std::endl;
         throw std::runtime_error("Failed to initialize GLEW");
@@ -55,22 +64,31 @@ void Renderer::init() {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    // Initialize shaders
-    initShaders();
-    
-    // Initialize shapes
+    // Shaders compile in the driver while the shape buffers are built
+    PendingShaders shaders = submitShaders();
     initShapes();
+    resolveShaders(shaders);
+    std::cout << ProgramCache::shared().describeStats() << std::endl;
+    initBatch();
+    
+    // One depth atlas for every light's shadows
+    if (!shadowAtlas.initialize(shadowShader, SHADOW_ATLAS_SIZE)) {
+        throw std::runtime_error("Failed to create the shadow atlas");
+    }
     
     // Set default view and projection matrices
     viewMatrix = glm::mat4(1.0f);
     projectionMatrix = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
     
     // Set default uniforms
-    setUniform("view", viewMatrix);
-    setUniform("projection", projectionMatrix);
+    currentUniforms->view.set(viewMatrix);
+    currentUniforms->projection.set(projectionMatrix);
 }
 
 void Renderer::cleanup() {
+    batch.cleanup();
+    shadowAtlas.cleanup();
+    
     // Delete shaders
     if (defaultShader != 0) {
         glDeleteProgram(defaultShader);
@@ -80,6 +98,10 @@ void Renderer::cleanup() {
         glDeleteProgram(shadowShader);
         shadowShader = 0;
     }
+    if (batchShader != 0) {
+        glDeleteProgram(batchShader);
+        batchShader = 0;
+    }
     
     // Delete VAOs and VBOs
     if (triangleVAO != 0) {
@@ -114,10 +136,15 @@ void Renderer::cleanup() {
     }
     
     // Reset current shader
+    programUniforms.clear();
+    currentUniforms = nullptr;
     currentShader = 0;
 }
 
 void Renderer::clear() {
+    if (renderTarget) {
+        glBindFramebuffer(GL_FRAMEBUFFER, renderTarget->getFramebuffer());
+    }
     glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -126,50 +153,43 @@ void Renderer::setClearColor(const glm::vec4& color) {
     clearColor = color;
 }
 
+void Renderer::setRenderTarget(const RenderTarget* target) {
+    flush();
+    renderTarget = target;
+    if (renderTarget) {
+        renderTarget->bind();
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
+
 void Renderer::loadShader(const std::string& vertexPath, const std::string& fragmentPath) {
-    // Read vertex shader
-    std::ifstream vertexFile(vertexPath);
-    if (!vertexFile.is_open()) {
+    // Read through the shared cache, which also expands #include
+    std::string vertexCode, fragmentCode;
+    std::vector<std::string> files;
+    if (!ShaderSourceCache::shared().load(vertexPath, vertexCode, files)) {
         throw std::runtime_error("Failed to open vertex shader file: " + vertexPath);
     }
-    std::stringstream vertexStream;
-    vertexStream << vertexFile.rdbuf();
-    std::string vertexCode = vertexStream.str();
-    vertexFile.close();
-    
-    // Read fragment shader
-    std::ifstream fragmentFile(fragmentPath);
-    if (!fragmentFile.is_open()) {
+    if (!ShaderSourceCache::shared().load(fragmentPath, fragmentCode, files)) {
         throw std::runtime_error("Failed to open fragment shader file: " + fragmentPath);
     }
-    std::stringstream fragmentStream;
-    fragmentStream << fragmentFile.rdbuf();
-    std::string fragmentCode = fragmentStream.str();
-    fragmentFile.close();
-    
-    // Create shaders
-    GLuint vertex = createShader(vertexCode, GL_VERTEX_SHADER);
-    GLuint fragment = createShader(fragmentCode, GL_FRAGMENT_SHADER);
     
-    // Create program
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
-    
-    checkShaderCompilation(program, "PROGRAM");
-    
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    GLuint program = createProgram(vertexCode, fragmentCode);
+    FrameUniforms::bindBlocks(program);
+    uniformsFor(program);
     
     // Set as default shader if none exists
     if (defaultShader == 0) {
         defaultShader = program;
         currentShader = program;
+        currentUniforms = &uniformsFor(program);
     }
 }
 
-void Renderer::initShaders() {
+Renderer::PendingShaders Renderer::submitShaders() {
+    ShaderPipeline& pipeline = ShaderPipeline::shared();
+    PendingShaders pending;
+    
     // Default vertex shader
     std::string defaultVertexShader = R"(
         #version 330 core
@@ -197,18 +217,7 @@ void Renderer::initShaders() {
     )";
     
     // Create default shader
-    GLuint vertex = createShader(defaultVertexShader, GL_VERTEX_SHADER);
-    GLuint fragment = createShader(defaultFragmentShader, GL_FRAGMENT_SHADER);
-    
-    defaultShader = glCreateProgram();
-    glAttachShader(defaultShader, vertex);
-    glAttachShader(defaultShader, fragment);
-    glLinkProgram(defaultShader);
-    
-    checkShaderCompilation(defaultShader, "PROGRAM");
-    
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    pending.defaultShader = pipeline.submit(defaultVertexShader, defaultFragmentShader, "default shader");
     
     // Shadow mapping vertex shader
     std::string shadowVertexShader = R"(
@@ -232,21 +241,59 @@ void Renderer::initShaders() {
     )";
     
     // Create shadow shader
-    vertex = createShader(shadowVertexShader, GL_VERTEX_SHADER);
-    fragment = createShader(shadowFragmentShader, GL_FRAGMENT_SHADER);
+    pending.shadowShader = pipeline.submit(shadowVertexShader, shadowFragmentShader, "shadow shader");
     
-    shadowShader = glCreateProgram();
-    glAttachShader(shadowShader, vertex);
-    glAttachShader(shadowShader, fragment);
-    glLinkProgram(shadowShader);
+    // Instanced shape shader for batched draws; the per-instance transform is
+    // translate * rotate(z) * scale, as in the immediate draw functions
+    std::string batchVertexShader = R"(
+        #version 330 core
+        layout (location = 0) in vec3 aPos;
+        layout (location = 1) in vec2 iPosition;
+        layout (location = 2) in vec2 iScale;
+        layout (location = 3) in vec2 iRotation; // cos, sin
+        layout (location = 4) in vec4 iColor;
+        
+        uniform mat4 view;
+        uniform mat4 projection;
+        
+        out vec4 vColor;
+        
+        void main() {
+            vec2 scaled = aPos.xy * iScale;
+            vec2 rotated = vec2(scaled.x * iRotation.x - scaled.y * iRotation.y,
+                                scaled.x * iRotation.y + scaled.y * iRotation.x);
+            vColor = iColor;
+            gl_Position = projection * view * vec4(rotated + iPosition, aPos.z, 1.0);
+        }
+    )";
     
-    checkShaderCompilation(shadowShader, "PROGRAM");
+    std::string batchFragmentShader = R"(
+        #version 330 core
+        in vec4 vColor;
+        out vec4 FragColor;
+        
+        void main() {
+            FragColor = vColor;
+        }
+    )";
     
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    pending.batchShader = pipeline.submit(batchVertexShader, batchFragmentShader, "batch shader");
+    return pending;
+}
+
+void Renderer::resolveShaders(const PendingShaders& pending) {
+    defaultShader = pending.defaultShader.get();
+    shadowShader = pending.shadowShader.get();
+    batchShader = pending.batchShader.get();
+    if (defaultShader == 0 || shadowShader == 0 || batchShader == 0) {
+        throw std::runtime_error("Shader program linking failed");
+    }
+    uniformsFor(defaultShader);
+    uniformsFor(shadowShader);
     
     // Set current shader to default
     currentShader = defaultShader;
+    currentUniforms = &uniformsFor(defaultShader);
     glUseProgram(currentShader);
 }
 
@@ -297,7 +344,7 @@ void Renderer::initShapes() {
     glEnableVertexAttribArray(0);
     
     // Initialize circle
-    const int segments = 32;
+    const int segments = CIRCLE_SEGMENTS;
     std::vector<float> circleVertices;
     circleVertices.push_back(0.0f);
     circleVertices.push_back(0.0f);
@@ -326,7 +373,41 @@ void Renderer::initShapes() {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void Renderer::initBatch() {
+    // The batch draws the same unit shapes, instanced
+    PrimitiveShapeGeometry shapes[static_cast<size_t>(PrimitiveShape::COUNT)];
+    shapes[static_cast<size_t>(PrimitiveShape::TRIANGLE)] = { triangleVBO, 0, GL_TRIANGLES, 3 };
+    shapes[static_cast<size_t>(PrimitiveShape::RECTANGLE)] = { rectangleVBO, rectangleEBO, GL_TRIANGLES, 6 };
+    shapes[static_cast<size_t>(PrimitiveShape::CIRCLE)] = { circleVBO, 0, GL_TRIANGLE_FAN, CIRCLE_SEGMENTS + 2 };
+    if (!batch.initialize(batchShader, shapes)) {
+        throw std::runtime_error("Failed to initialize primitive batch");
+    }
+}
+
+void Renderer::setBatching(bool enabled) {
+    if (batching && !enabled) {
+        flush();
+    }
+    batching = enabled;
+}
+
+void Renderer::flush() {
+    if (batch.getPendingCount() == 0) return;
+    ProfileScope zone("2D batch", true);
+    // Immediate-mode draws since the last flush change GL behind the cache
+    batchState.invalidate();
+    drawCalls += batch.flush(viewMatrix, projectionMatrix, batchState);
+    // Back to the current program and the alpha blending init() set up
+    batchState.useProgram(currentShader);
+    batchState.setBlend(true);
+    batchState.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
 void Renderer::drawTriangle(const glm::vec2& position, float rotation, const glm::vec2& scale, const glm::vec4& color) {
+    if (batching) {
+        batch.add(PrimitiveShape::TRIANGLE, position, rotation, scale, color, batchLayer);
+        return;
+    }
     if (currentShader == 0) return;
     
     glm::mat4 model = glm::mat4(1.0f);
@@ -334,15 +415,20 @@ void Renderer::drawTriangle(const glm::vec2& position, float rotation, const glm
     model = glm::rotate(model, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
     model = glm::scale(model, glm::vec3(scale, 1.0f));
     
-    setUniform("model", model);
-    setUniform("color", color);
+    currentUniforms->model.set(model);
+    currentUniforms->color.set(color);
     
     glBindVertexArray(triangleVAO);
     glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
+    ++drawCalls;
 }
 
 void Renderer::drawRectangle(const glm::vec2& position, float rotation, const glm::vec2& scale, const glm::vec4& color) {
+    if (batching) {
+        batch.add(PrimitiveShape::RECTANGLE, position, rotation, scale, color, batchLayer);
+        return;
+    }
     if (currentShader == 0) return;
     
     glm::mat4 model = glm::mat4(1.0f);
@@ -350,158 +436,163 @@ void Renderer::drawRectangle(const glm::vec2& position, float rotation, const gl
     model = glm::rotate(model, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
     model = glm::scale(model, glm::vec3(scale, 1.0f));
     
-    setUniform("model", model);
-    setUniform("color", color);
+    currentUniforms->model.set(model);
+    currentUniforms->color.set(color);
     
     glBindVertexArray(rectangleVAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
+    ++drawCalls;
 }
 
 void Renderer::drawCircle(const glm::vec2& position, float radius, const glm::vec4& color) {
+    if (batching) {
+        batch.add(PrimitiveShape::CIRCLE, position, 0.0f, glm::vec2(radius * 2.0f), color, batchLayer);
+        return;
+    }
     if (currentShader == 0) return;
     
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(position, 0.0f));
     model = glm::scale(model, glm::vec3(radius * 2.0f, radius * 2.0f, 1.0f));
     
-    setUniform("model", model);
-    setUniform("color", color);
+    currentUniforms->model.set(model);
+    currentUniforms->color.set(color);
     
     glBindVertexArray(circleVAO);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 34); // 32 segments + center + first vertex repeated
     glBindVertexArray(0);
+    ++drawCalls;
 }
 
 void Renderer::setUniform(const std::string& name, const glm::mat4& value) {
-    GLint location = glGetUniformLocation(currentShader, name.c_str());
-    if (location == -1) {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
-        return;
-    }
+    GLint location = uniformLocation(name);
+    if (location == -1) return;
     glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
 void Renderer::setUniform(const std::string& name, const glm::vec3& value) {
-    GLint location = glGetUniformLocation(currentShader, name.c_str());
-    if (location == -1) {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
-        return;
-    }
+    GLint location = uniformLocation(name);
+    if (location == -1) return;
     glUniform3fv(location, 1, glm::value_ptr(value));
 }
 
 void Renderer::setUniform(const std::string& name, const glm::vec4& value) {
-    GLint location = glGetUniformLocation(currentShader, name.c_str());
-    if (location == -1) {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
-        return;
-    }
+    GLint location = uniformLocation(name);
+    if (location == -1) return;
     glUniform4fv(location, 1, glm::value_ptr(value));
 }
 
 void Renderer::setUniform(const std::string& name, float value) {
-    GLint location = glGetUniformLocation(currentShader, name.c_str());
-    if (location == -1) {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
-        return;
-    }
+    GLint location = uniformLocation(name);
+    if (location == -1) return;
     glUniform1f(location, value);
 }
 
 void Renderer::setUniform(const std::string& name, int value) {
-    GLint location = glGetUniformLocation(currentShader, name.c_str());
-    if (location == -1) {
-        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
-        return;
-    }
+    GLint location = uniformLocation(name);
+    if (location == -1) return;
     glUniform1i(location, value);
 }
 
-GLuint Renderer::createShader(const std::string& source, GLenum type) {
-    GLuint shader = glCreateShader(type);
-    const char* src = source.c_str();
-    glShaderSource(shader, 1, &src, nullptr);
-    glCompileShader(shader);
-    
-    checkShaderCompilation(shader, type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT");
-    
-    return shader;
+Renderer::ProgramUniforms& Renderer::uniformsFor(GLuint program) {
+    auto it = programUniforms.find(program);
+    if (it != programUniforms.end()) return it->second;
+
+    // First sight of this program: reflect it and resolve everything the renderer
+    // sets, so per-frame updates never build names or query the driver
+    ProgramUniforms& uniforms = programUniforms[program];
+    uniforms.cache.reflect(program);
+    uniforms.model = uniforms.cache.handle<glm::mat4>("model");
+    uniforms.view = uniforms.cache.handle<glm::mat4>("view");
+    uniforms.projection = uniforms.cache.handle<glm::mat4>("projection");
+    uniforms.lightSpaceMatrix = uniforms.cache.handle<glm::mat4>("lightSpaceMatrix");
+    uniforms.color = uniforms.cache.handle<glm::vec4>("color");
+    return uniforms;
+}
+
+GLint Renderer::uniformLocation(const std::string& name) {
+    if (currentShader == 0) return -1;
+    UniformCache& cache = uniformsFor(currentShader).cache;
+    GLint location = -1;
+    if (!cache.lookup(name, location)) {
+        // Remember the miss so the warning is printed once, not every frame
+        std::cerr << "Warning: Uniform '" << name << "' not found in shader" << std::endl;
+        cache.insert(name, -1);
+    }
+    return location;
 }
 
-void Renderer::checkShaderCompilation(GLuint shader, const std::string& type) {
-    GLint success;
-    GLchar infoLog[512];
-    
-    if (type == "PROGRAM") {
-        glGetProgramiv(shader, GL_LINK_STATUS, &success);
-        if (!success) {
-            glGetProgramInfoLog(shader, 512, NULL, infoLog);
-            std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-            throw std::runtime_error("Shader program linking failed");
-        }
-    } else {
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            glGetShaderInfoLog(shader, 512, NULL, infoLog);
-            std::cerr << "ERROR::SHADER::" << type << "::COMPILATION_FAILED\n" << infoLog << std::endl;
-            throw std::runtime_error("Shader compilation failed");
-        }
+GLuint Renderer::createProgram(const std::string& vertexCode, const std::string& fragmentCode) {
+    // Linked binaries are reused across runs; sources are only compiled on a miss
+    GLuint program = ShaderPipeline::shared().submit(vertexCode, fragmentCode, "renderer program").get();
+    if (program == 0) {
+        throw std::runtime_error("Shader program linking failed");
     }
+    return program;
 }
 
 void Renderer::setViewMatrix(const glm::mat4& view) {
+    flush(); // Queued shapes belong to the old camera
     viewMatrix = view;
     if (currentShader != 0) {
-        setUniform("view", viewMatrix);
+        currentUniforms->view.set(viewMatrix);
     }
 }
 
 void Renderer::setProjectionMatrix(const glm::mat4& projection) {
+    flush();
     projectionMatrix = projection;
     if (currentShader != 0) {
-        setUniform("projection", projectionMatrix);
+        currentUniforms->projection.set(projectionMatrix);
     }
 }
 
 void Renderer::addLight(const Light& light) {
     if (lights.size() < MAX_LIGHTS) {
         lights.push_back(light);
-        initShadowMap(lights.back());
-        setLightingUniforms();
+        lights.back().shadowMap = ShadowMap();
+        lights.back().shadowMap.lightSpaceMatrix = calculateLightSpaceMatrix(lights.back());
+        uploadLights();
     }
 }
 
 void Renderer::removeLight(int index) {
     if (index >= 0 && index < lights.size()) {
         lights.erase(lights.begin() + index);
-        setLightingUniforms();
+        uploadLights();
     }
 }
 
 void Renderer::updateLight(int index, const Light& light) {
     if (index >= 0 && index < lights.size()) {
+        // The atlas tile stays with the slot until the next renderShadowMaps()
+        const ShadowMap shadowMap = lights[index].shadowMap;
         lights[index] = light;
-        setLightingUniforms();
+        lights[index].shadowMap.atlasRect = shadowMap.atlasRect;
+        lights[index].shadowMap.lightSpaceMatrix = calculateLightSpaceMatrix(light);
+        uploadLights();
     }
 }
 
 void Renderer::clearLights() {
     lights.clear();
-    setLightingUniforms();
+    uploadLights();
 }
 
 void Renderer::useShader(GLuint shaderProgram) {
     if (shaderProgram != 0) {
+        flush();
         currentShader = shaderProgram;
+        currentUniforms = &uniformsFor(currentShader);
         glUseProgram(currentShader);
         
         // Update matrices
-        setUniform("view", viewMatrix);
-        setUniform("projection", projectionMatrix);
+        currentUniforms->view.set(viewMatrix);
+        currentUniforms->projection.set(projectionMatrix);
         
-        // Update lighting uniforms
-        setLightingUniforms();
+        // Light data is in the shared block; only the shadow map units need binding
+        bindShadowMaps();
     }
 }
 
@@ -525,72 +616,52 @@ std::vector<float> Renderer::generateCircleVertices(int segments) {
     return vertices;
 }
 
-void Renderer::initShadowMap(Light& light) {
-    // Generate framebuffer
-    glGenFramebuffers(1, &light.shadowMap.depthMapFBO);
-    
-    // Generate depth texture
-    glGenTextures(1, &light.shadowMap.depthMap);
-    glBindTexture(GL_TEXTURE_2D, light.shadowMap.depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    
-    // Attach depth texture to framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, light.shadowMap.depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, light.shadowMap.depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    
-    // Check framebuffer status
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        throw std::runtime_error("Framebuffer is not complete!");
-    }
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    
-    // Calculate initial light space matrix
-    light.shadowMap.lightSpaceMatrix = calculateLightSpaceMatrix(light);
+ShadowCasterId Renderer::addShadowCaster(const ShadowCaster& caster) {
+    return shadowAtlas.addCaster(caster);
+}
+
+void Renderer::setShadowCasterTransform(ShadowCasterId id, const glm::mat4& model) {
+    shadowAtlas.setCasterTransform(id, model);
+}
+
+void Renderer::removeShadowCaster(ShadowCasterId id) {
+    shadowAtlas.removeCaster(id);
 }
 
 void Renderer::renderShadowMaps() {
+    flush();
+    ProfileScope zone("Shadow maps", true);
+    
     // Save current viewport
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
     
-    // Use shadow shader
-    useShader(shadowShader);
-    
-    // Set viewport for shadow maps
-    glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    
-    for (const auto& light : lights) {
-        renderSceneToShadowMap(light);
+    // Only the first MAX_SHADOWED_LIGHTS lights cast shadows
+    const size_t shadowed = std::min<size_t>(lights.size(), MAX_SHADOWED_LIGHTS);
+    const glm::vec3 cameraPosition = glm::vec3(glm::inverse(viewMatrix)[3]);
+    ShadowLightView views[MAX_SHADOWED_LIGHTS];
+    for (size_t i = 0; i < shadowed; ++i) {
+        views[i].lightSpaceMatrix = lights[i].shadowMap.lightSpaceMatrix;
+        views[i].importance = shadowImportance(lights[i], cameraPosition);
     }
+    shadowAtlas.update(views, shadowed);
     
-    // Restore viewport
+    // Restore viewport and program
     glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glUseProgram(currentShader);
     
-    // Switch back to default shader
-    useShader(defaultShader);
-}
-
-void Renderer::renderSceneToShadowMap(const Light& light) {
-    glBindFramebuffer(GL_FRAMEBUFFER, light.shadowMap.depthMapFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
-    
-    // Set light space matrix uniform
-    setUniform("lightSpaceMatrix", light.shadowMap.lightSpaceMatrix);
-    
-    // Render scene geometry here
-    // Note: This should be a simplified version of your regular rendering code
-    // that only renders the depth information
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Tiles move only when the light set or the importances change
+    bool tilesChanged = false;
+    for (size_t i = 0; i < shadowed; ++i) {
+        const glm::vec4 rect = shadowAtlas.getTileRect(i);
+        if (rect != lights[i].shadowMap.atlasRect) {
+            lights[i].shadowMap.atlasRect = rect;
+            tilesChanged = true;
+        }
+    }
+    if (tilesChanged) {
+        uploadLights();
+    }
 }
 
 glm::mat4 Renderer::calculateLightSpaceMatrix(const Light& light) {
@@ -610,25 +681,31 @@ glm::mat4 Renderer::calculateLightSpaceMatrix(const Light& light) {
     return lightProjection * lightView;
 }
 
-void Renderer::setLightingUniforms() {
-    if (currentShader == 0) return;
-    
-    // Set number of active lights
-    setUniform("numLights", static_cast<int>(lights.size()));
-    
-    // Set light properties
+float Renderer::shadowImportance(const Light& light, const glm::vec3& cameraPosition) const {
+    // Full weight while the camera is inside the light's radius, falling off with distance
+    const float distance = glm::distance(light.position, cameraPosition);
+    return light.intensity * light.radius / std::max(distance, light.radius);
+}
+
+void Renderer::uploadLights() {
+    lightData.resize(lights.size());
     for (size_t i = 0; i < lights.size(); ++i) {
-        std::string prefix = "lights[" + std::to_string(i) + "].";
-        setUniform(prefix + "position", lights[i].position);
-        setUniform(prefix + "color", lights[i].color);
-        setUniform(prefix + "intensity", lights[i].intensity);
-        setUniform(prefix + "radius", lights[i].radius);
-        setUniform(prefix + "lightSpaceMatrix", lights[i].shadowMap.lightSpaceMatrix);
-        
-        // Bind shadow map texture
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, lights[i].shadowMap.depthMap);
-        setUniform(prefix + "shadowMap", static_cast<int>(i));
+        LightData& data = lightData[i];
+        data.positionRadius = glm::vec4(lights[i].position, lights[i].radius);
+        data.colorIntensity = glm::vec4(lights[i].color, lights[i].intensity);
+        data.lightSpaceMatrix = lights[i].shadowMap.lightSpaceMatrix;
+        data.shadowRect = lights[i].shadowMap.atlasRect;
+    }
+    FrameUniforms::shared().setLights(lightData.data(), lightData.size());
+    bindShadowMaps();
+}
+
+void Renderer::bindShadowMaps() {
+    // Every shadowed light samples its tile of the one atlas
+    if (!lights.empty()) {
+        glActiveTexture(GL_TEXTURE0 + SHADOW_ATLAS_UNIT);
+        glBindTexture(GL_TEXTURE_2D, shadowAtlas.getTexture());
+        glActiveTexture(GL_TEXTURE0);
     }
 }
 
@@ -1,16 +1,8 @@
-<<<<<<< HEAD
-#include "Shader.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
-
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
-    // 1. retrieve the vertex/fragment source code from filePath
-=======
 #include "Shader.hpp"
-#include <fstream>
-#include <sstream>
+#include "UniformBuffer.hpp"
+#include "ShaderSource.hpp"
 #include <iostream>
+#include <vector>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace TurtleEngine {
@@ -24,165 +16,40 @@ Shader::~Shader() {
 }
 
 bool Shader::loadFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
->>>>>>> feature/step2-latency-opt
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-<<<<<<< HEAD
-    
-    // ensure ifstream objects can throw exceptions:
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    
-    try {
-        // open files
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        // close file handlers
-        vShaderFile.close();
-        fShaderFile.close();
-        // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (std::ifstream::failure& e) {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-    }
-    
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    // 2. compile shaders
-    unsigned int vertex, fragment;
-    int success;
-    char infoLog[512];
-    
-    // vertex Shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    // print compile errors if any
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    // print compile errors if any
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // shader Program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    // print linking errors if any
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    
-    // delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-}
-
-void Shader::use() {
-    glUseProgram(ID);
-}
-
-void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
-}
-
-void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-}
-
-void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
-}
-
-void Shader::setVec2(const std::string &name, const glm::vec2 &value) const {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-}
-
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-}
-
-void Shader::setVec4(const std::string &name, const glm::vec4 &value) const {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-}
-
-void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    return submitFromFiles(vertexPath, fragmentPath) && finishLoading();
 }
 
-void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+bool Shader::submitFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
+    std::string vertexCode, fragmentCode;
+    std::vector<std::string> files;
+    ShaderSourceCache& sources = ShaderSourceCache::shared();
+    if (!sources.load(vertexPath, vertexCode, files) || !sources.load(fragmentPath, fragmentCode, files)) {
+        std::cerr << "ERROR::SHADER: Failed to read " << vertexPath << " or " << fragmentPath << std::endl;
+        return false;
+    }
+    submitSources(vertexCode, fragmentCode, vertexPath + " + " + fragmentPath);
+    return true;
 }
 
-void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::submitSources(const std::string& vertexCode, const std::string& fragmentCode, const std::string& label) {
+    m_pending = ShaderPipeline::shared().submit(vertexCode, fragmentCode, label);
 }
 
-GLuint Shader::getProgram() const {
-    return ID;
-=======
-
-    vShaderFile.open(vertexPath);
-    fShaderFile.open(fragmentPath);
-    std::stringstream vShaderStream, fShaderStream;
-
-    vShaderStream << vShaderFile.rdbuf();
-    fShaderStream << fShaderFile.rdbuf();
-
-    vertexCode = vShaderStream.str();
-    fragmentCode = fShaderStream.str();
-
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    unsigned int vertex, fragment;
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    if (!checkCompileErrors(vertex, "VERTEX")) {
-        return false;
+bool Shader::finishLoading() {
+    if (!m_pending.isValid()) {
+        return m_program != 0;
     }
-
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    if (!checkCompileErrors(fragment, "FRAGMENT")) {
+    GLuint program = m_pending.get();
+    m_pending = ProgramHandle();
+    if (program == 0) {
         return false;
     }
-
-    m_program = glCreateProgram();
-    glAttachShader(m_program, vertex);
-    glAttachShader(m_program, fragment);
-    glLinkProgram(m_program);
-    if (!checkCompileErrors(m_program, "PROGRAM")) {
-        return false;
+    if (m_program != 0) {
+        glDeleteProgram(m_program);
     }
-
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    m_program = program;
+    FrameUniforms::bindBlocks(m_program);
+    m_uniforms.reflect(m_program);
     return true;
 }
 
@@ -191,63 +58,23 @@ void Shader::use() {
 }
 
 void Shader::setBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(m_program, name.c_str()), (int)value);
+    uploadUniform(m_uniforms.find(name), value);
 }
 
 void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(m_program, name.c_str()), value);
+    uploadUniform(m_uniforms.find(name), value);
 }
 
 void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(m_program, name.c_str()), value);
+    uploadUniform(m_uniforms.find(name), value);
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(m_program, name.c_str()), 1, &value[0]);
+    uploadUniform(m_uniforms.find(name), value);
 }
 
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(m_program, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
-}
-
-bool Shader::checkCompileErrors(unsigned int shaderOrProgram, const std::string& type) {
-    int success = 0; // Initialize to 0
-    char infoLog[1024];
-    for(int i=0; i<1024; ++i) infoLog[i] = '\0'; // Clear log buffer
-
-    // Add check for valid ID
-    if (shaderOrProgram == 0) {
-        std::cout << "ERROR::SHADER: Invalid ID (0) passed to checkCompileErrors for type: " << type << std::endl;
-        return false;
-    }
-
-    if (type != "PROGRAM") {
-        // Check Shader Compilation
-        std::cout << "DEBUG::SHADER: Checking compile status for " << type << " (ID: " << shaderOrProgram << ")" << std::endl;
-        glGetShaderiv(shaderOrProgram, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            std::cout << "ERROR::SHADER: Compile failed for " << type << " (ID: " << shaderOrProgram << ")" << std::endl;
-            glGetShaderInfoLog(shaderOrProgram, 1024, NULL, infoLog);
-            std::cout << "  InfoLog: " << infoLog << std::endl;
-            return false;
-        } else {
-             std::cout << "DEBUG::SHADER: Compile successful for " << type << " (ID: " << shaderOrProgram << ")" << std::endl;
-        }
-    } else {
-        // Check Program Linking
-        std::cout << "DEBUG::SHADER: Checking link status for " << type << " (ID: " << shaderOrProgram << ")" << std::endl;
-        glGetProgramiv(shaderOrProgram, GL_LINK_STATUS, &success);
-        if (!success) {
-            std::cout << "ERROR::SHADER: Link failed for " << type << " (ID: " << shaderOrProgram << ")" << std::endl;
-            glGetProgramInfoLog(shaderOrProgram, 1024, NULL, infoLog);
-            std::cout << "  InfoLog: " << infoLog << std::endl;
-            return false;
-        } else {
-             std::cout << "DEBUG::SHADER: Link successful for " << type << " (ID: " << shaderOrProgram << ")" << std::endl;
-        }
-    }
-    return true;
+    uploadUniform(m_uniforms.find(name), mat);
 }
 
->>>>>>> feature/step2-latency-opt
 } 
\ No newline at end of file
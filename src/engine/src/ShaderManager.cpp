@@ -0,0 +1,231 @@
+#include "ShaderManager.hpp"
+#include "ShaderPipeline.hpp"
+#include "ShaderSource.hpp"
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace TurtleEngine {
+
+namespace {
+    // Without inotify, file times are checked at most this often
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(250);
+
+#ifdef __linux__
+    std::string directoryOf(const std::string& file) {
+        std::string directory = std::filesystem::path(file).parent_path().generic_string();
+        return directory.empty() ? "." : directory;
+    }
+#endif
+}
+
+ShaderManager& ShaderManager::shared() {
+    static ShaderManager instance;
+    return instance;
+}
+
+ShaderManager::ShaderManager() {
+#ifdef __linux__
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        std::cerr << "ERROR::ShaderManager: inotify unavailable, polling shader files instead" << std::endl;
+    }
+#endif
+}
+
+ShaderManager::~ShaderManager() {
+#ifdef __linux__
+    if (m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+    }
+#endif
+}
+
+ShaderId ShaderManager::load(const std::string& vertexPath, const std::string& fragmentPath) {
+    ShaderId id = submit(vertexPath, fragmentPath);
+    if (id != INVALID_SHADER && !finish(id)) {
+        release(id);
+        return INVALID_SHADER;
+    }
+    return id;
+}
+
+ShaderId ShaderManager::submit(const std::string& vertexPath, const std::string& fragmentPath) {
+    Entry entry;
+    entry.vertexPath = vertexPath;
+    entry.fragmentPath = fragmentPath;
+    entry.shader = std::make_unique<Shader>();
+
+    std::string vertexCode, fragmentCode;
+    if (!readSources(entry, vertexCode, fragmentCode, entry.files)) {
+        return INVALID_SHADER;
+    }
+    entry.shader->submitSources(vertexCode, fragmentCode, vertexPath + " + " + fragmentPath);
+    watch(entry.files);
+    m_entries.push_back(std::move(entry));
+    return static_cast<ShaderId>(m_entries.size() - 1);
+}
+
+bool ShaderManager::finish(ShaderId id) {
+    Entry& entry = m_entries[id];
+    if (!entry.loaded) {
+        entry.loaded = entry.shader->finishLoading();
+    }
+    return entry.loaded;
+}
+
+void ShaderManager::release(ShaderId id) {
+    if (id >= m_entries.size()) return; // Already gone with cleanup()
+    Entry& entry = m_entries[id];
+    entry.shader.reset();
+    entry.files.clear();
+    entry.pendingFiles.clear();
+    entry.loaded = false;
+    entry.dirty = false;
+}
+
+void ShaderManager::cleanup() {
+    m_entries.clear();
+}
+
+void ShaderManager::update() {
+    // Settles finished builds and drops the pipeline's record of them, so it holds
+    // only what is still compiling
+    ShaderPipeline::shared().poll();
+
+    std::vector<std::string> changed = takeChangedFiles();
+    if (!changed.empty()) {
+        m_stats.changedFiles += changed.size();
+        for (const std::string& file : changed) {
+            ShaderSourceCache::shared().invalidate(file);
+        }
+        for (Entry& entry : m_entries) {
+            for (const std::string& file : changed) {
+                if (std::find(entry.files.begin(), entry.files.end(), file) != entry.files.end() ||
+                    std::find(entry.pendingFiles.begin(), entry.pendingFiles.end(), file) != entry.pendingFiles.end()) {
+                    entry.dirty = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Without parallel compilation there is no way to ask without waiting, so a
+    // rebuild is finished on the update after it was submitted
+    const bool parallel = ShaderPipeline::shared().hasParallelCompile();
+    for (size_t id = 0; id < m_entries.size(); ++id) {
+        Entry& entry = m_entries[id];
+        if (!entry.loaded) continue;
+        Shader& shader = *entry.shader;
+
+        if (shader.isLoadPending() && (!parallel || shader.isLoadReady())) {
+            if (shader.finishLoading()) {
+                ++m_stats.reloads;
+                entry.files = std::move(entry.pendingFiles);
+                if (m_onReload) {
+                    m_onReload(static_cast<ShaderId>(id));
+                }
+            } else {
+                ++m_stats.failedReloads;
+            }
+            entry.pendingFiles.clear();
+        }
+
+        // An edit made while a rebuild is in flight waits for that build to land
+        if (entry.dirty && !shader.isLoadPending()) {
+            entry.dirty = false;
+            std::string vertexCode, fragmentCode;
+            std::vector<std::string> files;
+            if (!readSources(entry, vertexCode, fragmentCode, files)) {
+                ++m_stats.failedReloads;
+                continue;
+            }
+            watch(files);
+            entry.pendingFiles = std::move(files);
+            shader.submitSources(vertexCode, fragmentCode, entry.vertexPath + " + " + entry.fragmentPath);
+        }
+    }
+}
+
+bool ShaderManager::readSources(const Entry& entry, std::string& vertexCode, std::string& fragmentCode, std::vector<std::string>& files) {
+    ShaderSourceCache& sources = ShaderSourceCache::shared();
+    std::vector<std::string> fragmentFiles;
+    if (!sources.load(entry.vertexPath, vertexCode, files) || !sources.load(entry.fragmentPath, fragmentCode, fragmentFiles)) {
+        std::cerr << "ERROR::ShaderManager: Failed to read " << entry.vertexPath << " or " << entry.fragmentPath << std::endl;
+        return false;
+    }
+    for (const std::string& file : fragmentFiles) {
+        if (std::find(files.begin(), files.end(), file) == files.end()) {
+            files.push_back(file);
+        }
+    }
+    return true;
+}
+
+void ShaderManager::watch(const std::vector<std::string>& files) {
+    for (const std::string& file : files) {
+        if (m_fileTimes.count(file) == 0) {
+            std::error_code error;
+            m_fileTimes[file] = std::filesystem::last_write_time(file, error);
+        }
+#ifdef __linux__
+        if (m_inotifyFd < 0) continue;
+        // Directories, not files: editors often save by replacing the file
+        const std::string directory = directoryOf(file);
+        bool watched = false;
+        for (const auto& entry : m_watchedDirectories) {
+            watched = watched || entry.second == directory;
+        }
+        if (!watched) {
+            int descriptor = inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (descriptor < 0) {
+                std::cerr << "ERROR::ShaderManager: Cannot watch " << directory << std::endl;
+                continue;
+            }
+            m_watchedDirectories[descriptor] = directory;
+        }
+#endif
+    }
+}
+
+std::vector<std::string> ShaderManager::takeChangedFiles() {
+    std::vector<std::string> changed;
+#ifdef __linux__
+    if (m_inotifyFd >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                auto directory = m_watchedDirectories.find(event->wd);
+                if (event->len == 0 || directory == m_watchedDirectories.end()) continue;
+                const std::string file = ShaderSourceCache::normalize(directory->second + "/" + event->name);
+                // Only files some program reads; the rest of the directory is noise
+                if (m_fileTimes.count(file) != 0 && std::find(changed.begin(), changed.end(), file) == changed.end()) {
+                    changed.push_back(file);
+                }
+            }
+        }
+        return changed;
+    }
+#endif
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastPoll < POLL_INTERVAL) return changed;
+    m_lastPoll = now;
+    for (auto& entry : m_fileTimes) {
+        std::error_code error;
+        const auto time = std::filesystem::last_write_time(entry.first, error);
+        if (!error && time != entry.second) {
+            entry.second = time;
+            changed.push_back(entry.first);
+        }
+    }
+    return changed;
+}
+
+} // namespace TurtleEngine
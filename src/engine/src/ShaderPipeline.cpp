@@ -0,0 +1,167 @@
+#include "ShaderPipeline.hpp"
+#include "ProgramCache.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace TurtleEngine {
+
+namespace {
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    GLuint submitStage(GLenum type, const std::string& source) {
+        GLuint shader = glCreateShader(type);
+        const char* code = source.c_str();
+        glShaderSource(shader, 1, &code, nullptr);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    // Prints the stage's log if it failed; the program link fails with it
+    void reportStage(GLuint shader, const char* stage, const std::string& label) {
+        GLint success = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[1024] = {};
+            glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+            std::cerr << "ERROR::ShaderPipeline: " << stage << " compile failed for " << label << "\n" << infoLog << std::endl;
+        }
+    }
+}
+
+bool ProgramHandle::isReady() const {
+    if (!m_state) return false;
+    if (m_state->status == ProgramStatus::Compiling && ShaderPipeline::shared().hasParallelCompile() &&
+        ShaderPipeline::isComplete(*m_state)) {
+        ShaderPipeline::resolve(*m_state);
+    }
+    return m_state->status != ProgramStatus::Compiling;
+}
+
+GLuint ProgramHandle::get() const {
+    if (!m_state) return 0;
+    ShaderPipeline::resolve(*m_state);
+    return m_state->status == ProgramStatus::Ready ? m_state->program : 0;
+}
+
+ShaderPipeline& ShaderPipeline::shared() {
+    static ShaderPipeline instance;
+    return instance;
+}
+
+bool ShaderPipeline::hasParallelCompile() {
+    if (m_parallel < 0) {
+        m_parallel = GLEW_KHR_parallel_shader_compile ? 1 : 0;
+        if (m_parallel) {
+            // Let the driver pick how many threads to use
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        }
+    }
+    return m_parallel == 1;
+}
+
+ProgramHandle ShaderPipeline::submit(const std::string& vertexCode, const std::string& fragmentCode, const std::string& label) {
+    auto pending = std::make_shared<PendingProgram>();
+    pending->label = label;
+    pending->submitted = std::chrono::steady_clock::now();
+
+    ProgramCache& cache = ProgramCache::shared();
+    pending->program = cache.lookup({ &vertexCode, &fragmentCode });
+    if (pending->program != 0) {
+        pending->status = ProgramStatus::Ready;
+        return ProgramHandle(pending);
+    }
+
+    hasParallelCompile();
+    pending->vertexCode = vertexCode;
+    pending->fragmentCode = fragmentCode;
+    pending->vertex = submitStage(GL_VERTEX_SHADER, vertexCode);
+    pending->fragment = submitStage(GL_FRAGMENT_SHADER, fragmentCode);
+    pending->program = cache.createProgram();
+    glAttachShader(pending->program, pending->vertex);
+    glAttachShader(pending->program, pending->fragment);
+    // A stage that failed to compile fails the link; its log is read on resolve
+    glLinkProgram(pending->program);
+    pending->submitMilliseconds = millisecondsSince(pending->submitted);
+
+    m_pending.push_back(pending);
+    return ProgramHandle(pending);
+}
+
+size_t ShaderPipeline::poll() {
+    const bool parallel = hasParallelCompile();
+    for (auto& pending : m_pending) {
+        if (pending->status != ProgramStatus::Compiling) continue;
+        if (pending.use_count() == 1) {
+            // Nobody holds a handle any more
+            release(*pending);
+        } else if (parallel && isComplete(*pending)) {
+            resolve(*pending);
+        }
+    }
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+        [](const std::shared_ptr<PendingProgram>& pending) { return pending->status != ProgramStatus::Compiling; }),
+        m_pending.end());
+    return m_pending.size();
+}
+
+void ShaderPipeline::finish() {
+    for (auto& pending : m_pending) {
+        if (pending.use_count() == 1) {
+            release(*pending);
+        } else {
+            resolve(*pending);
+        }
+    }
+    m_pending.clear();
+}
+
+bool ShaderPipeline::isComplete(const PendingProgram& pending) {
+    GLint complete = GL_FALSE;
+    glGetProgramiv(pending.program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+void ShaderPipeline::resolve(PendingProgram& pending) {
+    if (pending.status != ProgramStatus::Compiling) return;
+
+    // Without parallel compilation the driver did the work inside the submit calls
+    // and this query; with it, the wait from submit is the best measure there is
+    const auto start = std::chrono::steady_clock::now();
+    GLint linked = GL_FALSE;
+    glGetProgramiv(pending.program, GL_LINK_STATUS, &linked);
+    const double compileMilliseconds = ShaderPipeline::shared().hasParallelCompile()
+        ? millisecondsSince(pending.submitted)
+        : pending.submitMilliseconds + millisecondsSince(start);
+
+    if (linked) {
+        ProgramCache::shared().store({ &pending.vertexCode, &pending.fragmentCode }, pending.program, compileMilliseconds);
+        pending.status = ProgramStatus::Ready;
+    } else {
+        reportStage(pending.vertex, "Vertex", pending.label);
+        reportStage(pending.fragment, "Fragment", pending.label);
+        char infoLog[1024] = {};
+        glGetProgramInfoLog(pending.program, sizeof(infoLog), nullptr, infoLog);
+        std::cerr << "ERROR::ShaderPipeline: Link failed for " << pending.label << "\n" << infoLog << std::endl;
+        glDeleteProgram(pending.program);
+        pending.program = 0;
+        pending.status = ProgramStatus::Failed;
+    }
+    glDeleteShader(pending.vertex);
+    glDeleteShader(pending.fragment);
+    pending.vertex = 0;
+    pending.fragment = 0;
+    pending.vertexCode.clear();
+    pending.fragmentCode.clear();
+}
+
+void ShaderPipeline::release(PendingProgram& pending) {
+    glDeleteShader(pending.vertex);
+    glDeleteShader(pending.fragment);
+    glDeleteProgram(pending.program);
+    pending = PendingProgram();
+    pending.status = ProgramStatus::Failed;
+}
+
+} // namespace TurtleEngine
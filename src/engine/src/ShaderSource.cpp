@@ -0,0 +1,97 @@
+#include "ShaderSource.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace TurtleEngine {
+
+ShaderSourceCache& ShaderSourceCache::shared() {
+    static ShaderSourceCache instance;
+    return instance;
+}
+
+std::string ShaderSourceCache::normalize(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+bool ShaderSourceCache::load(const std::string& path, std::string& source, std::vector<std::string>& files) {
+    source.clear();
+    files.clear();
+    const std::string root = normalize(path);
+    files.push_back(root);
+    std::vector<std::string> stack;
+    return expand(root, source, files, stack);
+}
+
+void ShaderSourceCache::invalidate(const std::string& path) {
+    m_files.erase(normalize(path));
+}
+
+const std::string* ShaderSourceCache::read(const std::string& path) {
+    auto it = m_files.find(path);
+    if (it != m_files.end()) {
+        ++m_stats.cacheHits;
+        return &it->second;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    ++m_stats.fileReads;
+    return &(m_files[path] = stream.str());
+}
+
+bool ShaderSourceCache::expand(const std::string& path, std::string& out, std::vector<std::string>& files, std::vector<std::string>& stack) {
+    const std::string* text = read(path);
+    if (!text) {
+        std::cerr << "ERROR::ShaderSourceCache: Cannot open " << path << std::endl;
+        return false;
+    }
+    const size_t fileIndex = std::find(files.begin(), files.end(), path) - files.begin();
+    stack.push_back(path);
+
+    std::istringstream lines(*text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+            out += line;
+            out += '\n';
+            continue;
+        }
+
+        const size_t open = line.find('"', start + 8);
+        const size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+        if (close == std::string::npos) {
+            std::cerr << "ERROR::ShaderSourceCache: " << path << ":" << lineNumber << ": expected #include \"file\"" << std::endl;
+            return false;
+        }
+        const std::string name = line.substr(open + 1, close - open - 1);
+        const std::string included = normalize((std::filesystem::path(path).parent_path() / name).string());
+        if (std::find(stack.begin(), stack.end(), included) != stack.end()) {
+            std::cerr << "ERROR::ShaderSourceCache: " << path << ":" << lineNumber << ": " << included << " includes itself" << std::endl;
+            return false;
+        }
+
+        size_t includedIndex = std::find(files.begin(), files.end(), included) - files.begin();
+        if (includedIndex == files.size()) {
+            files.push_back(included);
+        }
+        out += "#line 1 " + std::to_string(includedIndex) + "\n";
+        if (!expand(included, out, files, stack)) {
+            return false;
+        }
+        out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+    }
+
+    stack.pop_back();
+    return true;
+}
+
+} // namespace TurtleEngine
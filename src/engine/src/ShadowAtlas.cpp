@@ -0,0 +1,329 @@
+#include "ShadowAtlas.hpp"
+#include "Frustum.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace TurtleEngine {
+
+namespace {
+    // Odd bits of a Morton code; tiles are placed along a Z-order curve so that
+    // power-of-two squares packed largest first are always aligned
+    uint32_t compactBits(uint32_t v) {
+        v &= 0x55555555u;
+        v = (v | (v >> 1)) & 0x33333333u;
+        v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+        v = (v | (v >> 4)) & 0x00FF00FFu;
+        v = (v | (v >> 8)) & 0x0000FFFFu;
+        return v;
+    }
+
+    void transformBounds(const glm::mat4& model, const glm::vec3& min, const glm::vec3& max,
+                         glm::vec3& worldMin, glm::vec3& worldMax) {
+        worldMin = glm::vec3(INFINITY);
+        worldMax = glm::vec3(-INFINITY);
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 p((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+            glm::vec3 world = glm::vec3(model * glm::vec4(p, 1.0f));
+            worldMin = glm::min(worldMin, world);
+            worldMax = glm::max(worldMax, world);
+        }
+    }
+
+    GLuint createDepthTarget(int size, GLuint& texture) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // Put back whatever was bound: the renderer may be drawing into a RenderTarget
+        GLint previous = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous));
+            glDeleteFramebuffers(1, &framebuffer);
+            return 0;
+        }
+        glClear(GL_DEPTH_BUFFER_BIT);
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous));
+        return framebuffer;
+    }
+}
+
+ShadowAtlas::~ShadowAtlas() {
+    cleanup();
+}
+
+bool ShadowAtlas::initialize(GLuint depthProgram, int size) {
+    cleanup();
+    if (depthProgram == 0) {
+        std::cerr << "ERROR::ShadowAtlas: No depth program" << std::endl;
+        return false;
+    }
+    if (size < 2 * MIN_TILE_SIZE || (size & (size - 1)) != 0) {
+        std::cerr << "ERROR::ShadowAtlas: Size must be a power of two of at least " << 2 * MIN_TILE_SIZE << std::endl;
+        return false;
+    }
+    m_program = depthProgram;
+    UniformCache uniforms;
+    uniforms.reflect(depthProgram);
+    m_lightSpaceMatrix = uniforms.handle<glm::mat4>("lightSpaceMatrix");
+    m_model = uniforms.handle<glm::mat4>("model");
+
+    m_size = size;
+    glDepthMask(GL_TRUE);
+    m_framebuffer = createDepthTarget(size, m_texture);
+    m_staticFramebuffer = createDepthTarget(size, m_staticTexture);
+    if (m_framebuffer == 0 || m_staticFramebuffer == 0) {
+        std::cerr << "ERROR::ShadowAtlas: Depth framebuffer is not complete" << std::endl;
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+void ShadowAtlas::cleanup() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_staticFramebuffer != 0) {
+        glDeleteFramebuffers(1, &m_staticFramebuffer);
+        m_staticFramebuffer = 0;
+    }
+    if (m_texture != 0) {
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+    }
+    if (m_staticTexture != 0) {
+        glDeleteTextures(1, &m_staticTexture);
+        m_staticTexture = 0;
+    }
+    m_program = 0;
+    m_size = 0;
+    m_tiles.clear();
+    m_dirty.clear();
+}
+
+ShadowCasterId ShadowAtlas::addCaster(const ShadowCaster& caster) {
+    ShadowCasterId id;
+    if (!m_freeCasters.empty()) {
+        id = m_freeCasters.back();
+        m_freeCasters.pop_back();
+    } else {
+        id = static_cast<ShadowCasterId>(m_casters.size());
+        m_casters.emplace_back();
+    }
+    CasterSlot& slot = m_casters[id];
+    slot.caster = caster;
+    slot.alive = true;
+    transformBounds(caster.model, caster.boundsMin, caster.boundsMax, slot.worldMin, slot.worldMax);
+    markDirty(slot);
+    ++m_casterCount;
+    return id;
+}
+
+void ShadowAtlas::setCasterTransform(ShadowCasterId id, const glm::mat4& model) {
+    if (id >= m_casters.size() || !m_casters[id].alive) return;
+    CasterSlot& slot = m_casters[id];
+    if (slot.caster.model == model) return;
+    // Both where it was and where it is now need new shadows
+    markDirty(slot);
+    slot.caster.model = model;
+    transformBounds(model, slot.caster.boundsMin, slot.caster.boundsMax, slot.worldMin, slot.worldMax);
+    markDirty(slot);
+}
+
+void ShadowAtlas::removeCaster(ShadowCasterId id) {
+    if (id >= m_casters.size() || !m_casters[id].alive) return;
+    markDirty(m_casters[id]);
+    m_casters[id].alive = false;
+    m_freeCasters.push_back(id);
+    --m_casterCount;
+}
+
+void ShadowAtlas::markDirty(const CasterSlot& slot) {
+    m_dirty.push_back({ slot.worldMin, slot.worldMax, slot.caster.isStatic });
+}
+
+void ShadowAtlas::assignTiles(const ShadowLightView* lights, size_t count) {
+    const int maxTile = m_size / 2;
+    int maxLevel = 0;
+    while ((maxTile >> (maxLevel + 1)) >= MIN_TILE_SIZE) ++maxLevel;
+
+    // Each halving of importance below the top light drops one tile size
+    float top = 0.0f;
+    for (size_t i = 0; i < count; ++i) top = std::max(top, lights[i].importance);
+    std::vector<int> levels(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float importance = lights[i].importance;
+        if (importance <= 0.0f || top <= 0.0f) {
+            levels[i] = maxLevel;
+        } else {
+            levels[i] = std::clamp(static_cast<int>(std::floor(std::log2(top / importance))), 0, maxLevel);
+        }
+    }
+
+    // Area in MIN_TILE_SIZE units; shrink everything until it fits
+    const uint64_t capacity = static_cast<uint64_t>(m_size / MIN_TILE_SIZE) * (m_size / MIN_TILE_SIZE);
+    auto area = [&](int level) {
+        const uint64_t side = static_cast<uint64_t>((maxTile >> level) / MIN_TILE_SIZE);
+        return side * side;
+    };
+    int shift = 0;
+    while (true) {
+        uint64_t total = 0;
+        bool canShrink = false;
+        for (int level : levels) {
+            total += area(std::min(level + shift, maxLevel));
+            canShrink |= level + shift < maxLevel;
+        }
+        if (total <= capacity || !canShrink) break;
+        ++shift;
+    }
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return levels[a] < levels[b]; });
+
+    m_tiles.resize(count);
+    uint64_t offset = 0;
+    for (size_t i : order) {
+        Tile& tile = m_tiles[i];
+        const int level = std::min(levels[i] + shift, maxLevel);
+        const uint64_t tileArea = area(level);
+        int x = 0, y = 0, size = 0;
+        // Tiles are placed largest first, so 'offset' is always a multiple of tileArea
+        if (offset + tileArea <= capacity) {
+            x = static_cast<int>(compactBits(static_cast<uint32_t>(offset))) * MIN_TILE_SIZE;
+            y = static_cast<int>(compactBits(static_cast<uint32_t>(offset >> 1))) * MIN_TILE_SIZE;
+            size = maxTile >> level;
+            offset += tileArea;
+        }
+        if (tile.x != x || tile.y != y || tile.size != size) {
+            tile.staticValid = false;
+        }
+        tile.x = x;
+        tile.y = y;
+        tile.size = size;
+        tile.level = level;
+    }
+}
+
+void ShadowAtlas::beginTile(GLuint framebuffer, const Tile& tile) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(tile.x, tile.y, tile.size, tile.size);
+    glScissor(tile.x, tile.y, tile.size, tile.size);
+}
+
+void ShadowAtlas::drawCasters(const Tile& tile, bool isStatic) {
+    const Frustum frustum = Frustum::fromMatrix(tile.lightSpaceMatrix);
+    m_lightSpaceMatrix.set(tile.lightSpaceMatrix);
+    for (const CasterSlot& slot : m_casters) {
+        if (!slot.alive || slot.caster.isStatic != isStatic) continue;
+        if (!frustum.intersectsAABB(slot.worldMin, slot.worldMax)) continue;
+        const ShadowCaster& caster = slot.caster;
+        m_model.set(caster.model);
+        glBindVertexArray(caster.vao);
+        if (caster.indexType != 0) {
+            glDrawElements(caster.mode, caster.count, caster.indexType, nullptr);
+        } else {
+            glDrawArrays(caster.mode, 0, caster.count);
+        }
+        ++m_stats.casterDraws;
+    }
+    glBindVertexArray(0);
+}
+
+void ShadowAtlas::update(const ShadowLightView* lights, size_t count) {
+    m_stats = ShadowAtlasStats();
+    if (m_program == 0) return;
+    assignTiles(lights, count);
+
+    GLint framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean depthMask = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_SCISSOR_TEST); // Clears and copies stay inside the tile
+    glDepthMask(GL_TRUE);
+    glUseProgram(m_program);
+
+    bool hasDynamic = false;
+    for (const CasterSlot& slot : m_casters) {
+        hasDynamic |= slot.alive && !slot.caster.isStatic;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        Tile& tile = m_tiles[i];
+        if (tile.size == 0) continue;
+        if (tile.lightSpaceMatrix != lights[i].lightSpaceMatrix) {
+            tile.lightSpaceMatrix = lights[i].lightSpaceMatrix;
+            tile.staticValid = false;
+        }
+
+        const Frustum frustum = Frustum::fromMatrix(tile.lightSpaceMatrix);
+        bool compose = false;
+        for (const DirtyRegion& region : m_dirty) {
+            if (region.isStatic) {
+                if (tile.staticValid && frustum.intersectsAABB(region.min, region.max)) tile.staticValid = false;
+            } else if (!compose && frustum.intersectsAABB(region.min, region.max)) {
+                compose = true;
+            }
+        }
+
+        if (!tile.staticValid) {
+            beginTile(m_staticFramebuffer, tile);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            drawCasters(tile, true);
+            tile.staticValid = true;
+            ++m_stats.staticTiles;
+        } else if (compose) {
+            ++m_stats.composedTiles;
+        } else {
+            ++m_stats.reusedTiles;
+            continue;
+        }
+
+        // Static layer from the cache, dynamic casters over it
+        beginTile(m_framebuffer, tile);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_staticFramebuffer);
+        glBlitFramebuffer(tile.x, tile.y, tile.x + tile.size, tile.y + tile.size,
+                          tile.x, tile.y, tile.x + tile.size, tile.y + tile.size,
+                          GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        if (hasDynamic) {
+            drawCasters(tile, false);
+        }
+    }
+    m_dirty.clear();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(framebuffer));
+    if (!scissorTest) glDisable(GL_SCISSOR_TEST);
+    if (!depthTest) glDisable(GL_DEPTH_TEST);
+    glDepthMask(depthMask);
+}
+
+glm::vec4 ShadowAtlas::getTileRect(size_t light) const {
+    if (light >= m_tiles.size() || m_tiles[light].size == 0) return glm::vec4(0.0f);
+    const Tile& tile = m_tiles[light];
+    const float scale = 1.0f / static_cast<float>(m_size);
+    return glm::vec4(tile.x * scale, tile.y * scale, tile.size * scale, tile.size * scale);
+}
+
+int ShadowAtlas::getTileSize(size_t light) const {
+    return light < m_tiles.size() ? m_tiles[light].size : 0;
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,165 @@
+#include "UniformBuffer.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace TurtleEngine {
+
+UniformBuffer::~UniformBuffer() {
+    cleanup();
+}
+
+bool UniformBuffer::initialize(GLuint binding, size_t size) {
+    cleanup();
+    glGenBuffers(1, &m_buffer);
+    if (m_buffer == 0) {
+        std::cerr << "ERROR::UniformBuffer: Failed to create buffer" << std::endl;
+        return false;
+    }
+    m_binding = binding;
+    m_size = size;
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    bind();
+    return true;
+}
+
+void UniformBuffer::cleanup() {
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_size = 0;
+}
+
+void UniformBuffer::update(const void* data, size_t size, size_t offset) {
+    if (m_buffer == 0 || offset + size > m_size) {
+        std::cerr << "ERROR::UniformBuffer: Update outside the buffer" << std::endl;
+        return;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    bind(); // Someone may have reused the binding point since
+}
+
+void UniformBuffer::bind() const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_buffer);
+}
+
+FrameUniforms& FrameUniforms::shared() {
+    static FrameUniforms instance;
+    return instance;
+}
+
+void FrameUniforms::bindBlocks(GLuint program) {
+    const GLuint camera = glGetUniformBlockIndex(program, "Camera");
+    if (camera != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, camera, CAMERA_BLOCK_BINDING);
+    }
+    const GLuint lights = glGetUniformBlockIndex(program, "Lights");
+    if (lights != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, lights, LIGHTS_BLOCK_BINDING);
+    }
+
+    // Sampler units are program state, so the program has to be current to set them
+    const struct { const char* name; GLint unit; } samplers[] = {
+        { "shadowAtlas", SHADOW_ATLAS_UNIT },
+        { "clusterLights", CLUSTER_LIGHTS_UNIT },
+        { "clusterRanges", CLUSTER_RANGES_UNIT },
+        { "clusterIndices", CLUSTER_INDICES_UNIT },
+    };
+    GLint previous = -1;
+    for (const auto& sampler : samplers) {
+        const GLint location = glGetUniformLocation(program, sampler.name);
+        if (location < 0) continue;
+        if (previous < 0) {
+            glGetIntegerv(GL_CURRENT_PROGRAM, &previous);
+            glUseProgram(program);
+        }
+        glUniform1i(location, sampler.unit);
+    }
+    if (previous >= 0) {
+        glUseProgram(static_cast<GLuint>(previous));
+    }
+}
+
+bool FrameUniforms::ensureBuffers() {
+    if (m_cameraBuffer.isInitialized()) return true;
+    if (!m_cameraBuffer.initialize(CAMERA_BLOCK_BINDING, sizeof(CameraBlock)) ||
+        !m_lightsBuffer.initialize(LIGHTS_BLOCK_BINDING, sizeof(LightsBlock))) {
+        cleanup();
+        return false;
+    }
+    // Programs may read the lights before anyone sets them
+    LightsBlock empty;
+    m_lightsBuffer.update(&empty, sizeof(empty));
+    return true;
+}
+
+void FrameUniforms::setCamera(const glm::mat4& view, const glm::mat4& projection) {
+    if (!ensureBuffers()) return;
+    if (!m_cameraValid || std::memcmp(&m_camera.view, &view, sizeof(view)) != 0 ||
+        std::memcmp(&m_camera.projection, &projection, sizeof(projection)) != 0) {
+        m_camera.view = view;
+        m_camera.projection = projection;
+        m_camera.viewProjection = projection * view;
+        m_camera.position = glm::inverse(view)[3];
+        m_cameraValid = true;
+        m_cameraBuffer.update(&m_camera, sizeof(m_camera));
+        ++m_cameraUploads;
+        m_clustersDirty = !m_lights.empty();
+    }
+    if (m_clustersDirty) {
+        updateClusters();
+    }
+}
+
+void FrameUniforms::setLights(const LightData* lights, size_t count) {
+    if (!ensureBuffers()) return;
+    count = std::min(count, LightClusters::MAX_LIGHTS);
+    m_lights.assign(lights, lights + count);
+
+    // Only the used entries and the count are sent
+    const int32_t lightCount = static_cast<int32_t>(std::min<size_t>(count, MAX_BLOCK_LIGHTS));
+    m_lightsBuffer.update(lights, sizeof(LightData) * lightCount);
+    m_lightsBuffer.update(&lightCount, sizeof(lightCount), offsetof(LightsBlock, lightCount));
+    ++m_lightUploads;
+
+    if (count == 0) {
+        // Nothing to cluster; the shader falls back to its default light
+        const glm::ivec4 none(0);
+        m_lightsBuffer.update(&none, sizeof(none), offsetof(LightsBlock, clusterGrid));
+        m_clustersDirty = false;
+    } else {
+        m_clustersDirty = true; // Built on the next setCamera()
+    }
+}
+
+void FrameUniforms::updateClusters() {
+    m_clustersDirty = false;
+    m_clusters.build(m_camera.view, m_camera.projection, m_lights.data(), m_lights.size(), &JobSystem::shared());
+    if (!m_clusters.upload(m_lights.data(), m_lights.size())) return;
+    struct {
+        glm::ivec4 grid;
+        glm::vec4 depth;
+    } params = { glm::ivec4(LightClusters::GRID_X, LightClusters::GRID_Y, LightClusters::GRID_Z, static_cast<int>(m_lights.size())),
+                 m_clusters.getDepthParams() };
+    static_assert(offsetof(LightsBlock, clusterDepth) == offsetof(LightsBlock, clusterGrid) + sizeof(glm::ivec4),
+                  "Cluster parameters are uploaded together");
+    m_lightsBuffer.update(&params, sizeof(params), offsetof(LightsBlock, clusterGrid));
+    ++m_clusterBuilds;
+}
+
+void FrameUniforms::cleanup() {
+    m_cameraBuffer.cleanup();
+    m_lightsBuffer.cleanup();
+    m_clusters.cleanup();
+    m_cameraValid = false;
+    m_lights.clear();
+    m_clustersDirty = false;
+}
+
+} // namespace TurtleEngine
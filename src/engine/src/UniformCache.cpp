@@ -0,0 +1,54 @@
+#include "UniformCache.hpp"
+#include <vector>
+
+namespace TurtleEngine {
+
+void UniformCache::reflect(GLuint program) {
+    m_locations.clear();
+    if (program == 0) return;
+
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> buffer(static_cast<size_t>(maxLength) + 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, static_cast<GLuint>(i), maxLength, &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), static_cast<size_t>(length));
+        GLint location = glGetUniformLocation(program, name.c_str());
+        if (location < 0) continue; // Block members have no location
+
+        m_locations[name] = location;
+        // Arrays of plain types come back once as "name[0]" with their size
+        const size_t bracket = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0 ? name.size() - 3 : std::string::npos;
+        if (bracket != std::string::npos) {
+            const std::string base = name.substr(0, bracket);
+            m_locations[base] = location;
+            for (GLint element = 1; element < size; ++element) {
+                std::string elementName = base + "[" + std::to_string(element) + "]";
+                m_locations[elementName] = glGetUniformLocation(program, elementName.c_str());
+            }
+        }
+    }
+}
+
+GLint UniformCache::find(const std::string& name) const {
+    auto it = m_locations.find(name);
+    return it != m_locations.end() ? it->second : -1;
+}
+
+bool UniformCache::lookup(const std::string& name, GLint& location) const {
+    auto it = m_locations.find(name);
+    if (it == m_locations.end()) {
+        location = -1;
+        return false;
+    }
+    location = it->second;
+    return true;
+}
+
+} // namespace TurtleEngine
@@ -0,0 +1,129 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "FlowField.hpp"
+
+using namespace TurtleEngine;
+
+// FlowField is plain CPU data, so no GL context is needed.
+
+namespace {
+    // Follows the field from a cell; returns the number of steps to a goal, -1 if stuck
+    int walk(const FlowField& field, glm::ivec2 cell) {
+        const int dx[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+        const int dy[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+        for (int steps = 0; steps < field.getWidth() * field.getHeight(); ++steps) {
+            FlowField::Direction d = field.getDirection(cell.x, cell.y);
+            if (d == FlowField::GOAL) return steps;
+            if (d == FlowField::NONE) return -1;
+            cell += glm::ivec2(dx[d], dy[d]);
+            assert(field.getCost(cell.x, cell.y) != FlowField::IMPASSABLE);
+        }
+        return -1;
+    }
+}
+
+void TestOpenFieldPointsAtGoal()
+{
+    std::cout << "  Test: Every cell of an open field leads to the goal" << std::endl;
+    FlowField field(16, 16, 1.0f);
+    field.setGoal(glm::vec3(0.5f, 0.0f, 0.5f)); // Cell (8, 8)
+    field.build();
+
+    assert(field.getDirection(8, 8) == FlowField::GOAL);
+    assert(field.getDirection(0, 8) == FlowField::EAST);
+    assert(field.getDirection(8, 15) == FlowField::NORTH);
+    assert(field.getDirection(0, 0) == FlowField::SOUTH_EAST);
+    assert(std::fabs(field.getIntegration(0, 0) - 8.0f * std::sqrt(2.0f)) < 1e-4f);
+
+    // Diagonal steps are normalised for steering
+    glm::vec2 steer = field.sampleDirection(glm::vec3(-7.5f, 0.0f, -7.5f));
+    assert(std::fabs(glm::length(steer) - 1.0f) < 1e-5f && steer.x > 0.0f && steer.y > 0.0f);
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) assert(walk(field, glm::ivec2(x, y)) == std::max(std::abs(x - 8), std::abs(y - 8)));
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestWallsAndSeveralGoals()
+{
+    std::cout << "  Test: Routes go round walls to the nearest goal" << std::endl;
+    FlowField field(12, 12, 1.0f);
+    // Vertical wall at x = 6 with a gap at y = 10
+    for (int y = 0; y < 12; ++y) {
+        if (y != 10) field.setCost(6, y, FlowField::IMPASSABLE);
+    }
+    field.setGoals({ glm::ivec2(0, 0), glm::ivec2(11, 0) });
+    field.build();
+
+    assert(field.getDirection(6, 3) == FlowField::NONE);
+    assert(walk(field, glm::ivec2(2, 5)) == 5);  // Left goal, straight up the diagonal
+    assert(walk(field, glm::ivec2(9, 5)) == 5);  // Right goal
+    assert(field.getDirection(7, 0) == FlowField::EAST); // Cannot cross the wall to the closer-looking side
+
+    // Seal the gap and wall off the bottom-left corner: each half still reaches its own
+    // goal, the enclosed pocket reaches nothing
+    field.setCost(6, 10, FlowField::IMPASSABLE);
+    for (int x = 0; x < 3; ++x) field.setCost(x, 9, FlowField::IMPASSABLE);
+    field.setCost(3, 10, FlowField::IMPASSABLE);
+    field.setCost(3, 11, FlowField::IMPASSABLE);
+    field.update();
+    assert(walk(field, glm::ivec2(1, 10)) == -1);
+    assert(std::isinf(field.getIntegration(1, 10)));
+    assert(walk(field, glm::ivec2(5, 11)) > 0);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestIncrementalUpdateMatchesRebuild()
+{
+    std::cout << "  Test: Incremental updates match a full rebuild" << std::endl;
+    const int size = 48;
+    FlowField incremental(size, size, 1.0f);
+    FlowField reference(size, size, 1.0f);
+    std::vector<glm::ivec2> goals = { glm::ivec2(5, 5), glm::ivec2(40, 30) };
+    incremental.setGoals(goals);
+    reference.setGoals(goals);
+    incremental.build();
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> coordinate(0, size - 1);
+    std::uniform_int_distribution<int> cost(1, 12);
+    for (int round = 0; round < 40; ++round) {
+        // A handful of edits: walls going up and down, terrain getting cheaper or dearer
+        for (int edit = 0; edit < 6; ++edit) {
+            int x = coordinate(rng), y = coordinate(rng);
+            int c = cost(rng);
+            uint8_t value = c > 9 ? FlowField::IMPASSABLE : static_cast<uint8_t>(c);
+            incremental.setCost(x, y, value);
+            reference.setCost(x, y, value);
+        }
+        incremental.update();
+        reference.build();
+        assert(incremental.getLastUpdatedCells() < static_cast<size_t>(size * size));
+
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                float a = incremental.getIntegration(x, y);
+                float b = reference.getIntegration(x, y);
+                assert((std::isinf(a) && std::isinf(b)) || std::fabs(a - b) < 1e-3f);
+                // Ties may pick different steps, but every route must still lead home
+                assert((incremental.getDirection(x, y) == FlowField::NONE) == (reference.getDirection(x, y) == FlowField::NONE));
+                if (!std::isinf(a)) assert(walk(incremental, glm::ivec2(x, y)) >= 0);
+            }
+        }
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running FlowField Tests..." << std::endl;
+    TestOpenFieldPointsAtGoal();
+    TestWallsAndSeveralGoals();
+    TestIncrementalUpdateMatchesRebuild();
+    std::cout << "FlowField Tests Completed Successfully!" << std::endl;
+    return 0;
+}
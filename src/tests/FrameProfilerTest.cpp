@@ -0,0 +1,225 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <GL/glew.h>
+#include "GLTestContext.hpp"
+#include "FrameProfiler.hpp"
+#include "UniformBuffer.hpp"
+
+using namespace TurtleEngine;
+
+// CPU zones and GPU timer queries on one timeline. Needs a GL context; CI runs it
+// on Mesa llvmpipe.
+
+namespace {
+    void busyWait(double ms) {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(ms);
+        while (std::chrono::steady_clock::now() < end) {}
+    }
+
+    // Enough fill work for the GPU timestamps to move
+    void clearTarget(GLuint fbo) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, 256, 256);
+        for (int i = 0; i < 8; ++i) {
+            glClearColor(i * 0.1f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    const ProfileZone* findZone(const ProfileFrame& frame, const char* name, ProfileTrack track) {
+        for (const ProfileZone& zone : frame.zones) {
+            if (zone.track == track && std::strcmp(zone.name, name) == 0) return &zone;
+        }
+        return nullptr;
+    }
+}
+
+void TestCpuZonesNest()
+{
+    std::cout << "  Test: CPU zones nest and sit inside their frame" << std::endl;
+    FrameProfiler profiler;
+    profiler.beginFrame();
+    profiler.beginZone("Update", false);
+    busyWait(2.0);
+    profiler.beginZone("Physics", false);
+    busyWait(1.0);
+    profiler.endZone(false);
+    profiler.endZone(false);
+    profiler.beginZone("Render", false);
+    profiler.endZone(false);
+    profiler.endFrame();
+
+    // Without GPU zones the frame completes at endFrame
+    assert(profiler.getHistory().size() == 1);
+    const ProfileFrame& frame = *profiler.getLatestFrame();
+    assert(frame.frame == 0);
+    assert(frame.zones.size() == 3);
+    assert(frame.gpuMs == 0.0);
+
+    const ProfileZone* update = findZone(frame, "Update", ProfileTrack::CPU);
+    const ProfileZone* physics = findZone(frame, "Physics", ProfileTrack::CPU);
+    const ProfileZone* render = findZone(frame, "Render", ProfileTrack::CPU);
+    assert(update && physics && render);
+    assert(update->depth == 0 && physics->depth == 1 && render->depth == 0);
+    assert(update->durationMs >= 3.0 && physics->durationMs >= 1.0);
+    assert(physics->startMs >= update->startMs);
+    assert(physics->startMs + physics->durationMs <= update->startMs + update->durationMs);
+    assert(render->startMs >= update->startMs + update->durationMs);
+    assert(frame.cpuMs >= update->durationMs);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestZonesOutsideFrameIgnored()
+{
+    std::cout << "  Test: Zones outside beginFrame/endFrame are ignored" << std::endl;
+    FrameProfiler profiler;
+    profiler.beginZone("Loading", true);
+    profiler.endZone(true);
+    profiler.endZone(false); // Unbalanced end
+    profiler.endFrame();     // End without begin
+    assert(profiler.getHistory().empty());
+
+    // GPU zones before initialize() keep their CPU half
+    profiler.beginFrame();
+    profiler.beginZone("Pass", true);
+    profiler.endZone(true);
+    profiler.endFrame();
+    assert(profiler.getHistory().size() == 1);
+    assert(profiler.getLatestFrame()->zones.size() == 1);
+    assert(profiler.getLatestFrame()->zones[0].track == ProfileTrack::CPU);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestGpuZonesResolveLate(GLuint fbo)
+{
+    std::cout << "  Test: GPU zones are read back frames later, without stalling" << std::endl;
+    FrameProfiler profiler;
+    const bool initialized = profiler.initialize();
+    assert(initialized);
+    assert(profiler.hasGpuTimers());
+
+    // Run frames until a few have come back; the profiler never blocks, so frames
+    // complete whenever the driver has their results
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    uint64_t frames = 0;
+    while (profiler.getHistory().size() < 6) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        profiler.beginFrame();
+        profiler.beginZone("Shadow maps", true);
+        clearTarget(fbo);
+        profiler.beginZone("Inner", true);
+        clearTarget(fbo);
+        profiler.endZone(true);
+        profiler.endZone(true);
+        profiler.beginZone("2D batch", true);
+        clearTarget(fbo);
+        profiler.endZone(true);
+        profiler.endFrame();
+        glFlush();
+        ++frames;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Frames finish in order, each once
+    const std::deque<ProfileFrame>& history = profiler.getHistory();
+    for (size_t i = 0; i < history.size(); ++i) {
+        assert(history[i].frame == i);
+    }
+    std::cout << "    (" << frames << " frames submitted, " << history.size() << " resolved, "
+              << profiler.getDroppedGpuFrames() << " dropped)" << std::endl;
+
+    size_t timed = 0;
+    for (const ProfileFrame& frame : history) {
+        const ProfileZone* shadows = findZone(frame, "Shadow maps", ProfileTrack::GPU);
+        if (!shadows) continue; // Dropped: CPU zones only
+        ++timed;
+        const ProfileZone* inner = findZone(frame, "Inner", ProfileTrack::GPU);
+        const ProfileZone* batch = findZone(frame, "2D batch", ProfileTrack::GPU);
+        const ProfileZone* cpuShadows = findZone(frame, "Shadow maps", ProfileTrack::CPU);
+        assert(inner && batch && cpuShadows);
+        assert(shadows->depth == 0 && inner->depth == 1 && batch->depth == 0);
+        assert(shadows->durationMs >= 0.0 && batch->durationMs >= 0.0);
+        assert(inner->startMs >= shadows->startMs);
+        assert(inner->startMs + inner->durationMs <= shadows->startMs + shadows->durationMs + 1e-6);
+        assert(batch->startMs >= shadows->startMs + shadows->durationMs - 1e-6);
+        assert(frame.gpuMs >= shadows->durationMs);
+        // GPU work cannot start before the CPU issued it (allowing for clock sync jitter)
+        assert(shadows->startMs >= cpuShadows->startMs - 1.0);
+    }
+    assert(timed > 0);
+    profiler.cleanup();
+    assert(!profiler.hasGpuTimers());
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestChromeTrace(GLuint fbo)
+{
+    std::cout << "  Test: The Chrome trace has CPU and GPU tracks" << std::endl;
+    FrameProfiler profiler;
+    const bool initialized = profiler.initialize();
+    assert(initialized);
+    profiler.beginFrame();
+    profiler.beginZone("Particles", true);
+    clearTarget(fbo);
+    profiler.endZone(true);
+    profiler.endFrame();
+    glFinish();
+    // Results are collected on the next frame boundary
+    profiler.beginFrame();
+    profiler.endFrame();
+    assert(profiler.getHistory().size() == 2);
+
+    const std::string path = "frame_profiler_test_trace.json";
+    const bool written = profiler.writeChromeTrace(path);
+    assert(written);
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    const std::string json = text.str();
+    assert(json.rfind("{\"traceEvents\":[", 0) == 0);
+    assert(json.find("\"name\":\"Particles\",\"ph\":\"X\",\"pid\":1,\"tid\":1") != std::string::npos);
+    assert(json.find("\"name\":\"Particles\",\"ph\":\"X\",\"pid\":1,\"tid\":2") != std::string::npos);
+    assert(json.find("\n]}") != std::string::npos);
+    file.close();
+    std::remove(path.c_str());
+    profiler.cleanup();
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running FrameProfiler Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    GLuint color, fbo;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 256, 256);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    TestCpuZonesNest();
+    TestZonesOutsideFrameIgnored();
+    TestGpuZonesResolveLate(fbo);
+    TestChromeTrace(fbo);
+
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    std::cout << "FrameProfiler Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <iostream>
+#include <GL/glew.h>
+#include "FrameProfiler.hpp"
+#include "HeadlessContext.hpp"
+#include "RenderTarget.hpp"
+#include "ShaderManager.hpp"
+#include "UniformBuffer.hpp"
+
+namespace TurtleEngine {
+
+// The GL 4.0 core context every GL test runs on: a HeadlessContext, so no window
+// or display server is needed (CI uses Mesa llvmpipe). Declare one at the top of
+// main() and return 1 if it is not valid. A small offscreen target stays bound in
+// place of the window's framebuffer: a surfaceless context has none, and draws
+// (transform feedback included) fail against it. On destruction the engine
+// singletons that own GL objects are cleaned up before the context goes away.
+class GLTestContext {
+public:
+    GLTestContext() {
+        if (!m_context.initialize(4, 0)) {
+            std::cerr << "Failed to create a headless GL context" << std::endl;
+            return;
+        }
+        if (!m_target.initialize(64, 64)) {
+            m_context.cleanup();
+            return;
+        }
+        m_target.bind();
+    }
+    ~GLTestContext() {
+        if (m_context.isValid()) {
+            ShaderManager::shared().cleanup();
+            FrameProfiler::shared().cleanup();
+            FrameUniforms::shared().cleanup();
+            m_target.cleanup();
+        }
+        m_context.cleanup();
+    }
+    GLTestContext(const GLTestContext&) = delete;
+    GLTestContext& operator=(const GLTestContext&) = delete;
+
+    bool isValid() const { return m_context.isValid(); }
+    const HeadlessContext& get() const { return m_context; }
+
+private:
+    HeadlessContext m_context;
+    RenderTarget m_target;
+};
+
+} // namespace TurtleEngine
@@ -0,0 +1,233 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLTestContext.hpp"
+#include "Grid.hpp"
+
+using namespace TurtleEngine;
+
+// Chunked Grid rendering: dirty-region colour uploads, chunk culling and the two
+// render modes. Needs a GL context; CI runs it on Mesa llvmpipe.
+
+namespace {
+    // Renders the grid top-down (orthographic, 'halfExtent' world units around 'centre')
+    // into an FBO of the given size and returns the RGBA pixels
+    std::vector<uint8_t> renderTopDown(Grid& grid, const glm::vec2& centre, const glm::vec2& halfExtent,
+                                       int width, int height) {
+        GLuint fbo = 0, colorBuffer = 0;
+        glGenFramebuffers(1, &fbo);
+        glGenRenderbuffers(1, &colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+        assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+        glViewport(0, 0, width, height);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glm::mat4 view = glm::lookAt(glm::vec3(centre.x, 10.0f, centre.y), glm::vec3(centre.x, 0.0f, centre.y),
+                                     glm::vec3(0.0f, 0.0f, -1.0f));
+        glm::mat4 projection = glm::ortho(-halfExtent.x, halfExtent.x, -halfExtent.y, halfExtent.y, 0.1f, 100.0f);
+        grid.render(projection, view);
+
+        std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteFramebuffers(1, &fbo);
+        return pixels;
+    }
+
+    // Whole grid on screen at 8 pixels per cell; returns the RGB at every cell centre
+    std::vector<uint8_t> renderCellCentres(Grid& grid) {
+        const int cellPixels = 8;
+        const int width = grid.getWidth() * cellPixels;
+        const int height = grid.getHeight() * cellPixels;
+        glm::vec2 half(grid.getWidth() * grid.getCellSize() * 0.5f, grid.getHeight() * grid.getCellSize() * 0.5f);
+        std::vector<uint8_t> pixels = renderTopDown(grid, glm::vec2(0.0f), half, width, height);
+
+        std::vector<uint8_t> centres;
+        for (int y = 0; y < grid.getHeight(); ++y) {
+            for (int x = 0; x < grid.getWidth(); ++x) {
+                const uint8_t* p = &pixels[((y * cellPixels + cellPixels / 2) * width + x * cellPixels + cellPixels / 2) * 4];
+                centres.insert(centres.end(), p, p + 3);
+            }
+        }
+        return centres;
+    }
+}
+
+void TestSingleCellUploadsOnlyThatCell()
+{
+    std::cout << "  Test: One changed cell uploads one cell" << std::endl;
+
+    Grid grid(64, 64, 1.0f, GridRenderMode::PER_VERTEX_COLOR);
+    renderCellCentres(grid); // Chunks upload nothing until they have been drawn once
+    assert(!grid.hasPendingColors());
+
+    grid.setCellColor(10, 20, glm::vec3(1.0f, 0.0f, 0.0f));
+    grid.setCellColor(10, 20, glm::vec3(0.0f, 1.0f, 0.0f)); // Same cell twice: still one span
+    assert(grid.hasPendingColors());
+    grid.flushColors();
+
+    assert(!grid.hasPendingColors());
+    assert(grid.getLastFlushUploads() == 1);
+    assert(grid.getLastFlushBytes() == 4 * sizeof(glm::vec3));
+    assert(grid.getCellColor(10, 20) == glm::vec3(0.0f, 1.0f, 0.0f));
+    assert(grid.getCellColor(-1, 20) == glm::vec3(0.0f) && grid.getCellColor(10, 64) == glm::vec3(0.0f));
+    assert(glGetError() == GL_NO_ERROR);
+
+    // The texture mode sends one RGB8 texel
+    Grid textured(64, 64, 1.0f);
+    assert(textured.getRenderMode() == GridRenderMode::COLOR_TEXTURE);
+    renderCellCentres(textured);
+    textured.setCellColor(10, 20, glm::vec3(0.0f, 1.0f, 0.0f));
+    textured.flushColors();
+    assert(textured.getLastFlushUploads() == 1);
+    assert(textured.getLastFlushBytes() == 3);
+    assert(glGetError() == GL_NO_ERROR);
+
+    // Out of range writes are ignored and leave nothing to flush
+    grid.setCellColor(-1, 0, glm::vec3(1.0f));
+    grid.setCellColor(0, 64, glm::vec3(1.0f));
+    assert(!grid.hasPendingColors());
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestNearbySpansCoalesce()
+{
+    std::cout << "  Test: Nearby dirty spans merge into one upload" << std::endl;
+
+    Grid grid(64, 64, 1.0f, GridRenderMode::PER_VERTEX_COLOR);
+    renderCellCentres(grid);
+    // End of row 3 and start of row 4 are neighbours in the buffer
+    std::vector<GridCellColor> cells = {
+        {63, 3, glm::vec3(1.0f)},
+        {0, 4, glm::vec3(1.0f)},
+        {40, 60, glm::vec3(0.5f)}, // Far away: separate upload
+    };
+    grid.setCellColors(cells);
+    grid.flushColors();
+
+    assert(grid.getLastFlushUploads() == 2);
+    assert(grid.getLastFlushBytes() == 3 * 4 * sizeof(glm::vec3));
+    assert(glGetError() == GL_NO_ERROR);
+
+    // Texture rows only merge when they are adjacent and the rectangle stays tight
+    Grid textured(64, 64, 1.0f);
+    renderCellCentres(textured);
+    std::vector<GridCellColor> block = {
+        {5, 10, glm::vec3(1.0f)}, {6, 10, glm::vec3(1.0f)},
+        {5, 11, glm::vec3(1.0f)}, {6, 11, glm::vec3(1.0f)},
+        {40, 30, glm::vec3(1.0f)},
+    };
+    textured.setCellColors(block);
+    textured.flushColors();
+    assert(textured.getLastFlushUploads() == 2);
+    assert(textured.getLastFlushBytes() == 5 * 3);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestChunksFollowTheCamera()
+{
+    std::cout << "  Test: Only visible chunks are built, flushed and drawn" << std::endl;
+
+    Grid grid(1024, 1024, 1.0f);
+    assert(grid.getChunkCount() == 16 * 16);
+    assert(grid.getBuiltChunkCount() == 0);
+
+    // 64x64 world units around the origin straddle the corners of the middle 2x2 chunks
+    renderTopDown(grid, glm::vec2(0.0f), glm::vec2(32.0f), 64, 64);
+    assert(grid.getLastVisibleChunkCount() == 4);
+    assert(grid.getBuiltChunkCount() == 4);
+
+    // Highlights in view are uploaded; those in unbuilt chunks only touch the CPU copy
+    std::vector<GridCellColor> highlights;
+    for (int i = 0; i < 100; ++i) {
+        highlights.push_back(GridCellColor{480 + (i * 7) % 64, 480 + (i * 13) % 64, glm::vec3(1.0f, 1.0f, 0.0f)});
+        highlights.push_back(GridCellColor{(i * 37) % 256, (i * 101) % 256, glm::vec3(1.0f, 0.0f, 1.0f)});
+    }
+    auto start = std::chrono::steady_clock::now();
+    grid.setCellColors(highlights);
+    grid.flushColors();
+    glFinish();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Nowhere near a 3 MB texture, let alone a 96 MB vertex rebuild
+    assert(grid.getLastFlushUploads() <= 100);
+    assert(grid.getLastFlushBytes() <= 100 * (1 + 64) * 3);
+    assert(grid.getBuiltChunkCount() == 4);
+    std::cout << "    Flush: " << grid.getLastFlushUploads() << " uploads, " << grid.getLastFlushBytes()
+              << " bytes, " << ms << " ms" << std::endl;
+
+    // A chunk built later picks up colours set while it was culled: cell (0, 0) is magenta
+    std::vector<uint8_t> corner = renderTopDown(grid, glm::vec2(-511.5f, -511.5f), glm::vec2(0.5f), 4, 4);
+    assert(grid.getLastVisibleChunkCount() == 1);
+    assert(grid.getBuiltChunkCount() == 5);
+    assert(corner[0] == 255 && corner[1] == 0 && corner[2] == 255);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRenderModesMatch()
+{
+    std::cout << "  Test: Texture and per-vertex modes draw the same cells" << std::endl;
+
+    // Small chunks so both modes draw full and partial edge chunks
+    Grid vertexGrid(8, 6, 1.0f, GridRenderMode::PER_VERTEX_COLOR, 3);
+    Grid textureGrid(8, 6, 1.0f, GridRenderMode::COLOR_TEXTURE, 3);
+    Grid singleChunk(8, 6, 1.0f, GridRenderMode::COLOR_TEXTURE);
+    assert(vertexGrid.getChunkCount() == 3 * 2);
+    for (Grid* grid : { &vertexGrid, &textureGrid, &singleChunk }) {
+        grid->setCellColor(2, 5, glm::vec3(1.0f, 0.0f, 0.0f));
+        grid->setCellColor(7, 0, glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+
+    std::vector<uint8_t> fromVertices = renderCellCentres(vertexGrid);
+    std::vector<uint8_t> fromTexture = renderCellCentres(textureGrid);
+    assert(fromVertices == fromTexture);
+    assert(renderCellCentres(singleChunk) == fromTexture);
+
+    int red = 0, blue = 0, grey = 0;
+    for (size_t i = 0; i < fromTexture.size(); i += 3) {
+        const uint8_t* c = &fromTexture[i];
+        if (c[0] == 255 && c[1] == 0 && c[2] == 0) ++red;
+        else if (c[0] == 0 && c[1] == 0 && c[2] == 255) ++blue;
+        else if (c[0] == 51 && c[1] == 51 && c[2] == 51) ++grey;
+    }
+    assert(red == 1 && blue == 1 && grey == 8 * 6 - 2);
+
+    // Edits to chunks that already exist go through the dirty path and still match
+    for (Grid* grid : { &vertexGrid, &textureGrid }) {
+        grid->setCellColor(2, 3, glm::vec3(0.0f, 1.0f, 0.0f));
+        grid->setCellColor(3, 3, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    assert(renderCellCentres(vertexGrid) == renderCellCentres(textureGrid));
+    assert(!vertexGrid.hasPendingColors() && !textureGrid.hasPendingColors());
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running GridColor Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestSingleCellUploadsOnlyThatCell();
+    TestNearbySpansCoalesce();
+    TestChunksFollowTheCamera();
+    TestRenderModesMatch();
+
+    std::cout << "GridColor Tests Completed Successfully!" << std::endl;
+    return 0;
+}
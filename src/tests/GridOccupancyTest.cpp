@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "GridOccupancy.hpp"
+
+using namespace TurtleEngine;
+
+// GridOccupancy is plain CPU data, so no GL context is needed.
+
+void TestCellMapping()
+{
+    std::cout << "  Test: World positions map to the Grid's cells" << std::endl;
+    // Same layout as Grid(10, 6, 2.0f): X in [-10, 10), Z in [-6, 6)
+    GridOccupancy occupancy(10, 6, 2.0f);
+
+    assert(occupancy.worldToCell(glm::vec3(-10.0f, 0.0f, -6.0f)) == glm::ivec2(0, 0));
+    assert(occupancy.worldToCell(glm::vec3(0.5f, 3.0f, 0.5f)) == glm::ivec2(5, 3));
+    assert(occupancy.worldToCell(glm::vec3(9.99f, 0.0f, 5.99f)) == glm::ivec2(9, 5));
+    assert(occupancy.worldToCell(glm::vec3(100.0f, 0.0f, -100.0f)) == glm::ivec2(9, 0)); // Clamped
+    assert(occupancy.cellToWorld(5, 3) == glm::vec3(1.0f, 0.0f, 1.0f));
+    assert(occupancy.isInside(glm::vec3(-10.0f, 0.0f, 0.0f)) && !occupancy.isInside(glm::vec3(10.0f, 0.0f, 0.0f)));
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestInsertMoveRemove()
+{
+    std::cout << "  Test: Occupants follow insert, move and remove" << std::endl;
+    GridOccupancy occupancy(10, 10, 1.0f);
+    OccupantId a = occupancy.insert(glm::vec3(0.5f, 0.0f, 0.5f));
+    OccupantId b = occupancy.insert(glm::vec3(0.7f, 1.0f, 0.2f));
+    OccupantId c = occupancy.insert(glm::vec3(-4.5f, 0.0f, -4.5f));
+    assert(occupancy.getOccupantCount() == 3);
+    assert(occupancy.getCellCount(5, 5) == 2 && occupancy.getCellCount(0, 0) == 1);
+
+    occupancy.move(a, glm::vec3(0.6f, 0.0f, 0.6f)); // Same cell
+    occupancy.move(b, glm::vec3(-4.2f, 0.0f, -4.9f)); // Joins c
+    assert(occupancy.getCellCount(5, 5) == 1 && occupancy.getCellCount(0, 0) == 2);
+
+    std::vector<OccupantId> found;
+    assert(occupancy.queryCell(0, 0, found) == 2);
+    std::sort(found.begin(), found.end());
+    assert(found[0] == b && found[1] == c);
+
+    occupancy.remove(c);
+    assert(!occupancy.contains(c) && occupancy.getCellCount(0, 0) == 1);
+    OccupantId reused = occupancy.insert(glm::vec3(3.5f, 0.0f, 3.5f));
+    assert(reused == c && occupancy.getCellCount(8, 8) == 1);
+    assert(occupancy.getPosition(reused) == glm::vec3(3.5f, 0.0f, 3.5f));
+    assert(occupancy.getOccupantCount() == 3);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestQueriesMatchBruteForce()
+{
+    std::cout << "  Test: Radius and AABB queries match a brute-force scan" << std::endl;
+    GridOccupancy occupancy(64, 64, 1.0f);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(-36.0f, 36.0f); // Some start off the grid
+    std::uniform_real_distribution<float> extent(0.0f, 2.5f);
+
+    std::vector<HitboxAABB> boxes(500);
+    std::vector<OccupantId> ids;
+    for (HitboxAABB& box : boxes) {
+        box.center = glm::vec3(coordinate(rng), 1.0f, coordinate(rng));
+        box.halfExtents = glm::vec3(extent(rng), 1.0f, extent(rng));
+        ids.push_back(occupancy.insert(box));
+    }
+    // Move everything once so the linked lists get reshuffled
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        boxes[i].center += glm::vec3(coordinate(rng), 0.0f, coordinate(rng)) * 0.1f;
+        occupancy.move(ids[i], boxes[i]);
+    }
+
+    std::vector<OccupantId> found, expected;
+    for (int query = 0; query < 200; ++query) {
+        glm::vec3 centre(coordinate(rng), 0.0f, coordinate(rng));
+        float radius = extent(rng) * 2.0f;
+
+        found.clear();
+        expected.clear();
+        occupancy.queryRadius(centre, radius, found);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            glm::vec2 lo(boxes[i].center.x - boxes[i].halfExtents.x, boxes[i].center.z - boxes[i].halfExtents.z);
+            glm::vec2 hi(boxes[i].center.x + boxes[i].halfExtents.x, boxes[i].center.z + boxes[i].halfExtents.z);
+            glm::vec2 d = glm::vec2(centre.x, centre.z) - glm::clamp(glm::vec2(centre.x, centre.z), lo, hi);
+            if (glm::dot(d, d) <= radius * radius) expected.push_back(ids[i]);
+        }
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        assert(found == expected);
+
+        found.clear();
+        expected.clear();
+        glm::vec2 minXZ(centre.x - radius, centre.z - radius * 0.5f);
+        glm::vec2 maxXZ(centre.x + radius, centre.z + radius * 0.5f);
+        occupancy.queryAABB(minXZ, maxXZ, found);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            const HitboxAABB& b = boxes[i];
+            if (b.center.x + b.halfExtents.x >= minXZ.x && b.center.x - b.halfExtents.x <= maxXZ.x &&
+                b.center.z + b.halfExtents.z >= minXZ.y && b.center.z - b.halfExtents.z <= maxXZ.y) {
+                expected.push_back(ids[i]);
+            }
+        }
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        assert(found == expected);
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running GridOccupancy Tests..." << std::endl;
+    TestCellMapping();
+    TestInsertMoveRemove();
+    TestQueriesMatchBruteForce();
+    std::cout << "GridOccupancy Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLTestContext.hpp"
+#include "Grid.hpp"
+#include "GridOverlay.hpp"
+#include "JobSystem.hpp"
+
+using namespace TurtleEngine;
+
+// Double-buffered telemetry overlay drawn over a Grid. Needs a GL context; CI runs it
+// on Mesa llvmpipe.
+
+namespace {
+    constexpr int CELLS = 16;
+    constexpr int CELL_PIXELS = 4;
+
+    // Draws grid and overlay top-down, 4 pixels per cell, and returns the RGB of every cell centre
+    std::vector<uint8_t> renderCellCentres(Grid& grid, GridOverlay& overlay) {
+        const int size = CELLS * CELL_PIXELS;
+        GLuint fbo = 0, colorBuffer = 0;
+        glGenFramebuffers(1, &fbo);
+        glGenRenderbuffers(1, &colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size, size);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+        assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+        glViewport(0, 0, size, size);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        const float half = CELLS * 0.5f;
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+        glm::mat4 projection = glm::ortho(-half, half, -half, half, 0.1f, 100.0f);
+        grid.render(projection, view);
+        // The overlay must hand back the blend and depth state it found
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        glDepthMask(GL_FALSE);
+        overlay.render(projection, view);
+        GLint blendSource = 0;
+        glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource);
+        GLboolean depthMask = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+        assert(glIsEnabled(GL_BLEND) && blendSource == GL_ONE && depthMask == GL_FALSE);
+        glDisable(GL_BLEND);
+        glDepthMask(GL_TRUE);
+
+        std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 4);
+        glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        std::vector<uint8_t> centres;
+        for (int y = 0; y < CELLS; ++y) {
+            for (int x = 0; x < CELLS; ++x) {
+                const uint8_t* p = &pixels[((y * CELL_PIXELS + CELL_PIXELS / 2) * size + x * CELL_PIXELS + CELL_PIXELS / 2) * 4];
+                centres.insert(centres.end(), p, p + 3);
+            }
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteFramebuffers(1, &fbo);
+        return centres;
+    }
+
+    bool near(int a, int b) { return std::abs(a - b) <= 2; }
+}
+
+void TestValuesAppearOnlyAfterSwap()
+{
+    std::cout << "  Test: Writes from worker threads show up after swap()" << std::endl;
+    Grid grid(CELLS, CELLS, 1.0f);
+    GridOverlay overlay(grid);
+    overlay.setRange(0.0f, static_cast<float>(CELLS - 1));
+
+    // One row per job: writers own disjoint cells
+    float* values = overlay.getWriteBuffer();
+    JobSystem::shared().parallelFor(CELLS, 1, [values](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            for (int x = 0; x < CELLS; ++x) values[y * CELLS + x] = static_cast<float>(x);
+        }
+    });
+
+    // Not published yet: only the grey grid shows through the transparent zero end
+    std::vector<uint8_t> before = renderCellCentres(grid, overlay);
+    assert(overlay.getLastUploadBytes() == 0);
+    assert(before[0] == 51 && before[(CELLS - 1) * 3] == 51);
+
+    overlay.swap();
+    assert(overlay.getValue(CELLS - 1, 3) == static_cast<float>(CELLS - 1));
+    std::vector<uint8_t> after = renderCellCentres(grid, overlay);
+    assert(overlay.getLastUploadBytes() == CELLS * CELLS * sizeof(float));
+
+    // Column 0 is the transparent end, the last column the 90% red end over grey
+    const uint8_t* cold = &after[(5 * CELLS + 0) * 3];
+    const uint8_t* hot = &after[(5 * CELLS + CELLS - 1) * 3];
+    assert(cold[0] == 51 && cold[1] == 51 && cold[2] == 51);
+    assert(near(hot[0], static_cast<int>(0.9f * 255 + 0.1f * 51)) && near(hot[1], 5) && near(hot[2], 5));
+    // Warmer columns get redder
+    for (int x = CELLS / 2 + 1; x < CELLS; ++x) {
+        assert(after[(5 * CELLS + x) * 3] >= after[(5 * CELLS + x - 1) * 3]);
+    }
+
+    // Nothing new swapped in: nothing uploaded, and the back buffer does not leak through
+    overlay.clearWriteBuffer();
+    overlay.setValue(0, 0, 1000.0f);
+    std::vector<uint8_t> again = renderCellCentres(grid, overlay);
+    assert(overlay.getLastUploadBytes() == 0);
+    assert(again == after);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestCustomPaletteAndVisibility()
+{
+    std::cout << "  Test: Custom palette and hiding the overlay" << std::endl;
+    Grid grid(CELLS, CELLS, 1.0f);
+    GridOverlay overlay(grid);
+    overlay.setPalette({ { 0.0f, glm::vec4(0.0f) }, { 1.0f, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f) } });
+    overlay.setRange(0.0f, 1.0f);
+    overlay.clearWriteBuffer(5.0f); // Above the range: clamps to the opaque end
+    overlay.swap();
+
+    std::vector<uint8_t> shown = renderCellCentres(grid, overlay);
+    assert(shown[0] == 0 && shown[1] == 0 && shown[2] == 255);
+
+    overlay.setVisible(false);
+    std::vector<uint8_t> hidden = renderCellCentres(grid, overlay);
+    assert(hidden[0] == 51 && hidden[2] == 51);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running GridOverlay Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestValuesAppearOnlyAfterSwap();
+    TestCustomPaletteAndVisibility();
+
+    std::cout << "GridOverlay Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "GLTestContext.hpp"
+#include "RenderTarget.hpp"
+#include "Renderer.hpp"
+
+using namespace TurtleEngine;
+
+// Rendering with no window: a surfaceless EGL context and an offscreen target.
+// Needs EGL (Mesa llvmpipe in CI) but no display server.
+
+namespace {
+    constexpr int SIZE = 64;
+
+    // Centre pixel of the target
+    void centrePixel(const RenderTarget& target, unsigned char* rgba) {
+        std::vector<uint8_t> pixels;
+        target.readPixels(pixels);
+        const size_t offset = (static_cast<size_t>(SIZE / 2) * SIZE + SIZE / 2) * 4;
+        for (int i = 0; i < 4; ++i) rgba[i] = pixels[offset + i];
+    }
+
+    void drawScene(Renderer& renderer, const glm::vec4& color) {
+        renderer.clear();
+        renderer.useShader(renderer.getDefaultShader());
+        renderer.drawRectangle(glm::vec2(0.0f), 0.0f, glm::vec2(1.0f), color);
+    }
+}
+
+void TestContextWithoutWindow(const HeadlessContext& context)
+{
+    std::cout << "  Test: A core context comes up with no window" << std::endl;
+    assert(context.isValid());
+    std::cout << "    (" << context.getBackend() << ", " << glGetString(GL_RENDERER) << ")" << std::endl;
+    GLint major = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    assert(major >= 4);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRendererDrawsIntoTarget()
+{
+    std::cout << "  Test: Renderer draws into the offscreen target" << std::endl;
+    RenderTarget target;
+    const bool created = target.initialize(SIZE, SIZE);
+    assert(created);
+    Renderer renderer;
+    renderer.init();
+    renderer.setRenderTarget(&target);
+    renderer.setClearColor(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+    renderer.setViewMatrix(glm::mat4(1.0f));
+    renderer.setProjectionMatrix(glm::mat4(1.0f));
+
+    drawScene(renderer, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    unsigned char pixel[4];
+    centrePixel(target, pixel);
+    assert(pixel[0] == 255 && pixel[1] == 0 && pixel[2] == 0);
+
+    // Shadow passes bind their own framebuffer and must hand the target back
+    renderer.addLight(Light(glm::vec3(0.0f, 5.0f, 5.0f), glm::vec3(1.0f)));
+    renderer.renderShadowMaps();
+    GLint bound = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &bound);
+    assert(static_cast<GLuint>(bound) == target.getFramebuffer());
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    assert(viewport[2] == SIZE && viewport[3] == SIZE);
+
+    renderer.setRenderTarget(nullptr);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &bound);
+    assert(bound == 0);
+    renderer.cleanup();
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestImageHash()
+{
+    std::cout << "  Test: Identical frames hash the same, different ones do not" << std::endl;
+    RenderTarget target;
+    const bool created = target.initialize(SIZE, SIZE);
+    assert(created);
+    Renderer renderer;
+    renderer.init();
+    renderer.setRenderTarget(&target);
+    renderer.setViewMatrix(glm::mat4(1.0f));
+    renderer.setProjectionMatrix(glm::mat4(1.0f));
+
+    drawScene(renderer, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    const uint64_t first = target.hashPixels();
+    drawScene(renderer, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    assert(target.hashPixels() == first);
+    drawScene(renderer, glm::vec4(0.0f, 1.0f, 0.5f, 1.0f));
+    assert(target.hashPixels() != first);
+
+    const std::string path = "headless_render_test.ppm";
+    const bool written = target.writePPM(path);
+    assert(written);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    const std::string header = "P6\n64 64\n255\n";
+    assert(static_cast<size_t>(file.tellg()) == header.size() + SIZE * SIZE * 3);
+    file.close();
+    std::remove(path.c_str());
+    renderer.cleanup();
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running HeadlessRender Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestContextWithoutWindow(context.get());
+    TestRendererDrawsIntoTarget();
+    TestImageHash();
+
+    std::cout << "HeadlessRender Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include <cassert>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLTestContext.hpp"
+#include "LightClusters.hpp"
+#include "UniformBuffer.hpp"
+#include "JobSystem.hpp"
+#include "Renderer.hpp"
+#include "Shader.hpp"
+
+using namespace TurtleEngine;
+
+// Froxel light binning on the CPU and clustered shading in lighting.frag. Needs a
+// GL context; CI runs it on Mesa llvmpipe.
+
+namespace {
+    const float FOV = glm::radians(60.0f);
+    const float ASPECT = 16.0f / 9.0f;
+
+    glm::mat4 testView() {
+        return glm::lookAt(glm::vec3(0.0f, 2.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    glm::mat4 testProjection() {
+        return glm::perspective(FOV, ASPECT, 0.1f, 60.0f);
+    }
+
+    std::vector<LightData> randomLights(size_t count, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> x(-12.0f, 12.0f), y(-3.0f, 5.0f), z(-30.0f, 8.0f), radius(0.5f, 3.0f);
+        std::vector<LightData> lights(count);
+        for (LightData& light : lights) {
+            light.positionRadius = glm::vec4(x(rng), y(rng), z(rng), radius(rng));
+            light.colorIntensity = glm::vec4(1.0f);
+        }
+        return lights;
+    }
+
+    bool contains(const LightClusters& clusters, size_t cluster, uint32_t light) {
+        size_t count = 0;
+        const uint32_t* lights = clusters.getClusterLights(cluster, count);
+        for (size_t i = 0; i < count; ++i) {
+            if (lights[i] == light) return true;
+        }
+        return false;
+    }
+}
+
+void TestEveryLitPointFindsItsLights()
+{
+    std::cout << "  Test: A point's froxel lists every light that reaches it" << std::endl;
+    const std::vector<LightData> lights = randomLights(500, 7);
+    const glm::mat4 view = testView();
+    LightClusters clusters;
+    clusters.build(view, testProjection(), lights.data(), lights.size(), nullptr);
+    assert(clusters.getStats().lights == 500);
+    assert(clusters.getStats().visibleLights > 50 && clusters.getStats().visibleLights < 500);
+
+    // Sample points through the frustum, in view space then world space
+    const glm::mat4 inverseView = glm::inverse(view);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> ndc(-0.999f, 0.999f), depth(0.2f, 40.0f);
+    const float tanHalf = std::tan(FOV * 0.5f);
+    size_t checked = 0;
+    for (int sample = 0; sample < 4000; ++sample) {
+        const float nx = ndc(rng), ny = ndc(rng), d = depth(rng);
+        const glm::vec3 world(inverseView * glm::vec4(nx * d * tanHalf * ASPECT, ny * d * tanHalf, -d, 1.0f));
+        const int x = static_cast<int>((nx * 0.5f + 0.5f) * LightClusters::GRID_X);
+        const int y = static_cast<int>((ny * 0.5f + 0.5f) * LightClusters::GRID_Y);
+        const size_t cluster = LightClusters::clusterIndex(x, y, clusters.sliceOf(d));
+        for (size_t i = 0; i < lights.size(); ++i) {
+            if (glm::length(world - glm::vec3(lights[i].positionRadius)) < lights[i].positionRadius.w) {
+                assert(contains(clusters, cluster, static_cast<uint32_t>(i)));
+                ++checked;
+            }
+        }
+    }
+    assert(checked > 100);
+
+    // Froxels hold a small share of the lights
+    const double perCluster = static_cast<double>(clusters.getStats().references) / LightClusters::CLUSTER_COUNT;
+    assert(perCluster < 0.05 * clusters.getStats().visibleLights);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestParallelBinningMatchesSerial()
+{
+    std::cout << "  Test: Binning on the job system matches a single thread" << std::endl;
+    const std::vector<LightData> lights = randomLights(LightClusters::MAX_LIGHTS, 3);
+    JobSystem jobs(4);
+    LightClusters serial, parallel;
+    serial.build(testView(), testProjection(), lights.data(), lights.size(), nullptr);
+    parallel.build(testView(), testProjection(), lights.data(), lights.size(), &jobs);
+    assert(parallel.getStats().visibleLights >= LightClusters::PARALLEL_THRESHOLD);
+    assert(serial.getStats().references == parallel.getStats().references);
+    for (size_t c = 0; c < LightClusters::CLUSTER_COUNT; ++c) {
+        size_t a = 0, b = 0;
+        const uint32_t* listA = serial.getClusterLights(c, a);
+        const uint32_t* listB = parallel.getClusterLights(c, b);
+        assert(a == b);
+        for (size_t i = 0; i < a; ++i) assert(listA[i] == listB[i]);
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestLightsOutsideTheFrustumAreDropped()
+{
+    std::cout << "  Test: Lights behind the camera are never binned" << std::endl;
+    std::vector<LightData> lights(3);
+    lights[0].positionRadius = glm::vec4(0.0f, 2.0f, 20.0f, 2.0f);   // Behind
+    lights[1].positionRadius = glm::vec4(200.0f, 0.0f, 0.0f, 5.0f);  // Far off to the side
+    lights[2].positionRadius = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);    // In view
+    LightClusters clusters;
+    clusters.build(testView(), testProjection(), lights.data(), lights.size(), nullptr);
+    assert(clusters.getStats().visibleLights == 1);
+    for (size_t c = 0; c < LightClusters::CLUSTER_COUNT; ++c) {
+        assert(!contains(clusters, c, 0) && !contains(clusters, c, 1));
+    }
+    assert(clusters.getStats().references > 0);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestLightingShadesClusteredLights()
+{
+    std::cout << "  Test: lighting.frag shades lights beyond the shadowed eight" << std::endl;
+    const int size = 64;
+    Renderer renderer;
+    renderer.init();
+    FrameUniforms& frame = FrameUniforms::shared();
+
+    // 39 dim blue lights in one corner and a red one, well past index 8, in another
+    for (int i = 0; i < 40; ++i) {
+        if (i == 30) {
+            renderer.addLight(Light(glm::vec3(2.0f, 0.5f, 2.0f), glm::vec3(1.0f, 0.0f, 0.0f), 3.0f, 1.2f));
+        } else {
+            renderer.addLight(Light(glm::vec3(-3.0f + (i % 5) * 0.5f, 0.2f, -3.0f + (i / 5) * 0.3f), glm::vec3(0.0f, 0.0f, 1.0f), 0.5f, 1.0f));
+        }
+    }
+    assert(renderer.getLights().size() == 40);
+
+    // Forty light changes, one cluster build
+    const size_t builds = frame.getClusterBuilds();
+    frame.setCamera(glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f)),
+                    glm::ortho(-4.0f, 4.0f, -4.0f, 4.0f, 0.1f, 20.0f));
+    assert(frame.getClusterBuilds() == builds + 1);
+    assert(frame.getClusters().getStats().visibleLights == 40);
+    assert(frame.getClusters().getStats().maxPerCluster < 40);
+
+    float vertices[] = {
+        -4.0f, 0.0f, -4.0f, 0.0f, 1.0f, 0.0f,   4.0f, 0.0f, -4.0f, 0.0f, 1.0f, 0.0f,   4.0f, 0.0f, 4.0f, 0.0f, 1.0f, 0.0f,
+        -4.0f, 0.0f, -4.0f, 0.0f, 1.0f, 0.0f,   4.0f, 0.0f, 4.0f, 0.0f, 1.0f, 0.0f,   -4.0f, 0.0f, 4.0f, 0.0f, 1.0f, 0.0f,
+    };
+    GLuint vao = 0, vbo = 0;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    GLuint color = 0, fbo = 0;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size, size);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    glViewport(0, 0, size, size);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    Shader lighting;
+    const bool loaded = lighting.loadFromFiles("shaders/lighting.vert", "shaders/lighting.frag");
+    assert(loaded);
+    lighting.use();
+    lighting.setMat4("model", glm::mat4(1.0f));
+    lighting.getUniform<glm::vec4>("color").set(glm::vec4(1.0f));
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    // Screen x is world x, screen up is world -z
+    auto pixelAt = [&](float x, float z) {
+        uint8_t pixel[4];
+        glReadPixels(static_cast<int>((x + 4.0f) / 8.0f * size), static_cast<int>((4.0f - z) / 8.0f * size), 1, 1,
+                     GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        return glm::ivec3(pixel[0], pixel[1], pixel[2]);
+    };
+    const glm::ivec3 red = pixelAt(2.0f, 2.0f);
+    const glm::ivec3 blue = pixelAt(-2.0f, -2.0f);
+    const glm::ivec3 dark = pixelAt(2.0f, -2.5f);
+    assert(red.x > red.z + 50);
+    assert(blue.z > blue.x + 20);
+    assert(std::abs(dark.x - 77) <= 2 && dark.x == dark.z); // Ambient only
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    renderer.clearLights();
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running LightCluster Tests..." << std::endl;
+
+    TestEveryLitPointFindsItsLights();
+    TestParallelBinningMatchesSerial();
+    TestLightsOutsideTheFrustumAreDropped();
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestLightingShadesClusteredLights();
+
+    std::cout << "LightCluster Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "ParticleSimulation.hpp"
+
+using namespace TurtleEngine;
+
+// Exercises the GL-free ParticleSimulation core, so no GL context is needed.
+
+namespace {
+    Particle makeParticle(const glm::vec3& position) {
+        return Particle(position, glm::vec3(0.0f), glm::vec4(1.0f), 5.0f, 5.0f);
+    }
+}
+
+void TestLowestPriorityThrottledFirst()
+{
+    std::cout << "  Test: Lowest priority is throttled first" << std::endl;
+    ParticleBudgetManager budget;
+    ParticleBudgetSettings settings;
+    settings.frameBudgetMs = 2.0f;
+    settings.pressureThreshold = 0.8f;
+    settings.costSmoothing = 1.0f; // React to each sample immediately
+    settings.minSpawnScale = 0.0f;
+    budget.setSettings(settings);
+
+    // Under the threshold nothing is touched
+    budget.reportCost(1.0f, 0.4f);
+    for (int level = 0; level < PARTICLE_PRIORITY_LEVELS; ++level) {
+        assert(budget.getSpawnScale(level) == 1.0f);
+    }
+
+    // Part way between threshold and budget: tier 0 is cut fully, tier 1 halfway, the rest untouched
+    budget.reportCost(1.15f, 0.6f);
+    assert(budget.getSpawnScale(0) < 1e-5f);
+    assert(budget.getSpawnScale(1) > 0.4f && budget.getSpawnScale(1) < 0.6f);
+    assert(budget.getSpawnScale(2) == 1.0f);
+    assert(budget.getSpawnScale(3) == 1.0f);
+
+    // Out-of-range priorities clamp to the nearest tier
+    assert(budget.getSpawnScale(-5) == budget.getSpawnScale(0));
+    assert(budget.getSpawnScale(99) == budget.getSpawnScale(PARTICLE_PRIORITY_LEVELS - 1));
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestThrottledEmitterCounters()
+{
+    std::cout << "  Test: Throttled spawns are counted and enlarge points" << std::endl;
+    ParticleEmitterDesc desc;
+    desc.rate = 1000.0f;
+    desc.maxParticles = 10000;
+    ParticleEmitter emitter(desc, 42);
+
+    // A quarter of the requested rate gets through
+    size_t spawned = emitter.accumulate(0.1f, 0.25f);
+    assert(spawned == 25);
+    assert(emitter.getLastRequested() == 100);
+    assert(emitter.getLastSuppressed() == 75);
+
+    ParticleBudgetManager budget;
+    budget.beginFrame();
+    budget.recordSpawns(emitter.getLastRequested(), emitter.getLastSuppressed());
+    budget.endFrame();
+    // 25% kept -> points twice as large to cover the same area
+    assert(std::fabs(budget.getPointSizeScale() - 2.0f) < 1e-4f);
+    assert(budget.getCounters().spawnsSuppressed == 75);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestDistanceCulling()
+{
+    std::cout << "  Test: Particles beyond the cull distance are removed" << std::endl;
+    ParticleSimulation system(100);
+    ParticleBudgetSettings settings;
+    settings.cullDistance = 10.0f;
+    settings.frustumCulling = false;
+    settings.pressureThreshold = 0.0f; // Always under pressure
+    system.getBudgetManager().setSettings(settings);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    system.setCamera(view, projection, glm::vec3(0.0f));
+
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.0f, -5.0f)));
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.0f, -50.0f)));
+    system.update(0.016f);
+
+    assert(system.getActiveParticleCount() == 1);
+    assert(system.getFreeParticleCount() == 99 && "Culled particle not recycled");
+    assert(system.getBudgetCounters().culledByDistance == 1);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestFrustumCulling()
+{
+    std::cout << "  Test: Off-screen particles simulate but are not uploaded" << std::endl;
+    ParticleSimulation system(100);
+    ParticleBudgetSettings settings;
+    settings.cullDistance = 0.0f;
+    settings.pressureThreshold = 0.0f; // Always under pressure
+    system.getBudgetManager().setSettings(settings);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    system.setCamera(view, projection, glm::vec3(0.0f));
+
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.0f, -5.0f)));
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.0f, 5.0f))); // Behind the camera
+    system.update(0.016f);
+
+    assert(system.getActiveParticleCount() == 2 && "Frustum culling must not kill particles");
+    assert(system.getBudgetCounters().culledByFrustum == 1);
+    assert(system.getBudgetCounters().culledByDistance == 0);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestNoCullingWithinBudget()
+{
+    std::cout << "  Test: Nothing is culled while under the pressure threshold" << std::endl;
+    ParticleSimulation system(100);
+    ParticleBudgetSettings settings;
+    settings.cullDistance = 10.0f;
+    settings.frameBudgetMs = 1000.0f; // Far more than an update costs
+    system.getBudgetManager().setSettings(settings);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    system.setCamera(view, projection, glm::vec3(0.0f));
+
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.0f, -50.0f))); // Past the cull distance
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.0f, 5.0f)));   // Behind the camera
+    system.update(0.016f);
+    system.update(0.016f);
+
+    assert(!system.getBudgetManager().isCulling());
+    assert(system.getActiveParticleCount() == 2);
+    assert(system.getActiveCullDistance() == 0.0f);
+    assert(system.getBudgetCounters().culledByDistance == 0);
+    assert(system.getBudgetCounters().culledByFrustum == 0);
+    assert(system.getRenderView().count == 2);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestFrustumAABB()
+{
+    std::cout << "  Test: Frustum AABB intersection" << std::endl;
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    Frustum frustum = Frustum::fromMatrix(projection * view);
+
+    assert(frustum.intersectsAABB(glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f)));
+    assert(!frustum.intersectsAABB(glm::vec3(-1.0f, -1.0f, 9.0f), glm::vec3(1.0f, 1.0f, 11.0f)));
+    assert(!frustum.intersectsAABB(glm::vec3(-1.0f, -1.0f, -300.0f), glm::vec3(1.0f, 1.0f, -200.0f)));
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ParticleBudget Tests..." << std::endl;
+    TestLowestPriorityThrottledFirst();
+    TestThrottledEmitterCounters();
+    TestDistanceCulling();
+    TestFrustumCulling();
+    TestNoCullingWithinBudget();
+    TestFrustumAABB();
+    std::cout << "ParticleBudget Tests Completed Successfully!" << std::endl;
+    return 0;
+}
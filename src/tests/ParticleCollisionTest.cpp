@@ -0,0 +1,155 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ParticleSimulation.hpp"
+#include "JobSystem.hpp"
+
+using namespace TurtleEngine;
+
+// Exercises the GL-free ParticleSimulation core, so no GL context is needed.
+
+namespace {
+    Particle makeParticle(const glm::vec3& position, const glm::vec3& velocity) {
+        return Particle(position, velocity, glm::vec4(1.0f), 5.0f, 5.0f);
+    }
+}
+
+void TestGroundBounce()
+{
+    std::cout << "  Test: Particles bounce off the ground plane" << std::endl;
+    ParticleSimulation system(16);
+    system.setCollisionEnabled(true);
+    system.getCollider().setGroundPlane(0.0f, glm::vec2(-10.0f), glm::vec2(10.0f));
+
+    system.spawnParticle(makeParticle(glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(0.0f, -10.0f, 0.0f)));
+    system.spawnParticle(makeParticle(glm::vec3(50.0f, 0.5f, 0.0f), glm::vec3(0.0f, -10.0f, 0.0f))); // Off the grid
+    system.update(0.1f);
+
+    assert(system.getHitEvents().size() == 1);
+    const ParticleHitEvent& hit = system.getHitEvents()[0];
+    assert(hit.hitbox == -1 && hit.normal.y == 1.0f);
+    assert(std::fabs(hit.position.y) < 1e-5f && std::fabs(hit.speed - 10.0f) < 1e-4f);
+
+    const Particle& bounced = system.getParticles()[hit.particle];
+    assert(bounced.velocity.y > 0.0f && bounced.position.y >= 0.0f);
+    assert(system.getParticles()[1].position.y < 0.0f && "Particle off the grid should fall through");
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestEmitterResponses()
+{
+    std::cout << "  Test: Stick and die responses, batched callback" << std::endl;
+    ParticleSimulation system(2000);
+    system.setCollisionEnabled(true);
+    HitboxAABB box{glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(2.0f, 0.5f, 2.0f)};
+    system.getCollider().setHitboxes(&box, 1);
+
+    // Upward cone straight into the underside of the box
+    ParticleEmitterDesc desc;
+    desc.shape = EmitterShape::CONE;
+    desc.coneAngle = 0.05f;
+    desc.rate = 0.0f;
+    desc.speedMin = desc.speedMax = 20.0f;
+    desc.lifetimeMin = desc.lifetimeMax = 3.0f;
+    desc.collision = ParticleCollisionResponse::DIE;
+    EmitterHandle dying = system.addEmitter(desc);
+    desc.collision = ParticleCollisionResponse::STICK;
+    EmitterHandle sticky = system.addEmitter(desc);
+
+    size_t callbackCalls = 0, callbackHits = 0;
+    system.setHitCallback([&](const std::vector<ParticleHitEvent>& hits) {
+        ++callbackCalls;
+        callbackHits += hits.size();
+    });
+
+    system.emitBurst(dying, 100);
+    system.emitBurst(sticky, 100);
+    for (int frame = 0; frame < 30; ++frame) system.update(1.0f / 60.0f);
+
+    assert(callbackHits == 200 && "Every particle should hit the box exactly once");
+    assert(callbackCalls >= 1 && callbackCalls < 30);
+    assert(system.getEmitter(dying)->getLiveCount() == 0 && "DIE particles must be recycled");
+    assert(system.getEmitter(sticky)->getLiveCount() == 100);
+    assert(system.getActiveParticleCount() == 100);
+
+    for (const Particle& p : system.getParticles()) {
+        if (p.life > 0.0f) {
+            assert(p.velocity == glm::vec3(0.0f));
+            assert(std::fabs(p.position.y - 4.5f) < 1e-3f && "Stuck particle not on the box face");
+        }
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestHashMatchesBruteForce()
+{
+    std::cout << "  Test: Spatial hash finds the same entries as brute force" << std::endl;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coord(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> size(0.2f, 3.0f);
+    std::uniform_real_distribution<float> step(-1.5f, 1.5f);
+
+    std::vector<HitboxAABB> boxes(300);
+    for (HitboxAABB& box : boxes) {
+        box.center = glm::vec3(coord(rng), coord(rng) * 0.25f, coord(rng));
+        box.halfExtents = glm::vec3(size(rng), size(rng), size(rng));
+    }
+
+    std::vector<Particle> particles(50000);
+    ParticlePositionStream stream;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        Particle& p = particles[i];
+        p.previousPosition = glm::vec3(coord(rng), coord(rng) * 0.25f, coord(rng));
+        p.position = p.previousPosition + glm::vec3(step(rng), step(rng), step(rng));
+        p.velocity = p.position - p.previousPosition;
+        p.life = 1.0f;
+        stream.push(static_cast<uint32_t>(i), p.position, p.previousPosition);
+    }
+
+    auto inside = [](const glm::vec3& point, const HitboxAABB& box) {
+        glm::vec3 d = glm::abs(point - box.center);
+        return d.x < box.halfExtents.x && d.y < box.halfExtents.y && d.z < box.halfExtents.z;
+    };
+    std::set<uint32_t> expected;
+    for (uint32_t slot : stream.slots) {
+        for (const HitboxAABB& box : boxes) {
+            if (inside(particles[slot].position, box) && !inside(particles[slot].previousPosition, box)) {
+                expected.insert(slot);
+                break;
+            }
+        }
+    }
+
+    ParticleCollider collider;
+    ParticleCollisionSettings settings;
+    settings.looseResponse = ParticleCollisionResponse::STICK;
+    collider.setSettings(settings);
+    collider.setHitboxes(boxes.data(), boxes.size());
+
+    JobSystem jobs(3);
+    std::vector<ParticleHitEvent> events;
+    collider.collide(particles, stream, nullptr, 0, events, &jobs);
+
+    std::set<uint32_t> found;
+    for (size_t i = 0; i < events.size(); ++i) {
+        found.insert(events[i].particle);
+        if (i > 0) assert(events[i - 1].particle < events[i].particle && "Events out of slot order");
+    }
+    assert(!expected.empty());
+    assert(found == expected);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ParticleCollision Tests..." << std::endl;
+    TestGroundBounce();
+    TestEmitterResponses();
+    TestHashMatchesBruteForce();
+    std::cout << "ParticleCollision Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ParticleSimulation.hpp"
+
+using namespace TurtleEngine;
+
+// Exercises the GL-free ParticleSimulation core, so no GL context is needed.
+
+void TestRandomRange()
+{
+    std::cout << "  Test: Xoshiro128x4 output range" << std::endl;
+    Xoshiro128x4 rng(1234);
+    std::vector<float> values(10003);
+    rng.fillUniform(values.data(), values.size());
+    double sum = 0.0;
+    for (float v : values) {
+        assert(v >= 0.0f && v < 1.0f && "Uniform outside [0, 1)");
+        sum += v;
+    }
+    double mean = sum / values.size();
+    assert(std::fabs(mean - 0.5) < 0.02 && "Uniform mean far from 0.5");
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestEmitterRateAndBudget()
+{
+    std::cout << "  Test: Emitter rate and pool budget" << std::endl;
+    ParticleSimulation system(10000);
+
+    ParticleEmitterDesc desc;
+    desc.rate = 1000.0f;
+    desc.lifetimeMin = 10.0f;
+    desc.lifetimeMax = 10.0f;
+    desc.maxParticles = 250;
+    EmitterHandle handle = system.addEmitter(desc);
+    assert(handle != INVALID_EMITTER);
+
+    // 0.1s at 1000/s -> 100 particles
+    system.update(0.1f);
+    assert(system.getActiveParticleCount() == 100 && "Rate not respected");
+
+    // Another 0.5s would give 600 total, but the budget caps it at 250
+    system.update(0.5f);
+    assert(system.getActiveParticleCount() == 250 && "Budget not respected");
+    assert(system.getEmitter(handle)->getLiveCount() == 250);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestBurstsAndRecycling()
+{
+    std::cout << "  Test: Bursts return slots to the pool" << std::endl;
+    ParticleSimulation system(500);
+
+    ParticleEmitterDesc desc;
+    desc.shape = EmitterShape::CONE;
+    desc.rate = 0.0f;
+    desc.lifetimeMin = 0.5f;
+    desc.lifetimeMax = 0.5f;
+    desc.maxParticles = 400;
+    EmitterHandle handle = system.addEmitter(desc);
+
+    system.emitBurst(handle, 300);
+    system.spawnBurst(100, glm::vec3(0.0f), 2.0f, 0.5f, glm::vec4(1.0f));
+    system.update(0.1f);
+    assert(system.getActiveParticleCount() == 400);
+    assert(system.getFreeParticleCount() == 100);
+
+    // Everything has died after its lifetime, including the loose burst
+    system.update(1.0f);
+    assert(system.getActiveParticleCount() == 0);
+    assert(system.getFreeParticleCount() == 500 && "Dead particles not recycled");
+    assert(system.getEmitter(handle)->getLiveCount() == 0);
+
+    // Retired emitters free their slot for reuse
+    system.removeEmitter(handle);
+    assert(system.getEmitter(handle) == nullptr);
+    const EmitterHandle reused = system.addEmitter(desc);
+    assert(reused == handle);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestExternalSpawnsClampedToPool()
+{
+    std::cout << "  Test: External integration never stages more than the pool holds" << std::endl;
+    ParticleSimulation system(100);
+    size_t staged = 0;
+    system.setExternalIntegration([&](const std::vector<ParticleSpawnRecord>& spawns, float) { staged += spawns.size(); });
+
+    ParticleEmitterDesc desc;
+    desc.rate = 0.0f;
+    desc.lifetimeMin = 1.0f;
+    desc.lifetimeMax = 1.0f;
+    desc.maxParticles = 1000;
+    EmitterHandle handle = system.addEmitter(desc);
+
+    // 150 requested, 100 fit; the rest are reported and not charged to the emitter
+    system.emitBurst(handle, 150);
+    system.update(0.1f);
+    assert(staged == 100);
+    assert(system.getBudgetCounters().spawnsDropped == 50);
+    assert(system.getEmitter(handle)->getLiveCount() == 100);
+
+    // Full until the batch's lifetime has passed
+    Particle loose;
+    loose.initialLife = 1.0f;
+    system.spawnParticle(loose);
+    assert(system.getBudgetCounters().spawnsDropped == 51);
+    system.update(0.1f);
+    assert(staged == 100);
+
+    system.update(1.0f);
+    assert(system.getEmitter(handle)->getLiveCount() == 0);
+    system.emitBurst(handle, 80);
+    system.update(0.1f);
+    assert(staged == 180);
+    assert(system.getBudgetCounters().spawnsDropped == 0);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestColorCurve()
+{
+    std::cout << "  Test: Colour-over-life curve" << std::endl;
+    ParticleCurve<glm::vec4> curve(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 1.0f, 0.0f));
+    glm::vec4 mid = curve.evaluate(0.5f);
+    assert(std::fabs(mid.r - 0.5f) < 1e-5f && std::fabs(mid.b - 0.5f) < 1e-5f);
+    assert(curve.evaluate(2.0f).a == 0.0f && "Curve not clamped at end");
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ParticleEmitter Tests..." << std::endl;
+    TestRandomRange();
+    TestEmitterRateAndBudget();
+    TestBurstsAndRecycling();
+    TestExternalSpawnsClampedToPool();
+    TestColorCurve();
+    std::cout << "ParticleEmitter Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <cassert>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "ParticleSimulation.hpp"
+#include "JobSystem.hpp"
+
+using namespace TurtleEngine;
+
+// Exercises the GL-free ParticleSimulation core, so no GL context is needed.
+
+namespace {
+    void checkMatchesStableSort(const std::vector<uint32_t>& keys, JobSystem* jobs) {
+        std::vector<uint32_t> expected(keys.size());
+        std::iota(expected.begin(), expected.end(), 0u);
+        std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+        RadixSorter sorter;
+        std::vector<uint32_t> order;
+        sorter.sort(keys.data(), keys.size(), order, jobs);
+        assert(order == expected && "Radix sort differs from std::stable_sort");
+    }
+}
+
+void TestSortableFloatKeys()
+{
+    std::cout << "  Test: Float keys keep float order" << std::endl;
+    const float values[] = { -1000.0f, -2.5f, -0.0f, 0.0f, 1e-6f, 3.0f, 12345.0f };
+    for (size_t i = 1; i < sizeof(values) / sizeof(values[0]); ++i) {
+        assert(floatToSortableKey(values[i - 1]) <= floatToSortableKey(values[i]));
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRadixSortSerial()
+{
+    std::cout << "  Test: Serial radix sort is stable and correct" << std::endl;
+    std::mt19937 rng(7);
+    std::vector<uint32_t> keys(5000);
+    for (uint32_t& key : keys) key = rng() % 300; // Many duplicates, high bytes all zero
+    checkMatchesStableSort(keys, nullptr);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRadixSortParallel()
+{
+    std::cout << "  Test: Parallel radix sort matches serial" << std::endl;
+    JobSystem jobs(3);
+    std::mt19937 rng(11);
+    std::vector<uint32_t> keys(200000);
+    for (uint32_t& key : keys) key = rng();
+    checkMatchesStableSort(keys, &jobs);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestBackToFrontUpload()
+{
+    std::cout << "  Test: Particles are uploaded back to front" << std::endl;
+    ParticleSimulation system(64);
+    system.setDepthSorting(true);
+
+    glm::vec3 eye(0.0f);
+    glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    system.setCamera(view, projection, eye);
+
+    const float depths[] = { 5.0f, 20.0f, 1.0f, 12.0f, 7.0f };
+    for (float depth : depths) {
+        system.spawnParticle(Particle(glm::vec3(0.0f, 0.0f, -depth), glm::vec3(0.0f), glm::vec4(1.0f), 5.0f, 5.0f));
+    }
+    system.update(0.016f);
+    assert(!system.wasSortReused());
+
+    const std::vector<uint32_t>& order = system.getDrawOrder();
+    assert(order.size() == 5);
+    for (size_t i = 1; i < order.size(); ++i) {
+        float previous = system.getParticles()[order[i - 1]].position.z;
+        float current = system.getParticles()[order[i]].position.z;
+        assert(previous <= current && "Nearer particle drawn before a farther one");
+    }
+
+    // Still camera: the order is reused and a newcomer goes last
+    system.spawnParticle(Particle(glm::vec3(0.0f, 0.0f, -50.0f), glm::vec3(0.0f), glm::vec4(1.0f), 5.0f, 5.0f));
+    system.update(0.016f);
+    assert(system.wasSortReused());
+    assert(system.getDrawOrder().size() == 6);
+    assert(system.getParticles()[system.getDrawOrder().back()].position.z == -50.0f);
+
+    // The reused order expires after a bounded amount of simulation time
+    system.update(0.2f);
+    assert(!system.wasSortReused());
+
+    // Moving the camera forces a full sort again
+    eye = glm::vec3(0.0f, 0.0f, 2.0f);
+    view = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    system.setCamera(view, projection, eye);
+    system.update(0.016f);
+    assert(!system.wasSortReused());
+    assert(system.getParticles()[system.getDrawOrder().front()].position.z == -50.0f);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ParticleSort Tests..." << std::endl;
+    TestSortableFloatKeys();
+    TestRadixSortSerial();
+    TestRadixSortParallel();
+    TestBackToFrontUpload();
+    std::cout << "ParticleSort Tests Completed Successfully!" << std::endl;
+    return 0;
+}
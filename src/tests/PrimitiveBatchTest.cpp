@@ -0,0 +1,160 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "GLTestContext.hpp"
+#include "Renderer.hpp"
+
+using namespace TurtleEngine;
+
+// Instanced shape batching in the Renderer. Needs a GL context; CI runs it on Mesa
+// llvmpipe.
+
+namespace {
+    const int TARGET_SIZE = 128;
+
+    struct Target {
+        GLuint fbo = 0;
+        GLuint color = 0;
+
+        Target() {
+            glGenTextures(1, &color);
+            glBindTexture(GL_TEXTURE_2D, color);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TARGET_SIZE, TARGET_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glGenFramebuffers(1, &fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+            assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+            glViewport(0, 0, TARGET_SIZE, TARGET_SIZE);
+        }
+        ~Target() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &fbo);
+            glDeleteTextures(1, &color);
+        }
+
+        std::vector<unsigned char> read() const {
+            std::vector<unsigned char> pixels(TARGET_SIZE * TARGET_SIZE * 4);
+            glReadPixels(0, 0, TARGET_SIZE, TARGET_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            return pixels;
+        }
+    };
+
+    // A HUD-like scene: opaque shapes on a lattice, then a translucent layer on top.
+    // Each shape type only overlaps itself within a layer, so batching may reorder
+    // the types without changing the picture.
+    void drawScene(Renderer& renderer) {
+        const int perSide = 12;
+        const float step = 2.0f / perSide;
+        for (int y = 0; y < perSide; ++y) {
+            for (int x = 0; x < perSide; ++x) {
+                glm::vec2 centre(-1.0f + step * (x + 0.5f), -1.0f + step * (y + 0.5f));
+                glm::vec4 color(x / float(perSide), y / float(perSide), 0.5f, 1.0f);
+                switch ((x + y) % 3) {
+                    case 0: renderer.drawRectangle(centre, 0.0f, glm::vec2(step * 0.8f), color); break;
+                    case 1: renderer.drawTriangle(centre, 0.0f, glm::vec2(step * 0.8f), color); break;
+                    default: renderer.drawCircle(centre, step * 0.4f, color); break;
+                }
+            }
+        }
+        renderer.setBatchLayer(1);
+        for (int i = 0; i < 8; ++i) {
+            renderer.drawRectangle(glm::vec2(-0.8f + 0.2f * i, 0.0f), 0.0f, glm::vec2(0.1f, 1.5f), glm::vec4(1.0f, 1.0f, 1.0f, 0.5f));
+        }
+        renderer.setBatchLayer(0);
+    }
+
+    size_t countDifferences(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b) {
+        size_t different = 0;
+        for (size_t i = 0; i < a.size(); i += 4) {
+            for (size_t c = 0; c < 4; ++c) {
+                if (std::abs(int(a[i + c]) - int(b[i + c])) > 1) {
+                    ++different;
+                    break;
+                }
+            }
+        }
+        return different;
+    }
+}
+
+void TestBatchedMatchesImmediate(Renderer& renderer)
+{
+    std::cout << "  Test: Batched frame matches the immediate frame in far fewer draws" << std::endl;
+    Target target;
+
+    renderer.clear();
+    renderer.resetDrawCallCount();
+    drawScene(renderer);
+    const size_t immediateDraws = renderer.getDrawCallCount();
+    std::vector<unsigned char> immediate = target.read();
+
+    renderer.clear();
+    renderer.resetDrawCallCount();
+    renderer.setBatching(true);
+    drawScene(renderer);
+    assert(renderer.getDrawCallCount() == 0); // Nothing drawn until the flush
+    renderer.flush();
+    const size_t batchedDraws = renderer.getDrawCallCount();
+    renderer.setBatching(false);
+    std::vector<unsigned char> batched = target.read();
+
+    std::cout << "    Draw calls per frame: " << immediateDraws << " immediate, " << batchedDraws << " batched" << std::endl;
+    assert(immediateDraws == 12 * 12 + 8);
+    assert(batchedDraws == 4); // Three opaque shape runs, one translucent run
+    std::vector<unsigned char> cleared(immediate.size(), 0);
+    for (size_t i = 3; i < cleared.size(); i += 4) cleared[i] = 255;
+    assert(countDifferences(immediate, cleared) > immediate.size() / 4 / 4); // The scene really drew
+    assert(countDifferences(immediate, batched) == 0);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRotationAndStateRestore(Renderer& renderer)
+{
+    std::cout << "  Test: Rotated instances match and GL state is restored" << std::endl;
+    Target target;
+
+    renderer.clear();
+    renderer.drawTriangle(glm::vec2(-0.4f, 0.3f), 0.7f, glm::vec2(0.6f, 0.4f), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    renderer.drawRectangle(glm::vec2(0.4f, -0.3f), -1.2f, glm::vec2(0.5f, 0.2f), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    std::vector<unsigned char> immediate = target.read();
+
+    renderer.clear();
+    renderer.setBatching(true);
+    renderer.drawTriangle(glm::vec2(-0.4f, 0.3f), 0.7f, glm::vec2(0.6f, 0.4f), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    renderer.drawRectangle(glm::vec2(0.4f, -0.3f), -1.2f, glm::vec2(0.5f, 0.2f), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    renderer.setBatching(false); // Turning batching off flushes
+    std::vector<unsigned char> batched = target.read();
+
+    // The instance shader rotates with precomputed cos/sin rather than a model
+    // matrix, so allow an edge pixel or two to round differently
+    assert(countDifferences(immediate, batched) <= 8);
+
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    assert(static_cast<GLuint>(program) == renderer.getDefaultShader());
+    assert(glIsEnabled(GL_BLEND));
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running PrimitiveBatch Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    {
+        Renderer renderer;
+        renderer.init();
+        TestBatchedMatchesImmediate(renderer);
+        TestRotationAndStateRestore(renderer);
+    }
+
+    std::cout << "PrimitiveBatch Tests Completed Successfully!" << std::endl;
+    return 0;
+}
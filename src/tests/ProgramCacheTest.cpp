@@ -0,0 +1,271 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "GLTestContext.hpp"
+#include "ProgramCache.hpp"
+#include "Shader.hpp"
+#include "UniformBuffer.hpp"
+
+using namespace TurtleEngine;
+
+// On-disk program binary cache. Needs a GL context; CI runs it on Mesa llvmpipe.
+// A driver without binary formats must still compile every program, so the cache
+// assertions only apply when it is enabled.
+
+namespace {
+    const std::string VERTEX_SOURCE = R"(
+        #version 330 core
+        void main() {
+            vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+            gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )";
+
+    const std::string FRAGMENT_SOURCE = R"(
+        #version 330 core
+        uniform vec4 color;
+        out vec4 FragColor;
+        void main() {
+            FragColor = color;
+        }
+    )";
+
+    std::filesystem::path cacheDirectory() {
+        return std::filesystem::temp_directory_path() / "turtle_program_cache_test";
+    }
+
+    GLuint buildProgram(ProgramCache& cache, const std::string& vertex, const std::string& fragment, int& builds) {
+        return cache.getProgram({ &vertex, &fragment }, [&](GLuint program) {
+            ++builds;
+            const char* sources[] = { vertex.c_str(), fragment.c_str() };
+            const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+            GLuint shaders[2];
+            bool compiled = true;
+            for (int i = 0; i < 2; ++i) {
+                shaders[i] = glCreateShader(types[i]);
+                glShaderSource(shaders[i], 1, &sources[i], nullptr);
+                glCompileShader(shaders[i]);
+                GLint success = 0;
+                glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
+                compiled = compiled && success;
+                glAttachShader(program, shaders[i]);
+            }
+            if (compiled) {
+                glLinkProgram(program);
+            }
+            glDeleteShader(shaders[0]);
+            glDeleteShader(shaders[1]);
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            return compiled && linked;
+        });
+    }
+
+    // Draws a full-screen triangle with 'program' and returns the red channel
+    int drawRed(GLuint program, float red) {
+        GLuint color, fbo, vao;
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 8, 8);
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+
+        glViewport(0, 0, 8, 8);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUseProgram(program);
+        glUniform4f(glGetUniformLocation(program, "color"), red, 0.0f, 0.0f, 1.0f);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        unsigned char pixel[4] = {};
+        glReadPixels(4, 4, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+        glUseProgram(0);
+        glBindVertexArray(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &color);
+        return pixel[0];
+    }
+
+    std::vector<std::filesystem::path> entries() {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory())) {
+            files.push_back(entry.path());
+        }
+        return files;
+    }
+}
+
+void TestMissStoresThenHitLoads()
+{
+    std::cout << "  Test: A miss compiles and stores; the next run loads the binary" << std::endl;
+    std::filesystem::remove_all(cacheDirectory());
+    int builds = 0;
+
+    ProgramCache first;
+    first.setDirectory(cacheDirectory().string());
+    GLuint compiled = buildProgram(first, VERTEX_SOURCE, FRAGMENT_SOURCE, builds);
+    assert(compiled != 0);
+    assert(builds == 1);
+    assert(first.getStats().misses == 1);
+    assert(drawRed(compiled, 1.0f) == 255);
+    glDeleteProgram(compiled);
+
+    if (!first.isEnabled()) {
+        std::cout << "    (Driver has no program binary formats; checked the compile fallback only)" << std::endl;
+        assert(first.getStats().stores == 0);
+        assert(first.describeStats().find("disabled") != std::string::npos);
+        std::cout << "    Passed." << std::endl;
+        return;
+    }
+    assert(first.getStats().stores == 1);
+    assert(entries().size() == 1);
+
+    // A fresh cache, as on the next launch
+    ProgramCache second;
+    second.setDirectory(cacheDirectory().string());
+    GLuint loaded = buildProgram(second, VERTEX_SOURCE, FRAGMENT_SOURCE, builds);
+    assert(loaded != 0);
+    assert(builds == 1);
+    assert(second.getStats().hits == 1);
+    assert(second.getStats().misses == 0);
+    assert(second.describeStats().find("1 hit, 0 misses") != std::string::npos);
+    // Uniforms are back to their defaults and set as usual
+    const int red = drawRed(loaded, 0.5f);
+    assert(red == 127 || red == 128);
+    glDeleteProgram(loaded);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestEditedSourceMisses()
+{
+    std::cout << "  Test: Editing a source misses instead of loading the old binary" << std::endl;
+    int builds = 0;
+    ProgramCache cache;
+    cache.setDirectory(cacheDirectory().string());
+    if (!cache.isEnabled()) {
+        std::cout << "    Skipped (cache unsupported)." << std::endl;
+        return;
+    }
+
+    GLuint original = buildProgram(cache, VERTEX_SOURCE, FRAGMENT_SOURCE, builds);
+    GLuint edited = buildProgram(cache, VERTEX_SOURCE, FRAGMENT_SOURCE + "// edited\n", builds);
+    assert(original != 0 && edited != 0);
+    assert(builds == 1);
+    assert(cache.getStats().hits == 1);
+    assert(cache.getStats().misses == 1);
+    assert(entries().size() == 2);
+
+    // A broken program is reported, not cached
+    GLuint broken = buildProgram(cache, VERTEX_SOURCE, "#version 330 core\nvoid main() { oops }\n", builds);
+    assert(broken == 0);
+    assert(entries().size() == 2);
+
+    glDeleteProgram(original);
+    glDeleteProgram(edited);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestCorruptEntryFallsBackToCompiling()
+{
+    std::cout << "  Test: A damaged entry is rejected, recompiled and replaced" << std::endl;
+    ProgramCache cache;
+    cache.setDirectory(cacheDirectory().string());
+    if (!cache.isEnabled()) {
+        std::cout << "    Skipped (cache unsupported)." << std::endl;
+        return;
+    }
+    std::filesystem::remove_all(cacheDirectory());
+    int builds = 0;
+    glDeleteProgram(buildProgram(cache, VERTEX_SOURCE, FRAGMENT_SOURCE, builds));
+    assert(builds == 1);
+    const std::filesystem::path entry = entries().front();
+
+    // Flip bytes in the driver's blob, past the entry header
+    {
+        std::fstream file(entry, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        const std::streamoff size = file.tellg();
+        std::vector<char> bytes(static_cast<size_t>(size));
+        file.seekg(0);
+        file.read(bytes.data(), size);
+        for (std::streamoff i = 32; i < size; i += 7) {
+            bytes[static_cast<size_t>(i)] ^= 0x5A;
+        }
+        file.seekp(0);
+        file.write(bytes.data(), size);
+    }
+    GLuint program = buildProgram(cache, VERTEX_SOURCE, FRAGMENT_SOURCE, builds);
+    assert(program != 0);
+    assert(builds == 2);
+    assert(cache.getStats().rejected == 1);
+    assert(drawRed(program, 1.0f) == 255);
+    glDeleteProgram(program);
+
+    // Truncated to less than a header
+    std::filesystem::resize_file(entry, 5);
+    program = buildProgram(cache, VERTEX_SOURCE, FRAGMENT_SOURCE, builds);
+    assert(program != 0);
+    assert(builds == 3);
+    assert(cache.getStats().rejected == 2);
+    glDeleteProgram(program);
+
+    // The replacement is good again
+    program = buildProgram(cache, VERTEX_SOURCE, FRAGMENT_SOURCE, builds);
+    assert(builds == 3);
+    glDeleteProgram(program);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestShaderRebindsBlocksAfterLoad()
+{
+    std::cout << "  Test: Shader::loadFromFiles wires uniform blocks on cached programs" << std::endl;
+    ProgramCache& cache = ProgramCache::shared();
+    cache.setDirectory(cacheDirectory().string());
+    cache.resetStats();
+
+    for (int run = 0; run < 2; ++run) {
+        Shader lighting;
+        const bool loaded = lighting.loadFromFiles("shaders/lighting.vert", "shaders/lighting.frag");
+        assert(loaded);
+        const GLuint program = lighting.getProgram();
+        GLint binding = -1;
+        glGetActiveUniformBlockiv(program, glGetUniformBlockIndex(program, "Camera"), GL_UNIFORM_BLOCK_BINDING, &binding);
+        assert(binding == CAMERA_BLOCK_BINDING);
+        glGetActiveUniformBlockiv(program, glGetUniformBlockIndex(program, "Lights"), GL_UNIFORM_BLOCK_BINDING, &binding);
+        assert(binding == LIGHTS_BLOCK_BINDING);
+    }
+    if (cache.isEnabled()) {
+        assert(cache.getStats().hits >= 1);
+    }
+    std::cout << "    " << cache.describeStats() << std::endl;
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ProgramCache Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestMissStoresThenHitLoads();
+    TestEditedSourceMisses();
+    TestCorruptEntryFallsBackToCompiling();
+    TestShaderRebindsBlocksAfterLoad();
+
+    std::filesystem::remove_all(cacheDirectory());
+    std::cout << "ProgramCache Tests Completed Successfully!" << std::endl;
+    return 0;
+}
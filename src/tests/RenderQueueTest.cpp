@@ -0,0 +1,378 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLTestContext.hpp"
+#include "RenderQueue.hpp"
+#include "Grid.hpp"
+#include "JobSystem.hpp"
+
+using namespace TurtleEngine;
+
+// Sort keys, the retained command queue and its GL state cache. Needs a GL context;
+// CI runs it on Mesa llvmpipe.
+
+namespace {
+    const int TARGET_SIZE = 64;
+
+    const char* VERTEX_SOURCE = R"(
+        #version 330 core
+        layout (location = 0) in vec2 aPos;
+        uniform vec2 offset;
+        void main() {
+            gl_Position = vec4(aPos * 0.125 + offset, 0.0, 1.0);
+        }
+    )";
+
+    // Two fragment shaders so packets differ by program
+    const char* FLAT_SOURCE = R"(
+        #version 330 core
+        uniform vec4 color;
+        out vec4 FragColor;
+        void main() { FragColor = color; }
+    )";
+
+    const char* INVERTED_SOURCE = R"(
+        #version 330 core
+        uniform vec4 color;
+        out vec4 FragColor;
+        void main() { FragColor = vec4(1.0 - color.rgb, 1.0); }
+    )";
+
+    GLuint compile(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint ok = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        assert(ok);
+        return shader;
+    }
+
+    GLuint linkProgram(const char* fragmentSource) {
+        GLuint vertex = compile(GL_VERTEX_SHADER, VERTEX_SOURCE);
+        GLuint fragment = compile(GL_FRAGMENT_SHADER, fragmentSource);
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        GLint ok = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        assert(ok);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return program;
+    }
+
+    struct Target {
+        GLuint fbo = 0;
+        GLuint color = 0;
+
+        Target(int width, int height) {
+            glGenRenderbuffers(1, &color);
+            glBindRenderbuffer(GL_RENDERBUFFER, color);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glGenFramebuffers(1, &fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+            assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+            glViewport(0, 0, width, height);
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        ~Target() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &fbo);
+            glDeleteRenderbuffers(1, &color);
+        }
+
+        std::vector<uint8_t> read(int width, int height) const {
+            std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            return pixels;
+        }
+    };
+}
+
+void TestKeyOrdering()
+{
+    std::cout << "  Test: Keys order passes, state and depth" << std::endl;
+    // Passes dominate everything
+    assert(makeRenderKey(RenderPass::SOLID, 4095, 65535, 1e9f) < makeRenderKey(RenderPass::TRANSLUCENT, 0, 0, 0.0f));
+    assert(makeRenderKey(RenderPass::TRANSLUCENT, 4095, 65535, -1e9f) < makeRenderKey(RenderPass::OVERLAY, 0, 0, 0.0f));
+    // Solid: grouped by shader, then material, then near to far
+    assert(makeRenderKey(RenderPass::SOLID, 1, 9, 100.0f) < makeRenderKey(RenderPass::SOLID, 2, 0, 1.0f));
+    assert(makeRenderKey(RenderPass::SOLID, 1, 1, 100.0f) < makeRenderKey(RenderPass::SOLID, 1, 2, 1.0f));
+    assert(makeRenderKey(RenderPass::SOLID, 1, 1, 1.0f) < makeRenderKey(RenderPass::SOLID, 1, 1, 2.0f));
+    assert(makeRenderKey(RenderPass::SOLID, 1, 1, -2.0f) < makeRenderKey(RenderPass::SOLID, 1, 1, -1.0f));
+    // Translucent: far to near regardless of state
+    assert(makeRenderKey(RenderPass::TRANSLUCENT, 9, 9, 50.0f) < makeRenderKey(RenderPass::TRANSLUCENT, 1, 1, 5.0f));
+    assert(makeRenderKey(RenderPass::TRANSLUCENT, 1, 1, 5.0f) < makeRenderKey(RenderPass::TRANSLUCENT, 2, 1, 5.0f));
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestExecutionOrderIsStable()
+{
+    std::cout << "  Test: Commands run in key order, ties in submission order" << std::endl;
+    RenderQueue queue;
+    std::vector<int> executed;
+    const uint64_t keys[] = {
+        makeRenderKey(RenderPass::OVERLAY, 0, 0, 0.0f),
+        makeRenderKey(RenderPass::SOLID, 3, 0, 2.0f),
+        makeRenderKey(RenderPass::TRANSLUCENT, 0, 0, 1.0f),
+        makeRenderKey(RenderPass::SOLID, 3, 0, 2.0f), // Tie with #1
+        makeRenderKey(RenderPass::SOLID, 3, 0, 1.0f),
+        makeRenderKey(RenderPass::TRANSLUCENT, 0, 0, 8.0f),
+    };
+    for (int i = 0; i < 6; ++i) {
+        queue.submitCallback(keys[i], [&executed, i]() { executed.push_back(i); });
+    }
+    queue.execute();
+    assert((executed == std::vector<int>{ 4, 1, 3, 5, 2, 0 }));
+    assert(queue.size() == 0);
+    assert(queue.getLastStats().callbacks == 6 && queue.getLastStats().draws == 0);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRedundantStateIsSkipped()
+{
+    std::cout << "  Test: Interleaved submissions bind each program once" << std::endl;
+    Target target(TARGET_SIZE, TARGET_SIZE);
+    GLuint flat = linkProgram(FLAT_SOURCE);
+    GLuint inverted = linkProgram(INVERTED_SOURCE);
+
+    const float quad[] = { -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f };
+    GLuint vao = 0, vbo = 0;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+
+    // An 8x8 checker of quads, alternating programs in submission order
+    RenderQueue queue;
+    const glm::vec4 red(1.0f, 0.0f, 0.0f, 1.0f);
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            GLuint program = (x + y) % 2 == 0 ? flat : inverted;
+            RenderCommand& command = queue.submit(makeRenderKey(RenderPass::SOLID, program, 0, float(y * 8 + x)));
+            command.program = program;
+            command.vertexArray = vao;
+            command.count = 6;
+            queue.setUniform(glGetUniformLocation(program, "offset"), glm::vec2(-0.875f + 0.25f * x, -0.875f + 0.25f * y));
+            queue.setUniform(glGetUniformLocation(program, "color"), red);
+        }
+    }
+    queue.execute();
+
+    const RenderQueueStats& stats = queue.getLastStats();
+    std::cout << "    " << stats.commands << " packets, " << stats.state.changes << " state changes, "
+              << stats.state.avoided << " avoided, " << stats.uniformsSkipped << " uniforms skipped" << std::endl;
+    assert(stats.draws == 64);
+    // Two programs, one VAO, three toggles, and the final VAO unbind
+    assert(stats.state.changes == 2 + 1 + 3 + 1);
+    assert(stats.state.avoided == 64 * 5 - (2 + 1 + 3));
+    assert(stats.uniformUploads == 64 + 2 && stats.uniformsSkipped == 62); // 'color' is sent once per program
+
+    std::vector<uint8_t> pixels = target.read(TARGET_SIZE, TARGET_SIZE);
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            const uint8_t* p = &pixels[((y * 8 + 4) * TARGET_SIZE + x * 8 + 4) * 4];
+            if ((x + y) % 2 == 0) assert(p[0] == 255 && p[1] == 0 && p[2] == 0);
+            else assert(p[0] == 0 && p[1] == 255 && p[2] == 255);
+        }
+    }
+
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteProgram(flat);
+    glDeleteProgram(inverted);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestBlendFactorsPerPacket()
+{
+    std::cout << "  Test: Blended packets set their own blend factors" << std::endl;
+    Target target(TARGET_SIZE, TARGET_SIZE);
+    GLuint flat = linkProgram(FLAT_SOURCE);
+
+    const float quad[] = { -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f };
+    GLuint vao = 0, vbo = 0;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+
+    // Factors left behind by someone else must not leak into the packets
+    glBlendFunc(GL_ZERO, GL_ONE);
+
+    // Opaque red, then additive green on top: yellow
+    RenderQueue queue;
+    RenderCommand& opaque = queue.submit(makeRenderKey(RenderPass::SOLID, flat, 0, 1.0f));
+    opaque.program = flat;
+    opaque.vertexArray = vao;
+    opaque.count = 6;
+    queue.setUniform(glGetUniformLocation(flat, "offset"), glm::vec2(0.0f));
+    queue.setUniform(glGetUniformLocation(flat, "color"), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    RenderCommand& additive = queue.submit(makeRenderKey(RenderPass::TRANSLUCENT, flat, 0, 1.0f));
+    additive.program = flat;
+    additive.vertexArray = vao;
+    additive.count = 6;
+    additive.state.blend = true;
+    additive.state.blendSource = GL_ONE;
+    additive.state.blendDestination = GL_ONE;
+    additive.state.depthWrite = false;
+    queue.setUniform(glGetUniformLocation(flat, "color"), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    queue.execute();
+
+    std::vector<uint8_t> pixels = target.read(TARGET_SIZE, TARGET_SIZE);
+    const uint8_t* centre = &pixels[((TARGET_SIZE / 2) * TARGET_SIZE + TARGET_SIZE / 2) * 4];
+    assert(centre[0] == 255 && centre[1] == 255 && centre[2] == 0);
+
+    GLint source = 0, destination = 0;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &source);
+    glGetIntegerv(GL_BLEND_DST_RGB, &destination);
+    assert(source == GL_ONE && destination == GL_ONE);
+
+    glDisable(GL_BLEND);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteProgram(flat);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestGridSubmitMatchesRender()
+{
+    std::cout << "  Test: Grid packets draw what Grid::render draws" << std::endl;
+    const int size = 128;
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+    glm::mat4 projection = glm::ortho(-32.0f, 32.0f, -32.0f, 32.0f, 0.1f, 100.0f);
+
+    for (GridRenderMode mode : { GridRenderMode::COLOR_TEXTURE, GridRenderMode::PER_VERTEX_COLOR }) {
+        Grid grid(64, 64, 1.0f, mode, 16);
+        for (int i = 0; i < 64; ++i) {
+            grid.setCellColor(i, (i * 7) % 64, glm::vec3(i / 64.0f, 1.0f, 0.0f));
+        }
+
+        std::vector<uint8_t> rendered;
+        {
+            Target target(size, size);
+            grid.render(projection, view);
+            rendered = target.read(size, size);
+        }
+
+        Target target(size, size);
+        RenderQueue queue;
+        grid.submit(queue, projection, view);
+        assert(queue.size() == 16 && grid.getLastVisibleChunkCount() == 16);
+        queue.execute();
+        assert(target.read(size, size) == rendered);
+
+        const RenderQueueStats& stats = queue.getLastStats();
+        assert(stats.draws == 16);
+        assert(stats.uniformsSkipped >= 15); // The shared model matrix is set once; the camera is in its block
+        assert(glGetError() == GL_NO_ERROR);
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestParallelRecordingMatchesSerial()
+{
+    std::cout << "  Test: Lists recorded on the job system merge like serial submission" << std::endl;
+    JobSystem jobs(4);
+    const size_t count = 5000;
+    // Few distinct keys, so ordering among ties depends entirely on the merge
+    auto keyFor = [](size_t i) { return makeRenderKey(i % 3 == 0 ? RenderPass::TRANSLUCENT : RenderPass::SOLID, uint32_t(i % 5), 0, float(i % 7)); };
+
+    std::vector<size_t> serialOrder;
+    RenderQueue serial;
+    for (size_t i = 0; i < count; ++i) {
+        serial.submitCallback(keyFor(i), [&serialOrder, i]() { serialOrder.push_back(i); });
+    }
+    for (size_t i = 0; i < count; ++i) {
+        serial.submitCallback(keyFor(i), [&serialOrder, i]() { serialOrder.push_back(count + i); });
+    }
+    serial.execute();
+
+    RenderQueue parallel;
+    for (int frame = 0; frame < 3; ++frame) { // Reused lists must not leak packets between frames
+        std::vector<size_t> parallelOrder;
+        for (size_t pass = 0; pass < 2; ++pass) {
+            parallel.recordParallel(jobs, count, 64, [&](RenderCommandList& list, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const size_t id = pass * count + i;
+                    list.submitCallback(keyFor(i), [&parallelOrder, id]() { parallelOrder.push_back(id); });
+                }
+            });
+        }
+        assert(parallel.size() == 2 * count);
+        parallel.execute();
+        assert(parallel.size() == 0);
+        assert(parallelOrder == serialOrder);
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestGridRecordsInParallel()
+{
+    std::cout << "  Test: Grid chunks recorded from jobs draw the same frame" << std::endl;
+    const int size = 128;
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+    glm::mat4 projection = glm::ortho(-32.0f, 32.0f, -32.0f, 32.0f, 0.1f, 100.0f);
+    Grid grid(64, 64, 1.0f, GridRenderMode::COLOR_TEXTURE, 8);
+    for (int i = 0; i < 64; ++i) {
+        grid.setCellColor((i * 5) % 64, i, glm::vec3(1.0f, i / 64.0f, 0.5f));
+    }
+
+    std::vector<uint8_t> rendered;
+    {
+        Target target(size, size);
+        grid.render(projection, view);
+        rendered = target.read(size, size);
+    }
+
+    JobSystem jobs(3);
+    Target target(size, size);
+    RenderQueue queue;
+    const size_t packets = grid.prepare(projection, view); // GL work stays on this thread
+    assert(packets == 64);
+    queue.recordParallel(jobs, packets, 4, [&](RenderCommandList& list, size_t begin, size_t end) {
+        grid.recordChunks(list, begin, end, view);
+    });
+    queue.execute();
+    assert(queue.getLastStats().draws == 64);
+    assert(target.read(size, size) == rendered);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running RenderQueue Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestKeyOrdering();
+    TestExecutionOrderIsStable();
+    TestRedundantStateIsSkipped();
+    TestBlendFactorsPerPacket();
+    TestGridSubmitMatchesRender();
+    TestParallelRecordingMatchesSerial();
+    TestGridRecordsInParallel();
+
+    std::cout << "RenderQueue Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GL/glew.h>
+#include "GLTestContext.hpp"
+#include "ProgramCache.hpp"
+#include "ShaderManager.hpp"
+#include "ShaderPipeline.hpp"
+#include "ShaderSource.hpp"
+#include "UniformBuffer.hpp"
+
+using namespace TurtleEngine;
+
+// #include expansion and shader hot reload. Needs a GL context; CI runs it on Mesa
+// llvmpipe. Shaders are written to a temporary directory and edited in place.
+
+namespace {
+    std::filesystem::path directory() {
+        return std::filesystem::temp_directory_path() / "turtle_shader_manager_test";
+    }
+
+    std::string pathOf(const std::string& name) {
+        return ShaderSourceCache::normalize((directory() / name).string());
+    }
+
+    void writeFile(const std::string& name, const std::string& text) {
+        std::filesystem::create_directories(std::filesystem::path(pathOf(name)).parent_path());
+        std::ofstream file(pathOf(name), std::ios::trunc);
+        file << text;
+    }
+
+    void writeColor(const std::string& red) {
+        writeFile("include/color.glsl", "const float RED = " + red + ";\n");
+    }
+
+    int drawRed(GLuint program) {
+        GLuint color, fbo, vao;
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 8, 8);
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+
+        glViewport(0, 0, 8, 8);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUseProgram(program);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        unsigned char pixel[4] = {};
+        glReadPixels(4, 4, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+        glUseProgram(0);
+        glBindVertexArray(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &color);
+        return pixel[0];
+    }
+
+    // Runs update() until 'done' or five seconds pass
+    template <typename Done>
+    bool updateUntil(ShaderManager& manager, Done done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            manager.update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+}
+
+void TestIncludeExpansion()
+{
+    std::cout << "  Test: #include is expanded relative to the including file, with #line markers" << std::endl;
+    writeFile("shader.frag", "#version 330 core\n#include \"include/lib.glsl\"\nvoid main() {}\n");
+    writeFile("include/lib.glsl", "#include \"color.glsl\"\nfloat lib() { return RED; }\n");
+    writeColor("0.25");
+
+    ShaderSourceCache& cache = ShaderSourceCache::shared();
+    std::string source;
+    std::vector<std::string> files;
+    bool loaded = cache.load(pathOf("shader.frag"), source, files);
+    assert(loaded);
+    assert(files.size() == 3);
+    assert(files[0] == pathOf("shader.frag"));
+    assert(files[1] == pathOf("include/lib.glsl"));
+    assert(files[2] == pathOf("include/color.glsl"));
+    assert(source.rfind("#version 330 core\n#line 1 1\n#line 1 2\nconst float RED = 0.25;\n#line 2 1\n", 0) == 0);
+    assert(source.find("float lib()") != std::string::npos);
+    assert(source.find("#line 3 0\nvoid main() {}") != std::string::npos);
+
+    // Unchanged files come from the cache
+    const size_t reads = cache.getStats().fileReads;
+    loaded = cache.load(pathOf("shader.frag"), source, files);
+    assert(loaded);
+    assert(cache.getStats().fileReads == reads);
+    cache.invalidate(pathOf("include/color.glsl"));
+    loaded = cache.load(pathOf("shader.frag"), source, files);
+    assert(loaded);
+    assert(cache.getStats().fileReads == reads + 1);
+
+    writeFile("cycle.glsl", "#include \"cycle.glsl\"\n");
+    loaded = cache.load(pathOf("cycle.glsl"), source, files);
+    assert(!loaded);
+    writeFile("missing.glsl", "#include \"nowhere.glsl\"\n");
+    loaded = cache.load(pathOf("missing.glsl"), source, files);
+    assert(!loaded);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestEditedIncludeReloadsProgram()
+{
+    std::cout << "  Test: Editing an include rebuilds and swaps the program" << std::endl;
+    writeFile("fullscreen.vert",
+              "#version 330 core\n"
+              "void main() {\n"
+              "    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+              "    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+              "}\n");
+    writeFile("color.frag",
+              "#version 330 core\n"
+              "#include \"include/color.glsl\"\n"
+              "out vec4 FragColor;\n"
+              "void main() { FragColor = vec4(RED, 0.0, 0.0, 1.0); }\n");
+    writeColor("0.25");
+
+    ShaderManager manager;
+    std::vector<ShaderId> reloaded;
+    manager.setReloadCallback([&](ShaderId id) { reloaded.push_back(id); });
+    ShaderId id = manager.load(pathOf("fullscreen.vert"), pathOf("color.frag"));
+    assert(id != INVALID_SHADER);
+    assert(std::abs(drawRed(manager.get(id).getProgram()) - 64) <= 1);
+    std::cout << "    (" << (manager.isUsingInotify() ? "inotify" : "polling") << ")" << std::endl;
+
+    // Nothing changed, nothing happens
+    manager.update();
+    assert(manager.getStats().reloads == 0);
+
+    writeColor("0.75");
+    const bool settled = updateUntil(manager, [&] { return manager.getStats().reloads == 1; });
+    assert(settled);
+    assert(reloaded.size() == 1 && reloaded[0] == id);
+    assert(std::abs(drawRed(manager.get(id).getProgram()) - 191) <= 1);
+    // The pipeline forgets the landed rebuild on the next update
+    manager.update();
+    assert(ShaderPipeline::shared().getPendingCount() == 0);
+    assert(glGetError() == GL_NO_ERROR);
+    manager.cleanup();
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestBrokenEditKeepsLiveProgram()
+{
+    std::cout << "  Test: A change that fails to compile keeps the old program" << std::endl;
+    writeColor("0.75");
+    ShaderManager manager;
+    ShaderId id = manager.load(pathOf("fullscreen.vert"), pathOf("color.frag"));
+    assert(id != INVALID_SHADER);
+    const GLuint live = manager.get(id).getProgram();
+
+    writeColor("0.5 +");
+    bool settled = updateUntil(manager, [&] { return manager.getStats().failedReloads == 1; });
+    assert(settled);
+    assert(manager.getStats().reloads == 0);
+    assert(manager.get(id).getProgram() == live);
+    assert(std::abs(drawRed(live) - 191) <= 1);
+
+    // Fixing it recovers
+    writeColor("1.0");
+    settled = updateUntil(manager, [&] { return manager.getStats().reloads == 1; });
+    assert(settled);
+    assert(drawRed(manager.get(id).getProgram()) == 255);
+    manager.cleanup();
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ShaderManager Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    std::filesystem::remove_all(directory());
+    ProgramCache::shared().setDirectory((directory() / "cache").string());
+
+    TestIncludeExpansion();
+    TestEditedIncludeReloadsProgram();
+    TestBrokenEditKeepsLiveProgram();
+
+    std::filesystem::remove_all(directory());
+    std::cout << "ShaderManager Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GL/glew.h>
+#include "GLTestContext.hpp"
+#include "ProgramCache.hpp"
+#include "ShaderPipeline.hpp"
+#include "Shader.hpp"
+#include "UniformBuffer.hpp"
+
+using namespace TurtleEngine;
+
+// Asynchronous program builds. Needs a GL context; CI runs it on Mesa llvmpipe,
+// which may or may not expose KHR_parallel_shader_compile, so the polling test
+// only runs where it does.
+
+namespace {
+    const std::string VERTEX_SOURCE = R"(
+        #version 330 core
+        void main() {
+            vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+            gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )";
+
+    // Each program gets its own constant so none of them share a cache entry
+    std::string fragmentSource(int variant) {
+        return "#version 330 core\n"
+               "uniform vec4 color;\n"
+               "out vec4 FragColor;\n"
+               "void main() { FragColor = color * " + std::to_string(variant) + ".0 / 8.0; }\n";
+    }
+
+    std::filesystem::path cacheDirectory() {
+        return std::filesystem::temp_directory_path() / "turtle_shader_pipeline_test";
+    }
+
+    int drawRed(GLuint program) {
+        GLuint color, fbo, vao;
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 8, 8);
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+
+        glViewport(0, 0, 8, 8);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUseProgram(program);
+        glUniform4f(glGetUniformLocation(program, "color"), 1.0f, 0.0f, 0.0f, 1.0f);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        unsigned char pixel[4] = {};
+        glReadPixels(4, 4, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+        glUseProgram(0);
+        glBindVertexArray(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &color);
+        return pixel[0];
+    }
+}
+
+void TestSubmitAllThenFinish()
+{
+    std::cout << "  Test: Programs submitted up front all resolve on finish()" << std::endl;
+    ShaderPipeline& pipeline = ShaderPipeline::shared();
+    std::vector<ProgramHandle> handles;
+    for (int i = 1; i <= 8; ++i) {
+        handles.push_back(pipeline.submit(VERTEX_SOURCE, fragmentSource(i), "variant " + std::to_string(i)));
+    }
+    assert(pipeline.getPendingCount() <= handles.size());
+
+    pipeline.finish();
+    assert(pipeline.getPendingCount() == 0);
+    for (int i = 1; i <= 8; ++i) {
+        const ProgramHandle& handle = handles[static_cast<size_t>(i - 1)];
+        assert(handle.isReady());
+        assert(handle.getStatus() == ProgramStatus::Ready);
+        const int red = drawRed(handle.get());
+        assert(std::abs(red - i * 255 / 8) <= 1);
+        glDeleteProgram(handle.get());
+    }
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestPollResolvesWithoutWaiting()
+{
+    std::cout << "  Test: poll() picks up finished programs through GL_COMPLETION_STATUS_KHR" << std::endl;
+    ShaderPipeline& pipeline = ShaderPipeline::shared();
+    if (!pipeline.hasParallelCompile()) {
+        std::cout << "    Skipped (KHR_parallel_shader_compile unavailable)." << std::endl;
+        return;
+    }
+    std::vector<ProgramHandle> handles;
+    for (int i = 9; i <= 12; ++i) {
+        handles.push_back(pipeline.submit(VERTEX_SOURCE, fragmentSource(i), "polled " + std::to_string(i)));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (pipeline.poll() > 0) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (const ProgramHandle& handle : handles) {
+        assert(handle.getStatus() == ProgramStatus::Ready);
+        glDeleteProgram(handle.get());
+    }
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestFailuresAndDroppedHandles()
+{
+    std::cout << "  Test: A broken program resolves as failed; dropped handles are released" << std::endl;
+    ShaderPipeline& pipeline = ShaderPipeline::shared();
+    ProgramHandle broken = pipeline.submit(VERTEX_SOURCE, "#version 330 core\nvoid main() { oops }\n", "broken");
+    ProgramHandle copy = broken;
+    assert(copy.get() == 0);
+    assert(broken.getStatus() == ProgramStatus::Failed);
+    assert(broken.isReady());
+
+    pipeline.submit(VERTEX_SOURCE, fragmentSource(13), "dropped");
+    pipeline.finish();
+    assert(pipeline.getPendingCount() == 0);
+    assert(!ProgramHandle().isValid());
+    assert(ProgramHandle().get() == 0);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestCachedProgramsAreReadyOnSubmit()
+{
+    std::cout << "  Test: Cached programs are ready on submit; Shader loads in two halves" << std::endl;
+    ProgramCache& cache = ProgramCache::shared();
+    if (!cache.isEnabled()) {
+        std::cout << "    (Program cache unsupported; checked Shader only)" << std::endl;
+    } else {
+        ShaderPipeline& pipeline = ShaderPipeline::shared();
+        const std::string fragment = fragmentSource(4);
+        ProgramHandle first = pipeline.submit(VERTEX_SOURCE, fragment, "first");
+        glDeleteProgram(first.get());
+        ProgramHandle second = pipeline.submit(VERTEX_SOURCE, fragment, "second");
+        assert(second.getStatus() == ProgramStatus::Ready);
+        const int red = drawRed(second.get());
+        assert(red == 127 || red == 128);
+        glDeleteProgram(second.get());
+    }
+
+    Shader lighting;
+    bool queued = lighting.submitFromFiles("shaders/lighting.vert", "shaders/lighting.frag");
+    assert(queued);
+    assert(lighting.getProgram() == 0);
+    const bool finished = lighting.finishLoading();
+    assert(finished);
+    assert(lighting.getProgram() != 0);
+    assert(lighting.getUniforms().find("model") >= 0);
+    queued = lighting.submitFromFiles("shaders/missing.vert", "shaders/lighting.frag");
+    assert(!queued);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ShaderPipeline Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    std::filesystem::remove_all(cacheDirectory());
+    ProgramCache::shared().setDirectory(cacheDirectory().string());
+
+    TestSubmitAllThenFinish();
+    TestPollResolvesWithoutWaiting();
+    TestFailuresAndDroppedHandles();
+    TestCachedProgramsAreReadyOnSubmit();
+
+    std::filesystem::remove_all(cacheDirectory());
+    std::cout << "ShaderPipeline Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLTestContext.hpp"
+#include "ShadowAtlas.hpp"
+#include "Renderer.hpp"
+#include "Shader.hpp"
+#include "UniformBuffer.hpp"
+
+using namespace TurtleEngine;
+
+// Shadow atlas tiling, static caching and dynamic composition. Needs a GL context;
+// CI runs it on Mesa llvmpipe.
+
+namespace {
+    // Horizontal quad at height 'y', position and normal per vertex
+    struct Quad {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+
+        Quad(float y, float halfSize) {
+            const float h = halfSize;
+            const float vertices[] = {
+                -h, y, -h, 0.0f, 1.0f, 0.0f,   h, y, -h, 0.0f, 1.0f, 0.0f,   h, y, h, 0.0f, 1.0f, 0.0f,
+                -h, y, -h, 0.0f, 1.0f, 0.0f,   h, y, h, 0.0f, 1.0f, 0.0f,   -h, y, h, 0.0f, 1.0f, 0.0f,
+            };
+            glGenVertexArrays(1, &vao);
+            glGenBuffers(1, &vbo);
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        ~Quad() {
+            glDeleteVertexArrays(1, &vao);
+            glDeleteBuffers(1, &vbo);
+        }
+
+        ShadowCaster caster(float y, float halfSize, bool isStatic, const glm::mat4& model = glm::mat4(1.0f)) const {
+            ShadowCaster c;
+            c.vao = vao;
+            c.count = 6;
+            c.model = model;
+            c.boundsMin = glm::vec3(-halfSize, y, -halfSize);
+            c.boundsMax = glm::vec3(halfSize, y, halfSize);
+            c.isStatic = isStatic;
+            return c;
+        }
+    };
+
+    // Looking straight down from above 'position'
+    glm::mat4 downLight(const glm::vec3& position) {
+        return glm::ortho(-4.0f, 4.0f, -4.0f, 4.0f, 0.1f, 20.0f) *
+               glm::lookAt(position, position - glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+    }
+
+    std::vector<float> readTile(const ShadowAtlas& atlas, size_t light) {
+        const int size = atlas.getSize();
+        std::vector<float> depth(static_cast<size_t>(size) * size);
+        glBindTexture(GL_TEXTURE_2D, atlas.getTexture());
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        const glm::vec4 rect = atlas.getTileRect(light) * static_cast<float>(size);
+        const int x0 = static_cast<int>(rect.x), y0 = static_cast<int>(rect.y), tile = static_cast<int>(rect.z);
+        std::vector<float> result;
+        for (int y = y0; y < y0 + tile; ++y) {
+            for (int x = x0; x < x0 + tile; ++x) {
+                result.push_back(depth[static_cast<size_t>(y) * size + x]);
+            }
+        }
+        return result;
+    }
+
+    float centreDepth(const std::vector<float>& tile) {
+        int side = 1;
+        while (static_cast<size_t>(side) * side < tile.size()) ++side;
+        return tile[static_cast<size_t>(side / 2) * side + side / 2];
+    }
+}
+
+void TestTilesFollowImportance(GLuint depthProgram)
+{
+    std::cout << "  Test: Tiles are sized by importance and never overlap" << std::endl;
+    ShadowAtlas atlas;
+    const bool initialized = atlas.initialize(depthProgram, 1024);
+    assert(initialized);
+
+    std::vector<ShadowLightView> views(5);
+    const float importance[] = { 1.0f, 0.5f, 0.25f, 1.0f, 0.1f };
+    for (size_t i = 0; i < views.size(); ++i) views[i].importance = importance[i];
+    atlas.update(views.data(), views.size());
+    assert(atlas.getTileSize(0) == 512 && atlas.getTileSize(3) == 512);
+    assert(atlas.getTileSize(1) == 256);
+    assert(atlas.getTileSize(2) == 128 && atlas.getTileSize(4) == 128);
+
+    for (size_t a = 0; a < views.size(); ++a) {
+        const glm::vec4 ra = atlas.getTileRect(a);
+        assert(ra.x >= 0.0f && ra.y >= 0.0f && ra.x + ra.z <= 1.0f && ra.y + ra.w <= 1.0f);
+        for (size_t b = a + 1; b < views.size(); ++b) {
+            const glm::vec4 rb = atlas.getTileRect(b);
+            const bool apart = ra.x + ra.z <= rb.x || rb.x + rb.z <= ra.x || ra.y + ra.w <= rb.y || rb.y + rb.w <= ra.y;
+            assert(apart);
+        }
+    }
+
+    // Six equally important lights do not fit at full size, so all shrink a level
+    std::vector<ShadowLightView> crowd(6);
+    atlas.update(crowd.data(), crowd.size());
+    for (size_t i = 0; i < crowd.size(); ++i) {
+        assert(atlas.getTileSize(i) == 256);
+    }
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestStaticShadowsAreCached(GLuint depthProgram)
+{
+    std::cout << "  Test: Static shadows re-render only when something in view changes" << std::endl;
+    ShadowAtlas atlas;
+    const bool initialized = atlas.initialize(depthProgram, 512);
+    assert(initialized);
+    Quad quad(0.0f, 1.0f);
+    atlas.addCaster(quad.caster(0.0f, 1.0f, true));
+
+    // Light 0 above the caster, light 1 far off to the side
+    ShadowLightView views[2];
+    views[0].lightSpaceMatrix = downLight(glm::vec3(0.0f, 10.0f, 0.0f));
+    views[1].lightSpaceMatrix = downLight(glm::vec3(50.0f, 10.0f, 0.0f));
+    atlas.update(views, 2);
+    assert(atlas.getLastStats().staticTiles == 2);
+    assert(atlas.getLastStats().casterDraws == 1);
+    assert(centreDepth(readTile(atlas, 0)) < 1.0f);
+    assert(centreDepth(readTile(atlas, 1)) == 1.0f);
+
+    atlas.update(views, 2);
+    assert(atlas.getLastStats().reusedTiles == 2);
+    assert(atlas.getLastStats().casterDraws == 0);
+
+    // A caster appearing next to light 1 leaves light 0's tile alone
+    const ShadowCasterId side = atlas.addCaster(quad.caster(0.0f, 1.0f, true, glm::translate(glm::mat4(1.0f), glm::vec3(50.0f, 0.0f, 0.0f))));
+    atlas.update(views, 2);
+    assert(atlas.getLastStats().staticTiles == 1 && atlas.getLastStats().reusedTiles == 1);
+    assert(centreDepth(readTile(atlas, 1)) < 1.0f);
+
+    // Moving a light re-renders its tile only
+    views[0].lightSpaceMatrix = downLight(glm::vec3(0.5f, 10.0f, 0.0f));
+    atlas.update(views, 2);
+    assert(atlas.getLastStats().staticTiles == 1 && atlas.getLastStats().reusedTiles == 1);
+
+    atlas.removeCaster(side);
+    atlas.update(views, 2);
+    assert(atlas.getLastStats().staticTiles == 1);
+    assert(centreDepth(readTile(atlas, 1)) == 1.0f);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestDynamicCastersAreComposited(GLuint depthProgram)
+{
+    std::cout << "  Test: Moving dynamic casters reuse the cached static layer" << std::endl;
+    Quad floor(0.0f, 3.0f);
+    Quad box(2.0f, 0.5f);
+    ShadowLightView view;
+    view.lightSpaceMatrix = downLight(glm::vec3(0.0f, 10.0f, 0.0f));
+
+    ShadowAtlas atlas;
+    const bool initialized = atlas.initialize(depthProgram, 512);
+    assert(initialized);
+    atlas.addCaster(floor.caster(0.0f, 3.0f, true));
+    const ShadowCasterId mover = atlas.addCaster(box.caster(2.0f, 0.5f, false));
+    atlas.update(&view, 1);
+    assert(atlas.getLastStats().staticTiles == 1 && atlas.getLastStats().casterDraws == 2);
+
+    const glm::mat4 moved = glm::translate(glm::mat4(1.0f), glm::vec3(1.5f, 0.0f, -1.0f));
+    atlas.setCasterTransform(mover, moved);
+    atlas.update(&view, 1);
+    assert(atlas.getLastStats().composedTiles == 1 && atlas.getLastStats().staticTiles == 0);
+    assert(atlas.getLastStats().casterDraws == 1); // Only the dynamic caster is redrawn
+
+    // Same frame rendered from scratch
+    ShadowAtlas fresh;
+    const bool freshInitialized = fresh.initialize(depthProgram, 512);
+    assert(freshInitialized);
+    fresh.addCaster(floor.caster(0.0f, 3.0f, true));
+    fresh.addCaster(box.caster(2.0f, 0.5f, false, moved));
+    fresh.update(&view, 1);
+    assert(readTile(atlas, 0) == readTile(fresh, 0));
+
+    // Movement outside the light's frustum costs nothing
+    const glm::mat4 away = glm::translate(glm::mat4(1.0f), glm::vec3(40.0f, 0.0f, 0.0f));
+    atlas.setCasterTransform(mover, away);
+    atlas.update(&view, 1);
+    assert(atlas.getLastStats().composedTiles == 1); // Leaving the frustum still clears its shadow
+    atlas.setCasterTransform(mover, away * glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f)));
+    atlas.update(&view, 1);
+    assert(atlas.getLastStats().reusedTiles == 1 && atlas.getLastStats().casterDraws == 0);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestLightingSamplesTheAtlas(Renderer& renderer)
+{
+    std::cout << "  Test: The lighting shader darkens what a caster hides from its light" << std::endl;
+    const int size = 64;
+    Quad floor(0.0f, 4.0f);
+    Quad blocker(2.0f, 1.0f);
+    renderer.addLight(Light(glm::vec3(1.0f, 6.0f, 2.0f), glm::vec3(1.0f), 1.0f, 20.0f));
+    renderer.addLight(Light(glm::vec3(-30.0f, 6.0f, 0.0f), glm::vec3(1.0f), 1.0f, 20.0f));
+    const ShadowCasterId caster = renderer.addShadowCaster(blocker.caster(2.0f, 1.0f, true));
+
+    FrameUniforms& frame = FrameUniforms::shared();
+    renderer.renderShadowMaps();
+    const size_t uploads = frame.getLightUploads();
+    assert(renderer.getShadowAtlas().getLastStats().staticTiles == 2);
+    assert(renderer.getLights()[0].shadowMap.atlasRect.z > 0.0f);
+    assert(renderer.getLights()[0].shadowMap.atlasRect != renderer.getLights()[1].shadowMap.atlasRect);
+
+    // Nothing changed: no shadow work and no light upload
+    renderer.renderShadowMaps();
+    assert(renderer.getShadowAtlas().getLastStats().reusedTiles == 2);
+    assert(frame.getLightUploads() == uploads);
+
+    LightsBlock stored;
+    GLint buffer = 0;
+    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, LIGHTS_BLOCK_BINDING, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, static_cast<GLuint>(buffer));
+    glGetBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(stored), &stored);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    assert(stored.lights[0].shadowRect == renderer.getLights()[0].shadowMap.atlasRect);
+
+    // Floor seen from above; the blocker only casts
+    GLuint color = 0, depth = 0, fbo = 0;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size, size);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    glViewport(0, 0, size, size);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    Shader lighting;
+    const bool loaded = lighting.loadFromFiles("shaders/lighting.vert", "shaders/lighting.frag");
+    assert(loaded);
+    lighting.use();
+    lighting.setMat4("model", glm::mat4(1.0f));
+    lighting.getUniform<glm::vec4>("color").set(glm::vec4(1.0f));
+    frame.setCamera(glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f)),
+                    glm::ortho(-4.0f, 4.0f, -4.0f, 4.0f, 0.1f, 20.0f));
+    glActiveTexture(GL_TEXTURE0 + SHADOW_ATLAS_UNIT);
+    glBindTexture(GL_TEXTURE_2D, renderer.getShadowAtlas().getTexture());
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(floor.vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    // Screen x is world x, screen up is world -z. Light 0 projects the blocker's
+    // centre to (-0.5, 0, -1); (3, 0, 3) is in the open.
+    auto brightness = [&](float x, float z) {
+        uint8_t pixel[4];
+        glReadPixels(static_cast<int>((x + 4.0f) / 8.0f * size), static_cast<int>((4.0f - z) / 8.0f * size), 1, 1,
+                     GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        return static_cast<int>(pixel[0]);
+    };
+    const int shadowed = brightness(-0.5f, -1.0f);
+    const int open = brightness(3.0f, 3.0f);
+    assert(shadowed < open);
+    assert(shadowed <= 77 + 2); // Ambient only (0.3)
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    glDeleteRenderbuffers(1, &depth);
+    renderer.removeShadowCaster(caster);
+    renderer.clearLights();
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running ShadowAtlas Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    {
+        // The renderer's depth-only program drives the standalone atlases too
+        Renderer renderer;
+        renderer.init();
+        TestTilesFollowImportance(renderer.getShadowShader());
+        TestStaticShadowsAreCached(renderer.getShadowShader());
+        TestDynamicCastersAreComposited(renderer.getShadowShader());
+        TestLightingSamplesTheAtlas(renderer);
+    }
+
+    std::cout << "ShadowAtlas Tests Completed Successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLTestContext.hpp"
+#include "UniformBuffer.hpp"
+#include "Shader.hpp"
+#include "Renderer.hpp"
+
+using namespace TurtleEngine;
+
+// std140 camera and light blocks shared by the world shaders. Needs a GL context;
+// CI runs it on Mesa llvmpipe.
+
+namespace {
+    GLint memberOffset(GLuint program, const char* name) {
+        GLuint index = GL_INVALID_INDEX;
+        glGetUniformIndices(program, 1, &name, &index);
+        assert(index != GL_INVALID_INDEX);
+        GLint offset = -1;
+        glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_OFFSET, &offset);
+        return offset;
+    }
+
+    GLint blockValue(GLuint program, const char* block, GLenum property) {
+        GLuint index = glGetUniformBlockIndex(program, block);
+        assert(index != GL_INVALID_INDEX);
+        GLint value = -1;
+        glGetActiveUniformBlockiv(program, index, property, &value);
+        return value;
+    }
+}
+
+void TestBlockLayoutsMatch()
+{
+    std::cout << "  Test: C++ block structs match the driver's std140 layout" << std::endl;
+    Shader lighting;
+    const bool loaded = lighting.loadFromFiles("shaders/lighting.vert", "shaders/lighting.frag");
+    assert(loaded);
+    const GLuint program = lighting.getProgram();
+
+    assert(blockValue(program, "Camera", GL_UNIFORM_BLOCK_DATA_SIZE) == static_cast<GLint>(sizeof(CameraBlock)));
+    assert(memberOffset(program, "Camera.view") == static_cast<GLint>(offsetof(CameraBlock, view)));
+    assert(memberOffset(program, "Camera.projection") == static_cast<GLint>(offsetof(CameraBlock, projection)));
+    assert(memberOffset(program, "Camera.viewProjection") == static_cast<GLint>(offsetof(CameraBlock, viewProjection)));
+    assert(memberOffset(program, "Camera.position") == static_cast<GLint>(offsetof(CameraBlock, position)));
+
+    assert(blockValue(program, "Lights", GL_UNIFORM_BLOCK_DATA_SIZE) == static_cast<GLint>(sizeof(LightsBlock)));
+    assert(memberOffset(program, "lights[0].colorIntensity") == static_cast<GLint>(offsetof(LightData, colorIntensity)));
+    assert(memberOffset(program, "lights[1].positionRadius") == static_cast<GLint>(sizeof(LightData)));
+    assert(memberOffset(program, "lights[3].lightSpaceMatrix") ==
+           static_cast<GLint>(3 * sizeof(LightData) + offsetof(LightData, lightSpaceMatrix)));
+    assert(memberOffset(program, "lightCount") == static_cast<GLint>(offsetof(LightsBlock, lightCount)));
+    assert(memberOffset(program, "clusterGrid") == static_cast<GLint>(offsetof(LightsBlock, clusterGrid)));
+    assert(memberOffset(program, "clusterDepth") == static_cast<GLint>(offsetof(LightsBlock, clusterDepth)));
+
+    // Shader::loadFromFiles wires both blocks to the fixed binding points
+    assert(blockValue(program, "Camera", GL_UNIFORM_BLOCK_BINDING) == CAMERA_BLOCK_BINDING);
+    assert(blockValue(program, "Lights", GL_UNIFORM_BLOCK_BINDING) == LIGHTS_BLOCK_BINDING);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestCameraIsUploadedOncePerChange()
+{
+    std::cout << "  Test: One camera upload serves every world shader" << std::endl;
+    FrameUniforms& frame = FrameUniforms::shared();
+    const glm::mat4 view = glm::lookAt(glm::vec3(2.0f, 3.0f, 4.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 50.0f);
+
+    const size_t before = frame.getCameraUploads();
+    frame.setCamera(view, projection);
+    frame.setCamera(view, projection); // Second system, same camera: no upload
+    assert(frame.getCameraUploads() == before + 1);
+    frame.setCamera(view, glm::mat4(1.0f));
+    assert(frame.getCameraUploads() == before + 2);
+    frame.setCamera(view, projection);
+
+    const glm::vec4 position = frame.getCamera().position;
+    assert(glm::length(glm::vec3(position) - glm::vec3(2.0f, 3.0f, 4.0f)) < 1e-4f);
+
+    // The bound buffer holds what the shaders will read
+    GLint buffer = 0;
+    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, CAMERA_BLOCK_BINDING, &buffer);
+    assert(buffer != 0);
+    CameraBlock stored;
+    glBindBuffer(GL_UNIFORM_BUFFER, static_cast<GLuint>(buffer));
+    glGetBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(stored), &stored);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    assert(std::memcmp(&stored.viewProjection, &frame.getCamera().viewProjection, sizeof(glm::mat4)) == 0);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestRendererWritesLightsToTheBlock()
+{
+    std::cout << "  Test: Renderer lights are uploaded once per change" << std::endl;
+    Renderer renderer;
+    renderer.init();
+    FrameUniforms& frame = FrameUniforms::shared();
+
+    const size_t before = frame.getLightUploads();
+    renderer.addLight(Light(glm::vec3(1.0f, 2.0f, 3.0f), glm::vec3(1.0f, 0.5f, 0.25f), 2.0f, 12.0f));
+    renderer.addLight(Light(glm::vec3(-4.0f, 5.0f, 6.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    assert(frame.getLightUploads() == before + 2);
+
+    // Switching programs re-binds shadow maps but sends no light data
+    renderer.useShader(renderer.getShadowShader());
+    renderer.useShader(renderer.getDefaultShader());
+    assert(frame.getLightUploads() == before + 2);
+
+    GLint buffer = 0;
+    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, LIGHTS_BLOCK_BINDING, &buffer);
+    assert(buffer != 0);
+    LightsBlock stored;
+    glBindBuffer(GL_UNIFORM_BUFFER, static_cast<GLuint>(buffer));
+    glGetBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(stored), &stored);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    assert(stored.lightCount == 2);
+    assert(stored.lights[0].positionRadius == glm::vec4(1.0f, 2.0f, 3.0f, 12.0f));
+    assert(stored.lights[0].colorIntensity == glm::vec4(1.0f, 0.5f, 0.25f, 2.0f));
+    assert(stored.lights[1].positionRadius == glm::vec4(-4.0f, 5.0f, 6.0f, 10.0f));
+
+    renderer.clearLights();
+    glBindBuffer(GL_UNIFORM_BUFFER, static_cast<GLuint>(buffer));
+    glGetBufferSubData(GL_UNIFORM_BUFFER, offsetof(LightsBlock, lightCount), sizeof(int32_t), &stored.lightCount);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    assert(stored.lightCount == 0);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running UniformBuffer Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestBlockLayoutsMatch();
+    TestCameraIsUploadedOncePerChange();
+    TestRendererWritesLightsToTheBlock();
+
+    std::cout << "UniformBuffer Tests Completed Successfully!" << std::endl;
+    return 0;
+}
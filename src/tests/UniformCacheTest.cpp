@@ -0,0 +1,162 @@
+#include <cassert>
+#include <iostream>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "GLTestContext.hpp"
+#include "UniformCache.hpp"
+#include "Shader.hpp"
+
+using namespace TurtleEngine;
+
+// Link-time uniform reflection and typed handles. Needs a GL context; CI runs it on
+// Mesa llvmpipe.
+
+namespace {
+    const char* VERTEX_SOURCE = R"(
+        #version 400 core
+        layout (location = 0) in vec3 aPos;
+        uniform mat4 model;
+        uniform float weights[4];
+        void main() {
+            gl_Position = model * vec4(aPos * (weights[0] + weights[3]), 1.0);
+        }
+    )";
+
+    const char* FRAGMENT_SOURCE = R"(
+        #version 400 core
+        struct Light { vec3 color; float intensity; };
+        uniform Light lights[2];
+        uniform int numLights;
+        out vec4 FragColor;
+        void main() {
+            vec3 sum = vec3(0.0);
+            for (int i = 0; i < numLights; ++i) sum += lights[i].color * lights[i].intensity;
+            FragColor = vec4(sum, 1.0);
+        }
+    )";
+
+    GLuint compile(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint ok = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        assert(ok);
+        return shader;
+    }
+
+    GLuint linkTestProgram() {
+        GLuint vertex = compile(GL_VERTEX_SHADER, VERTEX_SOURCE);
+        GLuint fragment = compile(GL_FRAGMENT_SHADER, FRAGMENT_SOURCE);
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        GLint ok = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        assert(ok);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return program;
+    }
+}
+
+void TestReflectionMatchesDriver()
+{
+    std::cout << "  Test: Reflected locations match glGetUniformLocation" << std::endl;
+    GLuint program = linkTestProgram();
+    UniformCache cache;
+    cache.reflect(program);
+
+    const char* names[] = {
+        "model", "numLights", "weights", "weights[0]", "weights[3]",
+        "lights[0].color", "lights[1].intensity",
+    };
+    for (const char* name : names) {
+        GLint expected = glGetUniformLocation(program, name);
+        assert(expected >= 0);
+        assert(cache.find(name) == expected);
+    }
+    assert(cache.find("missing") == -1);
+    GLint location = 0;
+    assert(!cache.lookup("missing", location) && location == -1);
+
+    glDeleteProgram(program);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestHandlesSetValues()
+{
+    std::cout << "  Test: Typed handles set values without lookups" << std::endl;
+    GLuint program = linkTestProgram();
+    UniformCache cache;
+    cache.reflect(program);
+    glUseProgram(program);
+
+    UniformHandle<int> numLights = cache.handle<int>("numLights");
+    UniformHandle<float> lastWeight = cache.handle<float>("weights[3]");
+    UniformHandle<glm::vec3> secondColor = cache.handle<glm::vec3>("lights[1].color");
+    UniformHandle<float> missing = cache.handle<float>("notInTheShader");
+    assert(numLights.isValid() && lastWeight.isValid() && secondColor.isValid());
+    assert(!missing.isValid());
+
+    numLights.set(2);
+    lastWeight.set(0.25f);
+    secondColor.set(glm::vec3(0.5f, 0.25f, 1.0f));
+    missing.set(1.0f); // No-op, like glUniform with location -1
+
+    GLint count = 0;
+    glGetUniformiv(program, numLights.location, &count);
+    assert(count == 2);
+    GLfloat weight = 0.0f;
+    glGetUniformfv(program, lastWeight.location, &weight);
+    assert(weight == 0.25f);
+    GLfloat color[3] = {};
+    glGetUniformfv(program, secondColor.location, color);
+    assert(color[0] == 0.5f && color[1] == 0.25f && color[2] == 1.0f);
+
+    glUseProgram(0);
+    glDeleteProgram(program);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+void TestShaderUsesTheCache()
+{
+    std::cout << "  Test: Shader reflects on load and serves handles" << std::endl;
+    Shader shader;
+    const bool loaded = shader.loadFromFiles("shaders/grid_textured.vert", "shaders/grid_overlay.frag");
+    assert(loaded);
+    assert(shader.getUniforms().size() >= 5); // view/projection come from the Camera block
+
+    UniformHandle<float> valueMin = shader.getUniform<float>("valueMin");
+    assert(valueMin.isValid() && valueMin.location == glGetUniformLocation(shader.getProgram(), "valueMin"));
+
+    shader.use();
+    valueMin.set(3.0f);
+    shader.setFloat("valueScale", 0.5f); // Name setters go through the same cache
+    GLfloat value = 0.0f;
+    glGetUniformfv(shader.getProgram(), valueMin.location, &value);
+    assert(value == 3.0f);
+    glGetUniformfv(shader.getProgram(), shader.getUniform<float>("valueScale").location, &value);
+    assert(value == 0.5f);
+    glUseProgram(0);
+    assert(glGetError() == GL_NO_ERROR);
+    std::cout << "    Passed." << std::endl;
+}
+
+int main()
+{
+    std::cout << "Running UniformCache Tests..." << std::endl;
+
+    GLTestContext context;
+    if (!context.isValid()) return 1;
+
+    TestReflectionMatchesDriver();
+    TestHandlesSetValues();
+    TestShaderUsesTheCache();
+
+    std::cout << "UniformCache Tests Completed Successfully!" << std::endl;
+    return 0;
+}
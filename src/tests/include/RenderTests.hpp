@@ -2,15 +2,18 @@
 #define TURTLE_ENGINE_RENDER_TESTS_HPP
 
 #include <GL/glew.h>
-#include <GLFW/glfw3.h>
 #include <gtest/gtest.h>
+#include "../GLTestContext.hpp"
+#include "RenderTarget.hpp"
+#include "Renderer.hpp"
 
 namespace TurtleEngine {
-class Renderer;
 
+// Each test gets its own headless context and draws into an offscreen target
 class RenderTest : public ::testing::Test {
 protected:
-    GLFWwindow* window;
+    GLTestContext context;
+    RenderTarget target;
     Renderer renderer;
 
     void SetUp() override;
@@ -2,37 +2,18 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <GL/glew.h>
-#include <GLFW/glfw3.h>
+#include "../GLTestContext.hpp"
 #include "../engine/Renderer.hpp"
 #include "../engine/Shader.h"
 
 class LightingTest : public ::testing::Test {
 protected:
-    GLFWwindow* window;
+    TurtleEngine::GLTestContext context; // Headless, so no window or display server
     std::unique_ptr<Renderer> renderer;
 
     void SetUp() override {
-        // Initialize GLFW and GLEW for testing
-        if (!glfwInit()) {
-            FAIL() << "Failed to initialize GLFW";
-            return;
-        }
-        
-        // Create a hidden window for OpenGL context
-        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
-        window = glfwCreateWindow(800, 600, "Test Window", nullptr, nullptr);
-        if (!window) {
-            FAIL() << "Failed to create GLFW window";
-            glfwTerminate();
-            return;
-        }
-        
-        glfwMakeContextCurrent(window);
-        
-        // Initialize GLEW
-        glewExperimental = GL_TRUE;
-        if (glewInit() != GLEW_OK) {
-            FAIL() << "Failed to initialize GLEW";
+        if (!context.isValid()) {
+            FAIL() << "Failed to create a headless GL context";
             return;
         }
         
@@ -41,10 +22,10 @@ protected:
     }
     
     void TearDown() override {
-        renderer->cleanup();
-        renderer.reset();
-        glfwDestroyWindow(window);
-        glfwTerminate();
+        if (renderer) {
+            renderer->cleanup();
+            renderer.reset();
+        }
     }
 };
 
@@ -1,92 +1,40 @@
 #include <iostream>
 #include <cassert>
 #include <GL/glew.h>
-#include <GLFW/glfw3.h>
 #include <gtest/gtest.h>
 #include "Renderer.hpp"
+#include "ShaderPipeline.hpp"
 #include <fstream>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <string>
-#include <windows.h>
 #include <cmath>
 #include "RenderTests.hpp"
 
 using namespace TurtleEngine;
 
 void RenderTest::SetUp() {
-    // Initialize GLFW
-    if (!glfwInit()) {
-        FAIL() << "Failed to initialize GLFW";
-        return;
-    }
-    
-    // Set OpenGL context hints
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-    
-    // Create a hidden window for OpenGL context
-    window = glfwCreateWindow(800, 600, "Test Window", nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        FAIL() << "Failed to create GLFW window";
-        return;
-    }
-    
-    glfwMakeContextCurrent(window);
-    
-    // Initialize GLEW
-    glewExperimental = GL_TRUE;
-    GLenum err = glewInit();
-    if (err != GLEW_OK) {
-        std::cerr << "GLEW Error: " << glewGetErrorString(err) << std::endl;
-        glfwDestroyWindow(window);
-        glfwTerminate();
-        FAIL() << "Failed to initialize GLEW: " << glewGetErrorString(err);
+    if (!context.isValid()) {
+        FAIL() << "Failed to create a headless GL context";
         return;
     }
     
     // Print OpenGL version for verification
-    const GLubyte* version = glGetString(GL_VERSION);
-    if (version) {
-        std::cout << "OpenGL Version: " << version << std::endl;
-    } else {
-        std::cerr << "Failed to get OpenGL version" << std::endl;
-        glfwDestroyWindow(window);
-        glfwTerminate();
-        FAIL() << "Failed to get OpenGL version";
-        return;
-    }
-    
-    // Clear any OpenGL error that might have been generated during initialization
-    while (glGetError() != GL_NO_ERROR) {}
+    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
     
-    // Initialize renderer
-    try {
-        renderer.init();
-    } catch (const std::exception& e) {
-        std::cerr << "Renderer initialization failed: " << e.what() << std::endl;
-        glfwDestroyWindow(window);
-        glfwTerminate();
-        FAIL() << "Renderer initialization failed: " << e.what();
-        return;
-    }
+    const bool created = target.initialize(800, 600);
+    ASSERT_TRUE(created);
+    renderer.init();
+    renderer.setRenderTarget(&target);
 }
 
 void RenderTest::TearDown() {
-    if (window) {
-        glfwDestroyWindow(window);
-        window = nullptr;
-    }
-    glfwTerminate();
+    renderer.cleanup();
+    target.cleanup();
 }
 
 TEST_F(RenderTest, ShaderCompilation) {
-    // Test shader compilation
+    // Programs are built through the ShaderPipeline; get() waits for the link
     std::string vertexShader = R"(
         #version 330 core
         layout (location = 0) in vec3 aPos;
@@ -103,14 +51,14 @@ TEST_F(RenderTest, ShaderCompilation) {
         }
     )";
     
-    GLuint vertex = renderer.createShader(vertexShader, GL_VERTEX_SHADER);
-    GLuint fragment = renderer.createShader(fragmentShader, GL_FRAGMENT_SHADER);
+    ProgramHandle handle = ShaderPipeline::shared().submit(vertexShader, fragmentShader, "render test");
+    ASSERT_TRUE(handle.isValid());
+    GLuint program = handle.get();
     
-    EXPECT_NE(vertex, 0);
-    EXPECT_NE(fragment, 0);
+    EXPECT_NE(program, 0u);
+    EXPECT_EQ(handle.getStatus(), ProgramStatus::Ready);
     
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    glDeleteProgram(program);
 }
 
 TEST_F(RenderTest, UniformSetting) {
@@ -1,41 +1,16 @@
 TEST_CASE("UniformSettings", "[renderer]") {
-    // Initialize GLFW
-    if (!glfwInit()) {
-        FAIL("Failed to initialize GLFW");
-    }
-
-    // Configure GLFW
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE); // Make window invisible
-
-    // Create window
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Test Window", nullptr, nullptr);
-    if (!window) {
-        glfwTerminate();
-        FAIL("Failed to create GLFW window");
-    }
-
-    // Make OpenGL context current
-    glfwMakeContextCurrent(window);
-
-    // Initialize GLEW
-    if (glewInit() != GLEW_OK) {
-        glfwDestroyWindow(window);
-        glfwTerminate();
-        FAIL("Failed to initialize GLEW");
+    // Headless context and an offscreen target; no window or display server
+    GLTestContext context;
+    if (!context.isValid()) {
+        FAIL("Failed to create a headless GL context");
     }
+    RenderTarget target;
+    REQUIRE(target.initialize(800, 600));
 
     Renderer renderer;
     renderer.init();
-
-    // Set up viewport and clear color
-    glViewport(0, 0, 800, 600);
+    renderer.setRenderTarget(&target);
     renderer.setClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    
-    // Make sure we're rendering to the default framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
     renderer.clear();
 
     // Load shader and set it as default
@@ -81,10 +56,9 @@ TEST_CASE("UniformSettings", "[renderer]") {
     std::cout << "Expected color: " << testColor.r << ", " << testColor.g << ", " << testColor.b << ", " << testColor.a << std::endl;
 
     // Read back pixel color from the center of the triangle
-    unsigned char pixel[4];
-    glReadBuffer(GL_BACK);
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glReadPixels(400, 300, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    std::vector<uint8_t> pixels;
+    target.readPixels(pixels);
+    const uint8_t* pixel = &pixels[(300 * 800 + 400) * 4];
 
     // Debug: Print pixel values
     std::cout << "Pixel values: " << (int)pixel[0] << ", " << (int)pixel[1] << ", " << (int)pixel[2] << ", " << (int)pixel[3] << std::endl;
@@ -103,6 +77,5 @@ TEST_CASE("UniformSettings", "[renderer]") {
     REQUIRE(a == Approx(testColor.a).epsilon(tolerance));
 
     // Clean up
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    renderer.cleanup();
 } 
\ No newline at end of file